@@ -53,6 +53,8 @@ typedef struct
 {
     QuickFill *qf;
     gboolean load_list_store;
+    /* GNC_PREF_SHOW_LEAF_ACCT_NAMES, read once per full load. */
+    gboolean show_leaf_accounts;
     GtkListStore *list_store;
     QofBook *book;
     Account *root;
@@ -117,7 +119,7 @@ static void
 load_shared_qf_cb (Account *account, gpointer data)
 {
     QFB *qfb = data;
-    char *name;
+    const char *name;
     GtkTreeIter iter;
 
     if (qfb->dont_add_cb)
@@ -127,7 +129,9 @@ load_shared_qf_cb (Account *account, gpointer data)
             return;
     }
 
-    name = gnc_get_account_name_for_register (account);
+    /* The quickfill and the list store keep their own copies. */
+    name = qfb->show_leaf_accounts ? xaccAccountGetName (account) :
+           gnc_account_peek_full_name (account);
     if (NULL == name)
         return;
     gnc_quickfill_insert (qfb->qf, name, QUICKFILL_ALPHA);
@@ -139,7 +143,6 @@ load_shared_qf_cb (Account *account, gpointer data)
                             ACCOUNT_POINTER, account,
                             -1);
     }
-    g_free (name);
 }
 
 
@@ -152,6 +155,8 @@ shared_quickfill_pref_changed (gpointer prefs, gchar *pref, gpointer user_data)
     gnc_quickfill_purge (qfb->qf);
     gtk_list_store_clear (qfb->list_store);
     qfb->load_list_store = TRUE;
+    qfb->show_leaf_accounts = gnc_prefs_get_bool (GNC_PREFS_GROUP_GENERAL_REGISTER,
+                                                  GNC_PREF_SHOW_LEAF_ACCT_NAMES);
     gnc_account_foreach_descendant (qfb->root, load_shared_qf_cb, qfb);
     qfb->load_list_store = FALSE;
 }
@@ -187,6 +192,8 @@ build_shared_quickfill (QofBook *book, Account *root, const char * key,
                            shared_quickfill_pref_changed,
                            qfb);
 
+    qfb->show_leaf_accounts = gnc_prefs_get_bool (GNC_PREFS_GROUP_GENERAL_REGISTER,
+                                                  GNC_PREF_SHOW_LEAF_ACCT_NAMES);
     gnc_account_foreach_descendant (root, load_shared_qf_cb, qfb);
     qfb->load_list_store = FALSE;
 
@@ -492,6 +492,17 @@ show_session_error (GtkWindow *parent,
         uh_oh = FALSE;
         break;
 
+    case ERR_FILEIO_JOURNAL_CORRUPT:
+        fmt = _("Some of the changes saved to %s since it was last written "
+                "in full could not be read back. The book has been opened "
+                "with the changes up to the damaged one. The others will be "
+                "lost when the book is saved; check the most recent entries "
+                "before saving, or exit without saving to keep the damaged "
+                "changes on disk.");
+        gnc_warning_dialog (parent, fmt, displayname);
+        uh_oh = FALSE;
+        break;
+
     default:
         PERR("FIXME: Unhandled error %d", io_error);
         fmt = _("An unknown I/O error (%d) occurred.");
@@ -1325,6 +1336,8 @@ gnc_file_save (GtkWindow *parent)
     save_in_progress++;
     gnc_set_busy_cursor (NULL, TRUE);
     gnc_window_show_progress(_("Writing file..."), 0.0);
+    /* If the save goes wrong the log must have everything up to now. */
+    xaccLogSync ();
     qof_session_save (session, gnc_window_show_progress);
     gnc_window_show_progress(NULL, -1.0);
     gnc_unset_busy_cursor (NULL);
@@ -1347,7 +1360,10 @@ gnc_file_save (GtkWindow *parent)
 
     xaccReopenLog();
     gnc_add_history (session);
-    gnc_hook_run(HOOK_BOOK_SAVED, session);
+    /* A save still compressing in the background runs the hook itself
+     * once the file is in place. */
+    if (!qof_book_session_not_saved (qof_session_get_book (session)))
+        gnc_hook_run(HOOK_BOOK_SAVED, session);
     LEAVE (" ");
 }
 
@@ -1558,6 +1574,7 @@ gnc_file_do_save_as (GtkWindow *parent, const char* filename)
 
     gnc_set_busy_cursor (NULL, TRUE);
     gnc_window_show_progress(_("Writing file..."), 0.0);
+    xaccLogSync ();
     qof_session_save (new_session, gnc_window_show_progress);
     gnc_window_show_progress(NULL, -1.0);
     gnc_unset_busy_cursor (NULL);
@@ -1586,7 +1603,10 @@ gnc_file_do_save_as (GtkWindow *parent, const char* filename)
 
         xaccReopenLog();
         gnc_add_history (new_session);
-        gnc_hook_run(HOOK_BOOK_SAVED, new_session);
+        /* A save still compressing in the background runs the hook itself
+         * once the file is in place. */
+        if (!qof_book_session_not_saved (qof_session_get_book (new_session)))
+            gnc_hook_run(HOOK_BOOK_SAVED, new_session);
     }
     /* --------------- END CORE SESSION CODE -------------- */
 
@@ -1772,6 +1772,18 @@ gnc_plugin_page_account_tree_cmd_lots (GtkAction *action,
     gnc_lot_viewer_dialog (GTK_WINDOW(window), account);
 }
 
+/* Escape stops a check & repair of several accounts. */
+static gboolean
+scrub_kp_handler (GtkWidget *widget, GdkEventKey *event, gpointer data)
+{
+    if (event->keyval == GDK_KEY_Escape)
+    {
+        gnc_set_abort_scrub (TRUE);
+        return TRUE;
+    }
+    return FALSE;
+}
+
 static void
 gnc_plugin_page_account_tree_cmd_scrub (GtkAction *action, GncPluginPageAccountTree *page)
 {
@@ -1803,6 +1815,7 @@ gnc_plugin_page_account_tree_cmd_scrub_sub (GtkAction *action, GncPluginPageAcco
 {
     Account *account = gnc_plugin_page_account_tree_get_current_account (page);
     GncWindow *window;
+    gulong scrub_kp_handler_ID;
 
     g_return_if_fail (account != NULL);
 
@@ -1811,15 +1824,17 @@ gnc_plugin_page_account_tree_cmd_scrub_sub (GtkAction *action, GncPluginPageAcco
     window = GNC_WINDOW(GNC_PLUGIN_PAGE (page)->window);
     gnc_window_set_progressbar_window (window);
 
-    xaccAccountTreeScrubOrphans (account, gnc_window_show_progress);
-    xaccAccountTreeScrubImbalance (account, gnc_window_show_progress);
+    scrub_kp_handler_ID = g_signal_connect (G_OBJECT(window), "key-press-event",
+                                            G_CALLBACK(scrub_kp_handler), NULL);
 
     // XXX: Lots/capital gains scrubbing is disabled
-    if (g_getenv("GNC_AUTO_SCRUB_LOTS") != NULL)
-        xaccAccountTreeScrubLots(account);
+    xaccAccountTreeScrub (account, g_getenv("GNC_AUTO_SCRUB_LOTS") != NULL,
+                          gnc_window_show_progress);
 
-    gncScrubBusinessAccountTree(account, gnc_window_show_progress);
+    if (!gnc_get_abort_scrub ())
+        gncScrubBusinessAccountTree(account, gnc_window_show_progress);
 
+    g_signal_handler_disconnect (G_OBJECT(window), scrub_kp_handler_ID);
     gnc_resume_gui_refresh ();
 }
 
@@ -1828,20 +1843,24 @@ gnc_plugin_page_account_tree_cmd_scrub_all (GtkAction *action, GncPluginPageAcco
 {
     Account *root = gnc_get_current_root_account ();
     GncWindow *window;
+    gulong scrub_kp_handler_ID;
 
     gnc_suspend_gui_refresh ();
 
     window = GNC_WINDOW(GNC_PLUGIN_PAGE (page)->window);
     gnc_window_set_progressbar_window (window);
 
-    xaccAccountTreeScrubOrphans (root, gnc_window_show_progress);
-    xaccAccountTreeScrubImbalance (root, gnc_window_show_progress);
+    scrub_kp_handler_ID = g_signal_connect (G_OBJECT(window), "key-press-event",
+                                            G_CALLBACK(scrub_kp_handler), NULL);
+
     // XXX: Lots/capital gains scrubbing is disabled
-    if (g_getenv("GNC_AUTO_SCRUB_LOTS") != NULL)
-        xaccAccountTreeScrubLots(root);
+    xaccAccountTreeScrub (root, g_getenv("GNC_AUTO_SCRUB_LOTS") != NULL,
+                          gnc_window_show_progress);
 
-    gncScrubBusinessAccountTree(root, gnc_window_show_progress);
+    if (!gnc_get_abort_scrub ())
+        gncScrubBusinessAccountTree(root, gnc_window_show_progress);
 
+    g_signal_handler_disconnect (G_OBJECT(window), scrub_kp_handler_ID);
     gnc_resume_gui_refresh ();
 }
 
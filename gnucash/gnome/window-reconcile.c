@@ -1433,12 +1433,9 @@ gnc_recn_scrub_cb(GtkAction *action, gpointer data)
 
     gnc_suspend_gui_refresh ();
 
-    xaccAccountTreeScrubOrphans (account, gnc_window_show_progress);
-    xaccAccountTreeScrubImbalance (account, gnc_window_show_progress);
-
     // XXX: Lots are disabled.
-    if (g_getenv("GNC_AUTO_SCRUB_LOTS") != NULL)
-        xaccAccountTreeScrubLots(account);
+    xaccAccountTreeScrub (account, g_getenv("GNC_AUTO_SCRUB_LOTS") != NULL,
+                          gnc_window_show_progress);
 
     gnc_resume_gui_refresh ();
 }
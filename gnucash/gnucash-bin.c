@@ -60,6 +60,10 @@
 #include <Windows.h>
 #include <fcntl.h>
 #endif
+#ifndef G_OS_WIN32
+#include <signal.h>
+#include <unistd.h>
+#endif
 
 /* This static indicates the debugging module that this .o belongs to.  */
 static QofLogModule log_module = GNC_MOD_GUI;
@@ -94,9 +98,14 @@ static wchar_t     *log_to_filename  = NULL;
 #else
 static char        *log_to_filename  = NULL;
 #endif
+static gchar       *trace_filename   = NULL;
 static int          nofile           = 0;
 static const gchar *gsettings_prefix = NULL;
 static const char  *add_quotes_file  = NULL;
+static gchar       *run_reports_file = NULL;
+static gint         report_jobs      = 1;
+static gboolean     report_worker    = FALSE;
+static const gchar *program_path     = NULL;
 static char        *namespace_regexp = NULL;
 static const char  *file_to_load     = NULL;
 static gchar      **args_remaining   = NULL;
@@ -131,6 +140,12 @@ static GOptionEntry options[] =
         NULL
     },
 
+    {
+        "trace", '\0', 0, G_OPTION_ARG_FILENAME, &trace_filename,
+        N_("Record timing spans of engine, backend and report operations and write them to the given file as Chrome trace-event JSON on exit. Setting GNC_TRACE in the environment does the same."),
+        N_("FILE")
+    },
+
     {
         "nofile", '\0', 0, G_OPTION_ARG_NONE, &nofile,
         N_("Do not load the last file opened"), NULL
@@ -149,6 +164,24 @@ static GOptionEntry options[] =
            http://developer.gnome.org/doc/API/2.0/glib/glib-Commandline-option-parser.html */
         N_("FILE")
     },
+    {
+        "run-reports", '\0', 0, G_OPTION_ARG_FILENAME, &run_reports_file,
+        N_("Open the given datafile read-only without the GUI, run the reports listed in FILE and write them to files"),
+        /* Translators: Argument description for autohelp; see
+           http://developer.gnome.org/doc/API/2.0/glib/glib-Commandline-option-parser.html */
+        N_("FILE")
+    },
+    {
+        "report-jobs", '\0', 0, G_OPTION_ARG_INT, &report_jobs,
+        N_("Number of worker processes running the reports of --run-reports; defaults to 1"),
+        /* Translators: Argument description for autohelp; see
+           http://developer.gnome.org/doc/API/2.0/glib/glib-Commandline-option-parser.html */
+        N_("N")
+    },
+    {
+        "report-worker", '\0', G_OPTION_FLAG_HIDDEN, G_OPTION_ARG_NONE,
+        &report_worker, NULL, NULL
+    },
     {
         "namespace", '\0', 0, G_OPTION_ARG_STRING, &namespace_regexp,
         N_("Regular expression determining which namespace commodities will be retrieved"),
@@ -595,6 +628,448 @@ fail:
     gnc_shutdown(1);
 }
 
+/* One report of a --run-reports batch file. Each group of the key
+ * file is a job:
+ *
+ *   [Balance Sheet A]
+ *   report=<report or saved report guid>
+ *   output=balance-sheet-a.html
+ *   General/Report name="Entity A"
+ *
+ * Keys of the form Section/Name override that option with the value of
+ * the scheme expression. Relative output paths are relative to the
+ * batch file, the default output is the group name plus ".html". */
+typedef struct
+{
+    gchar  *name;
+    gchar  *report_guid;
+    gchar  *output;
+    gchar **overrides;
+} ReportJob;
+
+static void
+report_job_free (ReportJob *job)
+{
+    g_free (job->name);
+    g_free (job->report_guid);
+    g_free (job->output);
+    g_strfreev (job->overrides);
+    g_free (job);
+}
+
+static GPtrArray *
+load_report_jobs (const gchar *batch_file)
+{
+    GKeyFile *key_file = g_key_file_new ();
+    GError *error = NULL;
+    GPtrArray *jobs;
+    gchar *batch_dir, **groups, **group;
+
+    if (!g_key_file_load_from_file (key_file, batch_file, G_KEY_FILE_NONE,
+                                    &error))
+    {
+        g_printerr ("%s: %s\n", batch_file, error->message);
+        g_error_free (error);
+        g_key_file_free (key_file);
+        return NULL;
+    }
+
+    jobs = g_ptr_array_new_with_free_func ((GDestroyNotify)report_job_free);
+    batch_dir = g_path_get_dirname (batch_file);
+    groups = g_key_file_get_groups (key_file, NULL);
+    for (group = groups; *group; group++)
+    {
+        ReportJob *job = g_new0 (ReportJob, 1);
+        GPtrArray *overrides = g_ptr_array_new ();
+        gchar **keys = g_key_file_get_keys (key_file, *group, NULL, NULL);
+        gchar **key, *output;
+
+        job->name = g_strdup (*group);
+        job->report_guid = g_key_file_get_string (key_file, *group, "report",
+                                                  NULL);
+        output = g_key_file_get_string (key_file, *group, "output", NULL);
+        if (!output)
+            output = g_strconcat (*group, ".html", NULL);
+        if (g_path_is_absolute (output))
+            job->output = output;
+        else
+        {
+            job->output = g_build_filename (batch_dir, output, NULL);
+            g_free (output);
+        }
+
+        for (key = keys; key && *key; key++)
+        {
+            gchar *value;
+            if (!strchr (*key, '/'))
+                continue;
+            value = g_key_file_get_string (key_file, *group, *key, NULL);
+            g_ptr_array_add (overrides, g_strconcat (*key, "=", value, NULL));
+            g_free (value);
+        }
+        g_ptr_array_add (overrides, NULL);
+        job->overrides = (gchar**)g_ptr_array_free (overrides, FALSE);
+        g_strfreev (keys);
+
+        if (!job->report_guid)
+        {
+            g_printerr (_("Report %s in %s names no report.\n"), *group,
+                        batch_file);
+            report_job_free (job);
+            continue;
+        }
+        g_ptr_array_add (jobs, job);
+    }
+
+    g_strfreev (groups);
+    g_free (batch_dir);
+    g_key_file_free (key_file);
+    return jobs;
+}
+
+static void
+print_report_job (const ReportJob *job, gint64 elapsed, gboolean success)
+{
+    g_print ("%-40s %10.1f ms  %s\n", job->name, elapsed / 1000.0,
+             success ? job->output : _("failed"));
+    fflush (stdout);
+}
+
+static gboolean
+run_report_job (const ReportJob *job)
+{
+    gint64 start = g_get_monotonic_time ();
+    gboolean success = gnc_run_report_to_file (job->report_guid,
+                                               job->overrides, job->output);
+
+    print_report_job (job, g_get_monotonic_time () - start, success);
+    return success;
+}
+
+/* Run the jobs in this process and return how many failed. */
+static guint
+run_report_jobs (GPtrArray *jobs)
+{
+    guint failures = 0, i;
+
+    for (i = 0; i < jobs->len; i++)
+        if (!run_report_job (g_ptr_array_index (jobs, i)))
+            failures++;
+    return failures;
+}
+
+#ifndef G_OS_WIN32
+/* --report-jobs runs the batch in worker processes, each a fresh
+ * "gnucash --run-reports --report-worker" that loads the data file
+ * itself: forking one that already runs Guile and the engine's threads
+ * is not safe. The workers read job numbers from their stdin, one at a
+ * time so a long report does not hold up the others, and answer each
+ * with "<job> <success> <microseconds>" on their stdout. */
+typedef struct ReportBatch ReportBatch;
+
+typedef struct
+{
+    ReportBatch *batch;
+    FILE        *to_worker;
+    gint         job;       /* the job running, or -1 */
+} ReportWorker;
+
+struct ReportBatch
+{
+    GPtrArray *jobs;
+    guint      next_job;
+    guint      failures;
+    gint       running;
+    GMainLoop *loop;
+};
+
+static void
+report_worker_send_job (ReportWorker *worker)
+{
+    ReportBatch *batch = worker->batch;
+
+    worker->job = -1;
+    if (!worker->to_worker)
+        return;
+    if (batch->next_job < batch->jobs->len)
+    {
+        worker->job = batch->next_job++;
+        fprintf (worker->to_worker, "%d\n", worker->job);
+        fflush (worker->to_worker);
+    }
+    else
+    {
+        /* No more jobs, let the worker exit. */
+        fclose (worker->to_worker);
+        worker->to_worker = NULL;
+    }
+}
+
+static gboolean
+report_worker_results_cb (GIOChannel *channel, GIOCondition condition,
+                          gpointer data)
+{
+    ReportWorker *worker = data;
+    ReportBatch *batch = worker->batch;
+    gchar *line = NULL;
+    guint job;
+    gint success;
+    gint64 elapsed;
+
+    if (g_io_channel_read_line (channel, &line, NULL, NULL, NULL) ==
+        G_IO_STATUS_NORMAL)
+    {
+        if (sscanf (line, "%u %d %" G_GINT64_FORMAT, &job, &success,
+                    &elapsed) == 3 && (gint)job == worker->job)
+        {
+            print_report_job (g_ptr_array_index (batch->jobs, job), elapsed,
+                              success);
+            if (!success)
+                batch->failures++;
+            report_worker_send_job (worker);
+        }
+        g_free (line);
+        return TRUE;
+    }
+
+    /* The worker exited; if it was in the middle of a report, that one
+     * failed. */
+    if (worker->job >= 0)
+    {
+        print_report_job (g_ptr_array_index (batch->jobs, worker->job), 0,
+                          FALSE);
+        batch->failures++;
+    }
+    if (worker->to_worker)
+        fclose (worker->to_worker);
+    worker->to_worker = NULL;
+    worker->job = -1;
+    if (--batch->running == 0)
+        g_main_loop_quit (batch->loop);
+    return FALSE;
+}
+
+static gchar **
+report_worker_argv (void)
+{
+    GPtrArray *args = g_ptr_array_new ();
+    gchar **flag;
+
+    g_ptr_array_add (args, g_strdup (program_path));
+    g_ptr_array_add (args, g_strdup ("--run-reports"));
+    g_ptr_array_add (args, g_strdup (run_reports_file));
+    g_ptr_array_add (args, g_strdup ("--report-worker"));
+    if (debugging)
+        g_ptr_array_add (args, g_strdup ("--debug"));
+    for (flag = log_flags; flag && *flag; flag++)
+    {
+        g_ptr_array_add (args, g_strdup ("--log"));
+        g_ptr_array_add (args, g_strdup (*flag));
+    }
+    if (log_to_filename)
+    {
+        g_ptr_array_add (args, g_strdup ("--logto"));
+        g_ptr_array_add (args, g_strdup (log_to_filename));
+    }
+    if (gsettings_prefix)
+    {
+        g_ptr_array_add (args, g_strdup ("--gsettings-prefix"));
+        g_ptr_array_add (args, g_strdup (gsettings_prefix));
+    }
+    g_ptr_array_add (args, g_strdup ("--"));
+    g_ptr_array_add (args, g_strdup (file_to_load));
+    g_ptr_array_add (args, NULL);
+    return (gchar**)g_ptr_array_free (args, FALSE);
+}
+
+/* Run the batch in @a workers worker processes and return the exit
+ * status, or -1 if the batch should run in this process instead. */
+static gint
+run_report_workers (gint workers)
+{
+    ReportBatch batch = { NULL, 0, 0, 0, NULL };
+    ReportWorker *pool;
+    gchar **worker_argv;
+    gint64 start = g_get_monotonic_time ();
+    gint i;
+
+    if (!file_to_load)
+        return -1;
+    batch.jobs = load_report_jobs (run_reports_file);
+    if (!batch.jobs)
+        return 1;
+    workers = MIN (workers, (gint)batch.jobs->len);
+    if (workers <= 1)
+    {
+        g_ptr_array_free (batch.jobs, TRUE);
+        return -1;
+    }
+
+    /* A worker that died must not take us with it. */
+    signal (SIGPIPE, SIG_IGN);
+    batch.loop = g_main_loop_new (NULL, FALSE);
+    pool = g_new0 (ReportWorker, workers);
+    worker_argv = report_worker_argv ();
+    for (i = 0; i < workers; i++)
+    {
+        ReportWorker *worker = &pool[i];
+        GError *error = NULL;
+        GIOChannel *channel;
+        gint in_fd, out_fd;
+
+        worker->batch = &batch;
+        worker->job = -1;
+        if (!g_spawn_async_with_pipes (NULL, worker_argv, NULL,
+                                       G_SPAWN_SEARCH_PATH, NULL, NULL, NULL,
+                                       &in_fd, &out_fd, NULL, &error))
+        {
+            g_warning ("Could not start report worker: %s", error->message);
+            g_error_free (error);
+            break;
+        }
+        worker->to_worker = fdopen (in_fd, "w");
+        channel = g_io_channel_unix_new (out_fd);
+        g_io_channel_set_close_on_unref (channel, TRUE);
+        g_io_channel_set_encoding (channel, NULL, NULL);
+        g_io_add_watch (channel, G_IO_IN | G_IO_HUP | G_IO_ERR,
+                        report_worker_results_cb, worker);
+        g_io_channel_unref (channel);
+        batch.running++;
+        report_worker_send_job (worker);
+    }
+    g_strfreev (worker_argv);
+
+    if (batch.running)
+        g_main_loop_run (batch.loop);
+
+    /* Jobs no worker lived to take. */
+    for (; batch.next_job < batch.jobs->len; batch.next_job++)
+    {
+        print_report_job (g_ptr_array_index (batch.jobs, batch.next_job), 0,
+                          FALSE);
+        batch.failures++;
+    }
+    g_print (_("Ran %u reports in %.1f ms, %u failed\n"), batch.jobs->len,
+             (g_get_monotonic_time () - start) / 1000.0, batch.failures);
+
+    g_free (pool);
+    g_main_loop_unref (batch.loop);
+    g_ptr_array_free (batch.jobs, TRUE);
+    return batch.failures ? 1 : 0;
+}
+
+/* The worker side: run the jobs whose numbers come in on stdin and
+ * report each on @a results. */
+static void
+run_report_jobs_for_coordinator (GPtrArray *jobs, FILE *results)
+{
+    gchar line[32];
+
+    while (fgets (line, sizeof (line), stdin))
+    {
+        guint job = (guint)strtoul (line, NULL, 10);
+        gint64 start = g_get_monotonic_time ();
+        const ReportJob *report_job;
+        gboolean success;
+
+        if (job >= jobs->len)
+            continue;
+        report_job = g_ptr_array_index (jobs, job);
+        success = gnc_run_report_to_file (report_job->report_guid,
+                                          report_job->overrides,
+                                          report_job->output);
+        fprintf (results, "%u %d %" G_GINT64_FORMAT "\n", job, success ? 1 : 0,
+                 g_get_monotonic_time () - start);
+        fflush (results);
+    }
+}
+#endif
+
+static void
+inner_main_run_reports (void *closure, int argc, char **argv)
+{
+    QofSession *session = NULL;
+    GPtrArray *jobs;
+    gint64 start = g_get_monotonic_time ();
+    guint failures = 0;
+#ifndef G_OS_WIN32
+    FILE *results = NULL;
+
+    /* Only the results go to the coordinator; anything else printed
+     * goes to stderr. */
+    if (report_worker)
+    {
+        results = fdopen (dup (STDOUT_FILENO), "w");
+        dup2 (STDERR_FILENO, STDOUT_FILENO);
+    }
+#endif
+
+    scm_c_eval_string("(debug-set! stack 200000)");
+    scm_set_current_module(scm_c_resolve_module("gnucash utilities"));
+
+    if (!file_to_load)
+    {
+        g_printerr ("%s", _("--run-reports needs a datafile to run the reports on.\n"));
+        gnc_shutdown(1);
+        return;
+    }
+    jobs = load_report_jobs (run_reports_file);
+    if (!jobs)
+    {
+        gnc_shutdown(1);
+        return;
+    }
+
+    gnc_prefs_init ();
+    gnc_module_load("gnucash/engine", 0);
+    gnc_module_load("gnucash/app-utils", 0);
+    gnc_module_load("gnucash/report/report-system", 0);
+    gnc_module_load("gnucash/report/stylesheets", 0);
+    gnc_module_load("gnucash/report/locale-specific/us", 0);
+    scm_c_use_module("gnucash report standard-reports");
+    scm_c_use_module("gnucash report business-reports");
+    load_system_config();
+    load_user_config();
+
+    qof_event_suspend();
+    session = gnc_get_current_session();
+    qof_session_begin(session, file_to_load, TRUE, FALSE, FALSE);
+    if (qof_session_get_error(session) == ERR_BACKEND_NO_ERR)
+        qof_session_load(session, NULL);
+    qof_event_resume();
+    if (qof_session_get_error(session) != ERR_BACKEND_NO_ERR)
+    {
+        g_printerr("%s: %s\n", file_to_load,
+                   qof_session_get_error_message(session));
+        g_ptr_array_free (jobs, TRUE);
+        gnc_clear_current_session();
+        gnc_shutdown(1);
+        return;
+    }
+    /* The reports must not change the book, nothing will be saved. */
+    qof_book_mark_readonly(qof_session_get_book(session));
+    g_print (_("Loaded %s in %.1f ms\n"), file_to_load,
+             (g_get_monotonic_time () - start) / 1000.0);
+
+#ifndef G_OS_WIN32
+    if (results)
+    {
+        run_report_jobs_for_coordinator (jobs, results);
+        fclose (results);
+    }
+    else
+#endif
+    {
+        failures = run_report_jobs (jobs);
+        g_print (_("Ran %u reports in %.1f ms, %u failed\n"), jobs->len,
+                 (g_get_monotonic_time () - start) / 1000.0, failures);
+    }
+
+    g_ptr_array_free (jobs, TRUE);
+    gnc_clear_current_session();
+    gnc_shutdown(failures ? 1 : 0);
+}
+
 static char *
 get_file_to_load()
 {
@@ -748,6 +1223,9 @@ gnc_log_init()
             g_strfreev(parts);
         }
     }
+
+    if (trace_filename != NULL)
+        qof_trace_set_file(trace_filename);
 }
 
 #ifdef __MINGW32__
@@ -847,6 +1325,7 @@ int
 main(int argc, char ** argv)
 {
     gchar *localedir = gnc_path_get_localedir();
+    program_path = argv[0];
 #if !defined(G_THREADS_ENABLED) || defined(G_THREADS_IMPL_NONE)
 #    error "No GLib thread implementation available!"
 #endif
@@ -916,6 +1395,24 @@ main(int argc, char ** argv)
         exit(0);  /* never reached */
     }
 
+    /* Run a batch of reports without the main window */
+    if (run_reports_file)
+    {
+#ifndef G_OS_WIN32
+        if (report_jobs > 1 && !report_worker)
+        {
+            gint status = run_report_workers (report_jobs);
+            if (status >= 0)
+                exit (status);
+        }
+#endif
+        /* The stylesheets like a display but the reports do without. */
+        gtk_init_check (&argc, &argv);
+        gnc_module_system_init();
+        scm_boot_guile(argc, argv, inner_main_run_reports, 0);
+        exit(0);  /* never reached */
+    }
+
     /* We need to initialize gtk before looking up all modules */
     if(!gtk_init_check (&argc, &argv))
     {
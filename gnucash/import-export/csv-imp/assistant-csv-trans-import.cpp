@@ -1815,15 +1815,12 @@ CsvImpTransAssist::acct_match_select(GtkTreeModel *model, GtkTreeIter* iter)
 
     if (gnc_acc) // We may have canceled
     {
-        auto fullpath = gnc_account_get_full_name (gnc_acc);
         gtk_list_store_set (GTK_LIST_STORE(model), iter,
                 MAPPING_ACCOUNT, gnc_acc,
-                MAPPING_FULLPATH, fullpath, -1);
+                MAPPING_FULLPATH, gnc_account_peek_full_name (gnc_acc), -1);
 
         // Update the account kvp mappings
         gnc_csv_account_map_change_mappings (account, gnc_acc, text);
-
-        g_free (fullpath);
     }
     g_free (text);
 
@@ -113,7 +113,6 @@ gnc_csv_account_map_load_mappings (GtkTreeModel *mappings_store)
     {
         Account *account = NULL;
         gchar   *map_string;
-        gchar   *fullpath;
 
         // Walk through the list, reading each row
         gtk_tree_model_get (GTK_TREE_MODEL(mappings_store), &iter, MAPPING_STRING, &map_string, MAPPING_ACCOUNT, &account, -1);
@@ -129,10 +128,9 @@ gnc_csv_account_map_load_mappings (GtkTreeModel *mappings_store)
                 continue;
             }
         }
-        fullpath = gnc_account_get_full_name (account);
-        gtk_list_store_set (GTK_LIST_STORE(mappings_store), &iter, MAPPING_FULLPATH, fullpath, -1);
+        gtk_list_store_set (GTK_LIST_STORE(mappings_store), &iter, MAPPING_FULLPATH,
+                            gnc_account_peek_full_name (account), -1);
         gtk_list_store_set (GTK_LIST_STORE(mappings_store), &iter, MAPPING_ACCOUNT, account, -1);
-        g_free (fullpath);
 
         g_free (map_string);
         valid = gtk_tree_model_iter_next (mappings_store, &iter);
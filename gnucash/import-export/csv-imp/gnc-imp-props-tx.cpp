@@ -107,10 +107,11 @@ GncNumeric parse_amount (const std::string &str, int currency_format)
         return GncNumeric{};
 
     /* Strings otherwise containing not digits will be considered invalid */
-    if(!boost::regex_search(str, boost::regex("[0-9]")))
+    static const boost::regex digit("[0-9]");
+    if(!boost::regex_search(str, digit))
         throw std::invalid_argument (_("Value doesn't appear to contain a valid number."));
 
-    auto expr = boost::make_u32regex("[[:Sc:]]");
+    static const auto expr = boost::make_u32regex("[[:Sc:]]");
     std::string str_no_symbols = boost::u32regex_replace(str, expr, "");
 
     /* Convert based on user chosen currency format */
@@ -138,6 +139,67 @@ GncNumeric parse_amount (const std::string &str, int currency_format)
     return GncNumeric(val);
 }
 
+static GncImpParseCache *parse_cache = nullptr;
+
+GncImpParseCache::Use::Use(GncImpParseCache& cache) : m_previous{parse_cache}
+{
+    parse_cache = &cache;
+}
+
+GncImpParseCache::Use::~Use()
+{
+    parse_cache = m_previous;
+}
+
+/* Parse str in format with parse, or take the earlier result from the
+ * cache in use. Errors are remembered as well and thrown again. */
+template <typename T, typename P> static T
+parse_cached (std::map<GncImpParseKey, GncImpParseResult<T>> GncImpParseCache::*results,
+              const std::string& str, int format, P parse)
+{
+    if (!parse_cache)
+        return parse (str, format);
+
+    auto& cache = parse_cache->*results;
+    auto key = GncImpParseKey{format, str};
+    auto cached = cache.find (key);
+    if (cached == cache.end())
+    {
+        GncImpParseResult<T> result;
+        try
+        {
+            result.value = parse (str, format);
+        }
+        catch (const std::invalid_argument& e)
+        {
+            result.error = e.what();
+        }
+        catch (const std::out_of_range& e)
+        {
+            result.error = e.what();
+        }
+        cached = cache.emplace (key, std::move (result)).first;
+    }
+    if (!cached->second.value)
+        throw std::invalid_argument (cached->second.error);
+    return *cached->second.value;
+}
+
+static GncDate parse_date (const std::string& str, int date_format)
+{
+    return GncDate (str, GncDate::c_formats[date_format].m_fmt); // Throws if parsing fails
+}
+
+static GncDate parse_date_cached (const std::string& str, int date_format)
+{
+    return parse_cached (&GncImpParseCache::m_dates, str, date_format, parse_date);
+}
+
+static GncNumeric parse_amount_cached (const std::string& str, int currency_format)
+{
+    return parse_cached (&GncImpParseCache::m_amounts, str, currency_format, parse_amount);
+}
+
 static char parse_reconciled (const std::string& reconcile)
 {
     if (g_strcmp0 (reconcile.c_str(), gnc_get_reconcile_str(NREC)) == 0) // Not reconciled
@@ -211,7 +273,7 @@ void GncPreTrans::set (GncTransPropType prop_type, const std::string& value)
 
             case GncTransPropType::DATE:
                 m_date = boost::none;
-                m_date = GncDate(value, GncDate::c_formats[m_date_format].m_fmt); // Throws if parsing fails
+                m_date = parse_date_cached (value, m_date_format); // Throws if parsing fails
                 break;
 
             case GncTransPropType::NUM:
@@ -343,6 +405,40 @@ bool GncPreTrans::is_part_of (std::shared_ptr<GncPreTrans> parent)
             parent->m_errors.empty(); // A GncPreTrans with errors can never be a parent
 }
 
+/* Searching the account map walks the complete account tree. While a
+ * GncImpAccountMapCache is alive the mappings can't change, so the accounts
+ * found are remembered by import string. */
+static std::map<std::string, Account*> *account_map_cache = nullptr;
+
+GncImpAccountMapCache::GncImpAccountMapCache()
+{
+    if (!account_map_cache)
+    {
+        account_map_cache = &m_accounts;
+        m_active = true;
+    }
+}
+
+GncImpAccountMapCache::~GncImpAccountMapCache()
+{
+    if (m_active)
+        account_map_cache = nullptr;
+}
+
+static Account* account_map_search (const std::string& map_string)
+{
+    if (!account_map_cache)
+        return gnc_csv_account_map_search (map_string.c_str());
+
+    auto cached = account_map_cache->find (map_string);
+    if (cached != account_map_cache->end())
+        return cached->second;
+
+    auto acct = gnc_csv_account_map_search (map_string.c_str());
+    account_map_cache->emplace (map_string, acct);
+    return acct;
+}
+
 /* Declare two translatable error strings here as they will be used in several places */
 const char *bad_acct = N_("Account value can't be mapped back to an account.");
 const char *bad_tacct = N_("Transfer account value can't be mapped back to an account.");
@@ -395,7 +491,7 @@ void GncPreSplit::set (GncTransPropType prop_type, const std::string& value)
                 m_account = boost::none;
                 if (value.empty())
                     throw std::invalid_argument (_("Account value can't be empty."));
-                acct = gnc_csv_account_map_search (value.c_str());
+                acct = account_map_search (value);
                 if (acct)
                     m_account = acct;
                 else
@@ -407,7 +503,7 @@ void GncPreSplit::set (GncTransPropType prop_type, const std::string& value)
                 if (value.empty())
                     throw std::invalid_argument (_("Transfer account value can't be empty."));
 
-                acct = gnc_csv_account_map_search (value.c_str());
+                acct = account_map_search (value);
                 if (acct)
                     m_taccount = acct;
                 else
@@ -428,16 +524,16 @@ void GncPreSplit::set (GncTransPropType prop_type, const std::string& value)
 
             case GncTransPropType::DEPOSIT:
                 m_deposit = boost::none;
-                m_deposit = parse_amount (value, m_currency_format); // Will throw if parsing fails
+                m_deposit = parse_amount_cached (value, m_currency_format); // Will throw if parsing fails
                 break;
             case GncTransPropType::WITHDRAWAL:
                 m_withdrawal = boost::none;
-                m_withdrawal = parse_amount (value, m_currency_format); // Will throw if parsing fails
+                m_withdrawal = parse_amount_cached (value, m_currency_format); // Will throw if parsing fails
                 break;
 
             case GncTransPropType::PRICE:
                 m_price = boost::none;
-                m_price = parse_amount (value, m_currency_format); // Will throw if parsing fails
+                m_price = parse_amount_cached (value, m_currency_format); // Will throw if parsing fails
                 break;
 
             case GncTransPropType::REC_STATE:
@@ -453,15 +549,13 @@ void GncPreSplit::set (GncTransPropType prop_type, const std::string& value)
             case GncTransPropType::REC_DATE:
                 m_rec_date = boost::none;
                 if (!value.empty())
-                    m_rec_date = GncDate (value,
-                                          GncDate::c_formats[m_date_format].m_fmt); // Throws if parsing fails
+                    m_rec_date = parse_date_cached (value, m_date_format); // Throws if parsing fails
                 break;
 
             case GncTransPropType::TREC_DATE:
                 m_trec_date = boost::none;
                 if (!value.empty())
-                    m_trec_date = GncDate (value,
-                                           GncDate::c_formats[m_date_format].m_fmt); // Throws if parsing fails
+                    m_trec_date = parse_date_cached (value, m_date_format); // Throws if parsing fails
                 break;
 
             default:
@@ -514,14 +608,14 @@ void GncPreSplit::add (GncTransPropType prop_type, const std::string& value)
         switch (prop_type)
         {
             case GncTransPropType::DEPOSIT:
-                num_val = parse_amount (value, m_currency_format); // Will throw if parsing fails
+                num_val = parse_amount_cached (value, m_currency_format); // Will throw if parsing fails
                 if (m_deposit)
                     num_val += *m_deposit;
                 m_deposit = num_val;
                 break;
 
             case GncTransPropType::WITHDRAWAL:
-                num_val = parse_amount (value, m_currency_format); // Will throw if parsing fails
+                num_val = parse_amount_cached (value, m_currency_format); // Will throw if parsing fails
                 if (m_withdrawal)
                     num_val += *m_withdrawal;
                 m_withdrawal = num_val;
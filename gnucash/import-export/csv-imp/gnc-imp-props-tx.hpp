@@ -104,6 +104,67 @@ private:
 GncTransPropType sanitize_trans_prop (GncTransPropType prop, bool multi_split);
 
 
+/** While an instance of this class is alive, the accounts found for Account
+ *  and Transfer Account values are remembered per import string instead of
+ *  searching the account map again for each line. Create one on the stack
+ *  around code that (re)parses a whole column.
+ *  Instances can be nested, only the outermost one holds the cache.
+ */
+class GncImpAccountMapCache
+{
+public:
+    GncImpAccountMapCache();
+    ~GncImpAccountMapCache();
+    GncImpAccountMapCache(const GncImpAccountMapCache&) = delete;
+    GncImpAccountMapCache& operator=(const GncImpAccountMapCache&) = delete;
+
+private:
+    std::map<std::string, Account*> m_accounts;
+    bool m_active = false;
+};
+
+/** A parsed value, or the error parsing it gave. */
+template <typename T>
+struct GncImpParseResult
+{
+    boost::optional<T> value;
+    std::string error;
+};
+
+using GncImpParseKey = std::pair<int, std::string>;
+
+/** Dates and amounts already parsed, by date or currency format and
+ *  import string. Nothing else goes into parsing them, so a GncTxImport
+ *  keeps one for as long as it lives: a value that repeats in a column
+ *  is parsed only once, and going back to a date or currency format
+ *  tried before doesn't parse the column again.
+ *  The property parsers only consult it while a GncImpParseCache::Use
+ *  for it is alive; create one on the stack around code that (re)parses
+ *  a whole column.
+ */
+class GncImpParseCache
+{
+public:
+    GncImpParseCache() = default;
+    GncImpParseCache(const GncImpParseCache&) = delete;
+    GncImpParseCache& operator=(const GncImpParseCache&) = delete;
+
+    class Use
+    {
+    public:
+        Use(GncImpParseCache& cache);
+        ~Use();
+        Use(const Use&) = delete;
+        Use& operator=(const Use&) = delete;
+
+    private:
+        GncImpParseCache *m_previous;
+    };
+
+    std::map<GncImpParseKey, GncImpParseResult<GncDate>> m_dates;
+    std::map<GncImpParseKey, GncImpParseResult<GncNumeric>> m_amounts;
+};
+
 gnc_commodity* parse_commodity (const std::string& comm_str);
 GncNumeric parse_amount (const std::string &str, int currency_format);
 
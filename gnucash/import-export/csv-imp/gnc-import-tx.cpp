@@ -206,6 +206,9 @@ void GncTxImport::reset_formatted_column (std::vector<GncTransPropType>& col_typ
 
 void GncTxImport::currency_format (int currency_format)
 {
+    if (currency_format == m_settings.m_currency_format)
+        return; /* Already parsed with this format */
+
     m_settings.m_currency_format = currency_format;
 
     /* Reparse all currency related columns */
@@ -218,6 +221,9 @@ int GncTxImport::currency_format () { return m_settings.m_currency_format; }
 
 void GncTxImport::date_format (int date_format)
 {
+    if (date_format == m_settings.m_date_format)
+        return; /* Already parsed with this format */
+
     m_settings.m_date_format = date_format;
 
     /* Reparse all date related columns */
@@ -390,7 +396,8 @@ void GncTxImport::tokenize (bool guessColTypes)
     uint32_t max_cols = 0;
     m_tokenizer->tokenize();
     m_parsed_lines.clear();
-    for (auto tokenized_line : m_tokenizer->get_tokens())
+    m_parsed_lines.reserve (m_tokenizer->get_tokens().size());
+    for (auto& tokenized_line : m_tokenizer->get_tokens())
     {
         auto length = tokenized_line.size();
         if (length > 0)
@@ -412,11 +419,13 @@ void GncTxImport::tokenize (bool guessColTypes)
     m_settings.m_column_types.resize(max_cols, GncTransPropType::NONE);
 
     /* Force reinterpretation of already set columns and/or base_account */
+    GncImpAccountMapCache acct_cache;
+    GncImpParseCache::Use parse_cache_use {m_parse_cache};
     for (uint32_t i = 0; i < m_settings.m_column_types.size(); i++)
         set_column_type (i, m_settings.m_column_types[i], true);
     if (m_settings.m_base_account)
     {
-        for (auto line : m_parsed_lines)
+        for (auto& line : m_parsed_lines)
             std::get<PL_PRESPLIT>(line)->set_account (m_settings.m_base_account);
     }
 
@@ -854,6 +863,8 @@ GncTxImport::set_column_type (uint32_t position, GncTransPropType type, bool for
         base_account (nullptr);
 
     /* Update the preparsed data */
+    GncImpAccountMapCache acct_cache;
+    GncImpParseCache::Use parse_cache_use {m_parse_cache};
     m_parent = nullptr;
     for (auto parsed_lines_it = m_parsed_lines.begin();
             parsed_lines_it != m_parsed_lines.end();
@@ -193,6 +193,7 @@ private:
     CsvTransImpSettings m_settings;
     bool m_skip_errors;
     bool m_req_mapped_accts;
+    GncImpParseCache m_parse_cache;  /**< Dates and amounts parsed so far, in any format */
 
     /* The parameters below are only used while creating
      * transactions. They keep state information while processing multi-split
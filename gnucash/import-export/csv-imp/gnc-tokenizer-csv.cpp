@@ -6,10 +6,9 @@
 #include <string>
 #include <algorithm>    // copy
 #include <iterator>     // ostream_operator
-
-#include <boost/tokenizer.hpp>
-#include <boost/locale.hpp>
-#include <boost/algorithm/string.hpp>
+#include <array>
+#include <cstring>      // memchr
+#include <locale>
 
 extern "C" {
     #include <glib/gi18n.h>
@@ -21,92 +20,228 @@ GncCsvTokenizer::set_separators(const std::string& separators)
     m_sep_str = separators;
 }
 
+/* Character classes used by the tokenizer state machine. */
+enum CsvCharClass : unsigned char
+{
+    CSV_PLAIN = 0,
+    CSV_SEP   = 1 << 0,
+    CSV_QUOTE = 1 << 1,
+    CSV_ESC   = 1 << 2,
+};
+
+using CsvClassTable = std::array<unsigned char, 256>;
 
-int GncCsvTokenizer::tokenize()
+static inline unsigned char
+char_class (const CsvClassTable& table, char c)
 {
-    using Tokenizer = boost::tokenizer< boost::escaped_list_separator<char>>;
+    return table[static_cast<unsigned char>(c)];
+}
 
-    boost::escaped_list_separator<char> sep("\\", m_sep_str, "\"");
+/* Split a single logical record (already trimmed, with any embedded line
+ * breaks replaced by spaces) into fields.
+ *
+ * This is a single pass over the record which yields exactly the same fields
+ * as the former implementation did. That one first doubled each backslash
+ * that didn't start one of the known escapes \\, \" or \n, then replaced
+ * each "" that was not an empty field by \" and finally ran the result
+ * through boost's escaped_list_separator. All three steps are folded into
+ * the state machine below:
+ * - a backslash followed by ", \ or n is an escape sequence, any other
+ *   backslash is a literal character;
+ * - "" inside a field is a literal double quote, "" surrounded by
+ *   separators or the record boundaries is an empty quoted field;
+ * - other double quotes toggle quoting, separators in quoted text are
+ *   literal characters.
+ * Runs of ordinary characters are copied into the field in one go, so a
+ * field that contains no quotes or escapes is constructed directly from the
+ * input buffer.
+ */
+static void
+tokenize_record (const char *rec, size_t len, const CsvClassTable& table,
+                 StrVec& fields)
+{
+    fields.clear();
+    if (len == 0)
+        return;
 
-    StrVec vec;
-    std::string line;
-    std::string buffer;
+    auto is_sep = [&table](char c) { return char_class (table, c) & CSV_SEP; };
 
-    bool inside_quotes(false);
-    size_t last_quote(0);
+    std::string field;
+    bool in_quotes = false;
+    size_t run = 0;     // start of the pending run of literal characters
+    size_t i = 0;
 
-    m_tokenized_contents.clear();
-    std::istringstream in_stream(m_utf8_contents);
+    auto flush_run = [&](size_t end)
+    {
+        if (end > run)
+            field.append (rec + run, end - run);
+    };
+    auto end_field = [&](size_t end)
+    {
+        if (field.empty())
+            fields.emplace_back (rec + run, end - run);
+        else
+        {
+            flush_run (end);
+            fields.push_back (std::move (field));
+            field.clear();
+        }
+    };
+    /* A separator or double quote which is not part of an escape sequence.
+     * Separators take precedence over quotes, like in boost's tokenizer. */
+    auto special = [&](unsigned char cls)
+    {
+        if ((cls & CSV_SEP) && !in_quotes)
+            end_field (i);
+        else if (cls & CSV_SEP)
+            return;     // literal separator, keep it in the current run
+        else
+        {
+            flush_run (i);
+            in_quotes = !in_quotes;
+        }
+        run = i + 1;
+    };
+    auto literal = [&](char c, size_t skip)
+    {
+        flush_run (i);
+        field.push_back (c);
+        run = i + skip;
+    };
 
-    try
+    while (i < len)
     {
-        while (std::getline (in_stream, buffer))
+        auto c = rec[i];
+        auto cls = char_class (table, c);
+        if (cls == CSV_PLAIN)
         {
-            // --- deal with line breaks in quoted strings
-            buffer = boost::trim_copy (buffer); // Removes trailing newline and spaces
-            last_quote = buffer.find_first_of('"');
-            while (last_quote != std::string::npos)
-            {
-                if (last_quote == 0) // Test separately because last_quote - 1 would be out of range
-                    inside_quotes = !inside_quotes;
-                else if (buffer[ last_quote - 1 ] != '\\')
-                    inside_quotes = !inside_quotes;
+            ++i;
+            continue;
+        }
 
-                last_quote = buffer.find_first_of('"',last_quote+1);
+        if (c == '\\')
+        {
+            auto next = (i + 1 < len) ? rec[i + 1] : '\0';
+            if (next != '"' && next != '\\' && next != 'n')
+            {
+                // Backslash that doesn't start an escape is literal
+                literal ('\\', 1);
+                ++i;
             }
-
-            line.append(buffer);
-            if (inside_quotes)
+            else if (next == '"' && i + 2 < len && rec[i + 2] == '"')
             {
-                line.append(" ");
-                continue;
+                /* \"" - the former implementation turned the \" into \\
+                 * unless the "" looked like an empty field. The final "
+                 * is an ordinary quote either way. */
+                auto empty_field = is_sep ('\\') &&
+                                   (i + 3 >= len || is_sep (rec[i + 3]));
+                literal (empty_field ? '"' : '\\', 2);
+                i += 2;
+                special (char_class (table, '"'));
+                ++i;
             }
-            // ---
-
-            // Deal with backslashes that are not meant to be escapes
-            // The boost::tokenizer with escaped_list_separator as we use
-            // it would choke on this.
-            auto bs_pos = line.find ('\\');
-            while (bs_pos != std::string::npos)
+            else
             {
-                if ((bs_pos == line.size()) ||                                 // got trailing single backslash
-                    (line.find_first_of ("\"\\n", bs_pos + 1) != bs_pos + 1))  // backslash is not part of known escapes \\, \" or \n
-                    line = line.substr(0, bs_pos) + "\\\\" + line.substr(bs_pos + 1);
-                bs_pos += 2;
-                bs_pos = line.find ('\\', bs_pos);
+                literal (next == 'n' ? '\n' : next, 2);
+                i += 2;
             }
-
-            // Deal with repeated " ("") in strings.
-            // This is commonly used as escape mechanism for double quotes in csv files.
-            // However boost just eats them.
-            bs_pos = line.find ("\"\"");
-            while (bs_pos != std::string::npos)
+        }
+        else if (c == '"' && i + 1 < len && rec[i + 1] == '"')
+        {
+            auto empty_field = (i == 0 || is_sep (rec[i - 1])) &&
+                               (i + 2 >= len || is_sep (rec[i + 2]));
+            if (empty_field)
             {
-                // Only make changes in case the double quotes are part of a larger field
-                // In other words a field which only contains two double quotes represent an
-                // empty field. We don't need to touch those.
-                // The way to determine whether the double quotes represent an empty string
-                // is by checking whether the character in front or after are either
-                // a field separator or the beginning or end of of the string.
-                if (!(((bs_pos == 0) ||                                          // quotes are at start of line
-                       (m_sep_str.find (line[bs_pos-1]) != std::string::npos))    // quotes preceded by field separator
-                      &&
-                      ((bs_pos + 2 >= line.length()) ||                          // quotes are at end of line
-                       (m_sep_str.find (line[bs_pos+2]) != std::string::npos))))   // quotes followed by field separator
-                    // Only make changes in case the double quotes are not an empty field
-                    line.replace (bs_pos, 2, "\\\"");
-                bs_pos = line.find ("\"\"", bs_pos + 2);
+                special (cls);
+                ++i;
+                special (cls);
+                ++i;
+            }
+            else
+            {
+                literal ('"', 2);
+                i += 2;
             }
-
-            Tokenizer tok(line, sep);
-            vec.assign(tok.begin(),tok.end());
-            m_tokenized_contents.push_back(vec);
-            line.clear();
+        }
+        else
+        {
+            special (cls);
+            ++i;
         }
     }
-    catch (boost::escaped_list_error &e)
+    end_field (len);
+}
+
+int GncCsvTokenizer::tokenize()
+{
+    CsvClassTable table {};
+    for (auto sep : m_sep_str)
+        table[static_cast<unsigned char>(sep)] |= CSV_SEP;
+    table[static_cast<unsigned char>('"')] |= CSV_QUOTE;
+    table[static_cast<unsigned char>('\\')] |= CSV_ESC;
+
+    // Lines are trimmed with the same notion of white space as boost::trim
+    auto& ctype = std::use_facet<std::ctype<char>>(std::locale());
+    auto is_space = [&ctype](char c) { return ctype.is (std::ctype_base::space, c); };
+
+    m_tokenized_contents.clear();
+    m_tokenized_contents.reserve (std::count (m_utf8_contents.begin(),
+                                              m_utf8_contents.end(), '\n') + 1);
+
+    auto data = m_utf8_contents.data();
+    auto size = m_utf8_contents.size();
+    size_t pos = 0;
+
+    bool inside_quotes = false;
+    bool continued = false;     // record spans more than one line
+    std::string record;         // only used for such multi-line records
+    StrVec fields;
+
+    while (pos < size)
     {
-        throw (std::range_error N_("There was an error parsing the file."));
+        auto eol = static_cast<const char*>(memchr (data + pos, '\n', size - pos));
+        size_t line_end = eol ? eol - data : size;
+        size_t next_line = eol ? line_end + 1 : size;
+
+        auto begin = pos;
+        auto end = line_end;
+        while (begin < end && is_space (data[begin]))
+            ++begin;
+        while (end > begin && is_space (data[end - 1]))
+            --end;
+        pos = next_line;
+
+        // --- deal with line breaks in quoted strings
+        for (auto quote = begin; quote < end; ++quote)
+        {
+            auto found = static_cast<const char*>(memchr (data + quote, '"', end - quote));
+            if (!found)
+                break;
+            quote = found - data;
+            if (quote == begin || data[quote - 1] != '\\')
+                inside_quotes = !inside_quotes;
+        }
+
+        if (inside_quotes || continued)
+        {
+            record.append (data + begin, end - begin);
+            if (inside_quotes)
+            {
+                record.push_back (' ');
+                continued = true;
+                continue;
+            }
+            tokenize_record (record.data(), record.size(), table, fields);
+            record.clear();
+            continued = false;
+        }
+        else
+            tokenize_record (data + begin, end - begin, table, fields);
+
+        auto num_fields = fields.size();
+        m_tokenized_contents.push_back (std::move (fields));
+        fields = StrVec();
+        fields.reserve (num_fields);
     }
 
     return 0;
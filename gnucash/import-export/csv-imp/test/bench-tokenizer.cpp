@@ -0,0 +1,114 @@
+/********************************************************************
+ * bench-tokenizer.cpp: compare the speed of the csv tokenizer with *
+ *                      the original boost::tokenizer based one.    *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, you can retrieve it from        *
+ * https://www.gnu.org/licenses/old-licenses/gpl-2.0.html            *
+ * or contact:                                                      *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+
+/* Usage: bench-csv-tokenizer [number of lines]
+ *
+ * Generates a bank export like csv file, tokenizes it with both the
+ * current GncCsvTokenizer and the original implementation and reports the
+ * time each one took. The results are also checked to be identical.
+ */
+
+#include "../gnc-tokenizer.hpp"
+#include "../gnc-tokenizer-csv.hpp"
+#include "legacy-csv-tokenizer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+extern "C" {
+#include <glib.h>
+#include <glib/gstdio.h>
+}
+
+static std::string
+make_contents (size_t lines)
+{
+    std::ostringstream out;
+    out << "Date,Num,Description,Notes,Account,Deposit,Withdrawal,Balance\n";
+    for (size_t i = 0; i < lines; i++)
+    {
+        out << (i % 28) + 1 << "/" << (i % 12) + 1 << "/2019,"
+            << i << ","
+            << "\"Payment " << i << ", ref \"\"" << i * 7 << "\"\"\","
+            << (i % 5 ? "" : "Some C:\\path\\like note") << ","
+            << "Expenses:Groceries,"
+            << (i % 3 ? "" : "\"1,") << (i % 3 ? "" : std::to_string (i % 1000))
+            << (i % 3 ? "" : ".00\"") << ","
+            << (i % 3 ? std::to_string (i % 977) + ".25" : "") << ","
+            << "\"" << i * 3 << ",000.00\"\n";
+    }
+    return out.str();
+}
+
+template <typename F> static double
+time_ms (F&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int
+main (int argc, char** argv)
+{
+    size_t lines = argc > 1 ? std::strtoul (argv[1], nullptr, 10) : 200000;
+    auto contents = make_contents (lines);
+
+    gchar *path = nullptr;
+    auto fd = g_file_open_tmp ("bench-csv-XXXXXX.csv", &path, nullptr);
+    if (fd < 0)
+    {
+        std::fprintf (stderr, "Can't create temporary file\n");
+        return 1;
+    }
+    close (fd);
+    std::ofstream (path) << contents;
+
+    auto tok = gnc_tokenizer_factory (GncImpFileFormat::CSV);
+    tok->load_file (path);
+    g_unlink (path);
+    g_free (path);
+
+    std::vector<StrVec> legacy;
+    auto legacy_ms = time_ms ([&]() { legacy = legacy_csv_tokenize (contents, ","); });
+    auto current_ms = time_ms ([&]() { tok->tokenize(); });
+
+    std::printf ("lines: %zu, bytes: %zu\n", lines, contents.size());
+    std::printf ("legacy tokenizer:  %10.2f ms\n", legacy_ms);
+    std::printf ("current tokenizer: %10.2f ms\n", current_ms);
+    std::printf ("speedup:           %10.2fx\n", legacy_ms / current_ms);
+
+    if (legacy != tok->get_tokens())
+    {
+        std::fprintf (stderr, "Tokenizers produced different results!\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+/********************************************************************
+ * legacy-csv-tokenizer.hpp: the original boost::tokenizer based    *
+ *                           csv tokenizer, kept as reference for   *
+ *                           the tokenizer tests and benchmark.     *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, you can retrieve it from        *
+ * https://www.gnu.org/licenses/old-licenses/gpl-2.0.html            *
+ * or contact:                                                      *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+
+#ifndef LEGACY_CSV_TOKENIZER_HPP
+#define LEGACY_CSV_TOKENIZER_HPP
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/tokenizer.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include "../gnc-tokenizer.hpp"
+
+/* This is GncCsvTokenizer::tokenize as it was before it was rewritten as a
+ * single pass state machine. The new tokenizer must produce exactly the same
+ * rows for any input, so this serves as the reference to compare against.
+ *
+ * The only deviation is in how the fields are collected: the original did
+ * vec.assign(tok.begin(), tok.end()), which for a line ending in a separator
+ * could keep stale fields from the previous line. boost's token_iterator
+ * considers the iterator before the trailing empty field equal to the one
+ * pointing at it, which confuses std::vector::assign when it reuses the
+ * existing elements.
+ */
+static inline std::vector<StrVec>
+legacy_csv_tokenize (const std::string& contents, const std::string& sep_str)
+{
+    using Tokenizer = boost::tokenizer< boost::escaped_list_separator<char>>;
+
+    boost::escaped_list_separator<char> sep("\\", sep_str, "\"");
+
+    std::vector<StrVec> tokenized_contents;
+    std::string line;
+    std::string buffer;
+
+    bool inside_quotes(false);
+    size_t last_quote(0);
+
+    std::istringstream in_stream(contents);
+
+    try
+    {
+        while (std::getline (in_stream, buffer))
+        {
+            // --- deal with line breaks in quoted strings
+            buffer = boost::trim_copy (buffer); // Removes trailing newline and spaces
+            last_quote = buffer.find_first_of('"');
+            while (last_quote != std::string::npos)
+            {
+                if (last_quote == 0) // Test separately because last_quote - 1 would be out of range
+                    inside_quotes = !inside_quotes;
+                else if (buffer[ last_quote - 1 ] != '\\')
+                    inside_quotes = !inside_quotes;
+
+                last_quote = buffer.find_first_of('"',last_quote+1);
+            }
+
+            line.append(buffer);
+            if (inside_quotes)
+            {
+                line.append(" ");
+                continue;
+            }
+            // ---
+
+            // Deal with backslashes that are not meant to be escapes
+            auto bs_pos = line.find ('\\');
+            while (bs_pos != std::string::npos)
+            {
+                if ((bs_pos == line.size()) ||
+                    (line.find_first_of ("\"\\n", bs_pos + 1) != bs_pos + 1))
+                    line = line.substr(0, bs_pos) + "\\\\" + line.substr(bs_pos + 1);
+                bs_pos += 2;
+                bs_pos = line.find ('\\', bs_pos);
+            }
+
+            // Deal with repeated " ("") in strings.
+            bs_pos = line.find ("\"\"");
+            while (bs_pos != std::string::npos)
+            {
+                if (!(((bs_pos == 0) ||
+                       (sep_str.find (line[bs_pos-1]) != std::string::npos))
+                      &&
+                      ((bs_pos + 2 >= line.length()) ||
+                       (sep_str.find (line[bs_pos+2]) != std::string::npos))))
+                    line.replace (bs_pos, 2, "\\\"");
+                bs_pos = line.find ("\"\"", bs_pos + 2);
+            }
+
+            Tokenizer tok(line, sep);
+            StrVec vec;
+            for (auto field = tok.begin(); field != tok.end(); ++field)
+                vec.push_back(*field);
+            tokenized_contents.push_back(vec);
+            line.clear();
+        }
+    }
+    catch (boost::escaped_list_error &e)
+    {
+        throw (std::range_error ("There was an error parsing the file."));
+    }
+
+    return tokenized_contents;
+}
+
+#endif
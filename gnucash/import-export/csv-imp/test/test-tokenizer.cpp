@@ -28,9 +28,11 @@
 #include "../gnc-tokenizer.hpp"
 #include "../gnc-tokenizer-csv.hpp"
 #include "../gnc-tokenizer-fw.hpp"
+#include "legacy-csv-tokenizer.hpp"
 #include <gtest/gtest.h>
 #include <iostream>
 #include <fstream>      // fstream
+#include <random>
 
 #include <string>
 #include <stdlib.h>     /* getenv */
@@ -69,6 +71,7 @@ protected:
     { tokenizer->m_utf8_contents = newcontents; }
     void test_gnc_tokenize_helper (const std::string& separators, tokenize_csv_test_data* test_data); // for csv tokenizer
     void test_gnc_tokenize_helper (tokenize_fw_test_data* test_data); // for csv tokenizer
+    void test_csv_against_legacy (const std::string& contents, const std::string& separators);
 
     std::unique_ptr<GncTokenizer> fw_tok;
     std::unique_ptr<GncTokenizer> csv_tok;
@@ -199,6 +202,57 @@ TEST_F (GncTokenizerTest, tokenize_semicolon_sep)
 }
 
 
+/* The csv tokenizer was rewritten as a single pass state machine. It should
+ * still produce exactly the same rows as the original boost::tokenizer based
+ * implementation, including for odd input like unbalanced quotes, stray
+ * backslashes and quoted line breaks.
+ */
+static const char *csv_legacy_cases [] = {
+        "",
+        "\n",
+        "a,b\n\n c ,d \n",
+        "\"multi\nline\",field\nnext,line",
+        "\"unterminated,quote\nrest",
+        "\"\",\"\"\"\",\"a\"\"b\",\"\"\"\"\"",
+        "trailing\\",
+        "back\\slash\\,\\n,\\\\,\\\"\",x",
+        "\\\"\",\\\"\"\"",
+        "a;b,c\td",
+        " \t padded , fields \t ",
+        NULL
+};
+
+void
+GncTokenizerTest::test_csv_against_legacy (const std::string& contents,
+                                           const std::string& separators)
+{
+    dynamic_cast<GncCsvTokenizer*>(csv_tok.get())->set_separators (separators);
+    set_utf8_contents (csv_tok, contents);
+    csv_tok->tokenize();
+    EXPECT_EQ (legacy_csv_tokenize (contents, separators), csv_tok->get_tokens())
+        << "Input: '" << contents << "', separators: '" << separators << "'";
+}
+
+TEST_F (GncTokenizerTest, tokenize_csv_matches_legacy)
+{
+    for (auto sep : { ",", ";", ",;\t", "\"", "\\" })
+        for (auto i = 0; csv_legacy_cases[i]; i++)
+            test_csv_against_legacy (csv_legacy_cases[i], sep);
+
+    /* Random input built from the characters the tokenizer cares about */
+    std::mt19937 gen (42);
+    const std::string alphabet ("ab ,;\"\\n\n\t");
+    std::uniform_int_distribution<size_t> pick (0, alphabet.size() - 1);
+    std::uniform_int_distribution<size_t> length (0, 24);
+    for (auto i = 0; i < 5000; i++)
+    {
+        std::string contents;
+        for (auto len = length (gen); len > 0; len--)
+            contents.push_back (alphabet[pick (gen)]);
+        test_csv_against_legacy (contents, i % 2 ? "," : ",;");
+    }
+}
+
 
 void
 GncTokenizerTest::test_gnc_tokenize_helper (tokenize_fw_test_data* test_data)
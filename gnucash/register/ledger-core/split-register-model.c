@@ -1466,25 +1466,28 @@ gnc_split_register_get_tshares_entry (VirtualLocation virt_loc,
     return xaccPrintAmount (total, gnc_split_amount_print_info (split, FALSE));
 }
 
+/* Like gnc_get_account_name_for_split_register, but the string belongs
+ * to the account. The transfer columns ask for it on every redraw. */
+static const char *
+split_register_peek_account_name (SplitRegister *reg, Account *account)
+{
+    if (reg->show_leaf_accounts)
+        return xaccAccountGetName (account);
+    return gnc_account_peek_full_name (account);
+}
+
 static const char *
 gnc_split_register_get_xfrm_entry (VirtualLocation virt_loc,
                                    gboolean translate,
                                    gboolean *conditionally_changed,
                                    gpointer user_data)
 {
-    static char *name = NULL;
-
     SplitRegister *reg = user_data;
     Split *split;
 
     split = gnc_split_register_get_split (reg, virt_loc.vcell_loc);
 
-    g_free (name);
-
-    name = gnc_get_account_name_for_split_register (xaccSplitGetAccount (split),
-               reg->show_leaf_accounts);
-
-    return name;
+    return split_register_peek_account_name (reg, xaccSplitGetAccount (split));
 }
 
 static char *
@@ -1508,8 +1511,6 @@ gnc_split_register_get_mxfrm_entry (VirtualLocation virt_loc,
                                     gboolean *conditionally_changed,
                                     gpointer user_data)
 {
-    static char *name = NULL;
-
     SplitRegister *reg = user_data;
     Split *split;
     Split *s;
@@ -1520,26 +1521,19 @@ gnc_split_register_get_mxfrm_entry (VirtualLocation virt_loc,
 
     s = xaccSplitGetOtherSplit (split);
 
-    g_free (name);
-
     if (s)
-        name = gnc_get_account_name_for_split_register (xaccSplitGetAccount (s),
-                   reg->show_leaf_accounts);
-    else
-    {
-        /* For multi-split transactions and stock splits,
-         * use a special value. */
-        s = xaccTransGetSplit (xaccSplitGetParent(split), 1);
+        return split_register_peek_account_name (reg, xaccSplitGetAccount (s));
 
-        if (s)
-            name = g_strdup (SPLIT_TRANS_STR);
-        else if (g_strcmp0 ("stock-split", xaccSplitGetType (split)) == 0)
-            name = g_strdup (STOCK_SPLIT_STR);
-        else
-            name = g_strdup ("");
-    }
+    /* For multi-split transactions and stock splits,
+     * use a special value. */
+    s = xaccTransGetSplit (xaccSplitGetParent(split), 1);
 
-    return name;
+    if (s)
+        return SPLIT_TRANS_STR;
+    else if (g_strcmp0 ("stock-split", xaccSplitGetType (split)) == 0)
+        return STOCK_SPLIT_STR;
+    else
+        return "";
 }
 
 static char *
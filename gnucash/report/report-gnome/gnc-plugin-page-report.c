@@ -125,6 +125,10 @@ typedef struct GncPluginPageReportPrivate
     /* The page is in the process of reloading the html */
     gboolean	reloading;
 
+    /* The engine changed while the page was hidden; check whether the
+     * report is stale when it is shown again. */
+    gboolean	changed_while_hidden;
+
     /// the gnc_html abstraction this PluginPage contains
 //        gnc_html *html;
     GncHtml *html;
@@ -153,6 +157,7 @@ static GncPluginPage *gnc_plugin_page_report_recreate_page (GtkWidget *window, G
 static void gnc_plugin_page_report_name_changed (GncPluginPage *page, const gchar *name);
 static void gnc_plugin_page_report_update_edit_menu (GncPluginPage *page, gboolean hide);
 static gboolean gnc_plugin_page_report_finish_pending (GncPluginPage *page);
+static void gnc_plugin_page_report_focus (GncPluginPage *page, gboolean on_current_page);
 
 static int gnc_plugin_page_report_check_urltype(URLType t);
 //static void gnc_plugin_page_report_load_cb(gnc_html * html, URLType type,
@@ -160,6 +165,8 @@ static void gnc_plugin_page_report_load_cb(GncHtml * html, URLType type,
         const gchar * location, const gchar * label,
         gpointer data);
 static void gnc_plugin_page_report_refresh (gpointer data);
+static void gnc_plugin_page_report_refresh_handler (GHashTable *changes, gpointer user_data);
+static void gnc_plugin_page_report_reload (GncPluginPageReport *report);
 static void gnc_plugin_page_report_set_fwd_button(GncPluginPageReport * page, int enabled);
 static void gnc_plugin_page_report_set_back_button(GncPluginPageReport * page, int enabled);
 static void gnc_plugin_page_report_history_destroy_cb(gnc_html_history_node * node, gpointer user_data);
@@ -278,6 +285,7 @@ gnc_plugin_page_report_class_init (GncPluginPageReportClass *klass)
     gnc_plugin_page_class->page_name_changed = gnc_plugin_page_report_name_changed;
     gnc_plugin_page_class->update_edit_menu_actions = gnc_plugin_page_report_update_edit_menu;
     gnc_plugin_page_class->finish_pending   = gnc_plugin_page_report_finish_pending;
+    gnc_plugin_page_class->focus_page      = gnc_plugin_page_report_focus;
     gnc_plugin_page_class->focus_page_function = gnc_plugin_page_report_focus_widget;
 
     // create the "reportId" property
@@ -436,10 +444,18 @@ gnc_plugin_page_report_create_widget( GncPluginPage *page )
                       gnc_html_get_widget(priv->html));
 
     priv->component_manager_id =
-        gnc_register_gui_component(WINDOW_REPORT_CM_CLASS, NULL,
+        gnc_register_gui_component(WINDOW_REPORT_CM_CLASS,
+                                   gnc_plugin_page_report_refresh_handler,
                                    close_handler, page);
     gnc_gui_component_set_session(priv->component_manager_id,
                                   gnc_get_current_session());
+    /* The report cache decides whether a change concerns this report. */
+    gnc_gui_component_watch_entity_type(priv->component_manager_id,
+                                        GNC_ID_ACCOUNT, QOF_EVENT_ALL);
+    gnc_gui_component_watch_entity_type(priv->component_manager_id,
+                                        GNC_ID_TRANS, QOF_EVENT_ALL);
+    gnc_gui_component_watch_entity_type(priv->component_manager_id,
+                                        GNC_ID_PRICE, QOF_EVENT_ALL);
 
     gnc_html_set_urltype_cb(priv->html, gnc_plugin_page_report_check_urltype);
     gnc_html_set_load_cb(priv->html, gnc_plugin_page_report_load_cb, report);
@@ -753,6 +769,66 @@ gnc_plugin_page_report_refresh(gpointer data)
     return;
 }
 
+/** Rerun the report if the engine changed something it shows. The
+ *  report cache knows what the report depends on, so reports showing
+ *  unrelated accounts stay as they are. */
+static void
+gnc_plugin_page_report_reload_if_stale (GncPluginPageReport *report)
+{
+    GncPluginPageReportPrivate *priv = GNC_PLUGIN_PAGE_REPORT_GET_PRIVATE(report);
+    SCM stale_report;
+
+    if (priv->cur_report == SCM_BOOL_F || priv->reloading)
+        return;
+
+    stale_report = scm_c_eval_string("gnc:report-stale?");
+    if (scm_is_false(scm_call_1(stale_report, priv->cur_report)))
+        return;
+
+    DEBUG( "inputs of report changed, reloading" );
+    gnc_plugin_page_report_reload(report);
+}
+
+/** The component manager calls this after any account, transaction or
+ *  price change. Only the page on view is rerun right away; the others
+ *  wait until they are shown, so a commit doesn't rerun every open
+ *  report. */
+static void
+gnc_plugin_page_report_refresh_handler (GHashTable *changes, gpointer user_data)
+{
+    GncPluginPageReport *report = GNC_PLUGIN_PAGE_REPORT(user_data);
+    GncPluginPageReportPrivate *priv = GNC_PLUGIN_PAGE_REPORT_GET_PRIVATE(report);
+    GtkWidget *window = GNC_PLUGIN_PAGE(report)->window;
+
+    if (!window)
+        return;
+
+    if (GNC_IS_MAIN_WINDOW(window) &&
+        gnc_main_window_get_current_page(GNC_MAIN_WINDOW(window)) !=
+        GNC_PLUGIN_PAGE(report))
+    {
+        priv->changed_while_hidden = TRUE;
+        return;
+    }
+
+    gnc_plugin_page_report_reload_if_stale(report);
+}
+
+/* Catch up with the changes made while the page was hidden. */
+static void
+gnc_plugin_page_report_focus (GncPluginPage *page, gboolean on_current_page)
+{
+    GncPluginPageReportPrivate *priv = GNC_PLUGIN_PAGE_REPORT_GET_PRIVATE(page);
+
+    if (on_current_page && priv->changed_while_hidden)
+    {
+        priv->changed_while_hidden = FALSE;
+        gnc_plugin_page_report_reload_if_stale(GNC_PLUGIN_PAGE_REPORT(page));
+    }
+
+    GNC_PLUGIN_PAGE_CLASS(parent_class)->focus_page(page, on_current_page);
+}
+
 static void
 gnc_plugin_page_report_destroy_widget(GncPluginPage *plugin_page)
 {
@@ -1381,16 +1457,30 @@ gnc_plugin_page_report_back_cb( GtkAction *action, GncPluginPageReport *report )
 static void
 gnc_plugin_page_report_reload_cb( GtkAction *action, GncPluginPageReport *report )
 {
-    GncPluginPage *page;
     GncPluginPageReportPrivate *priv;
-    SCM dirty_report;
+    SCM remove_cached;
 
     DEBUG( "reload" );
-    page = GNC_PLUGIN_PAGE(report);
     priv = GNC_PLUGIN_PAGE_REPORT_GET_PRIVATE(report);
     if (priv->cur_report == SCM_BOOL_F)
         return;
 
+    /* The user asked for a fresh run, not the cached html. */
+    remove_cached = scm_c_eval_string("gnc:report-cache-remove!");
+    scm_call_1(remove_cached, priv->cur_report);
+    gnc_plugin_page_report_reload(report);
+}
+
+static void
+gnc_plugin_page_report_reload (GncPluginPageReport *report)
+{
+    GncPluginPage *page;
+    GncPluginPageReportPrivate *priv;
+    SCM dirty_report;
+
+    page = GNC_PLUGIN_PAGE(report);
+    priv = GNC_PLUGIN_PAGE_REPORT_GET_PRIVATE(report);
+
     DEBUG( "reload-redraw" );
     dirty_report = scm_c_eval_string("gnc:report-set-dirty?!");
     scm_call_2(dirty_report, priv->cur_report, SCM_BOOL_T);
@@ -37,10 +37,24 @@
 #include <errno.h>
 #include <fcntl.h>
 
+#include "Account.h"
+#include "SX-book.h"
+#include "SchedXaction.h"
+#include "Transaction.h"
 #include "gnc-filepath-utils.h"
 #include "gnc-guile-utils.h"
 #include "gnc-report.h"
 #include "gnc-engine.h"
+#include "gnc-hooks.h"
+#include "gnc-lot.h"
+#include "gnc-pricedb.h"
+#include "gnc-session.h"
+#include "gnc-uri-utils.h"
+#include "gncAddress.h"
+#include "gncEntry.h"
+#include "gncInvoice.h"
+#include "gncOrder.h"
+#include "gncOwner.h"
 
 static QofLogModule log_module = GNC_MOD_GUI;
 
@@ -155,13 +169,16 @@ gnc_run_report (gint report_id, char ** data)
 {
     SCM scm_text;
     gchar *str;
+    gint64 trace_start;
 
     g_return_val_if_fail (data != NULL, FALSE);
     *data = NULL;
 
+    trace_start = qof_trace_begin ();
     str = g_strdup_printf("(gnc:report-run %d)", report_id);
     scm_text = gfec_eval_string(str, error_handler);
     g_free(str);
+    qof_trace_end (log_module, "gnc_run_report", trace_start);
 
     if (scm_text == SCM_UNDEFINED || !scm_is_string (scm_text))
         return FALSE;
@@ -189,6 +206,48 @@ gnc_run_report_id_string (const char * id_string, char **data)
     return gnc_run_report (report_id, data);
 }
 
+gboolean
+gnc_run_report_to_file (const gchar *template_guid, gchar **overrides,
+                        const gchar *filename)
+{
+    SCM run_to_file = scm_c_eval_string("gnc:report-run-to-file");
+    SCM scm_overrides = SCM_EOL;
+    SCM result;
+    gchar **override;
+    gint64 trace_start;
+
+    g_return_val_if_fail (template_guid != NULL, FALSE);
+    g_return_val_if_fail (filename != NULL, FALSE);
+
+    for (override = overrides; override && *override; override++)
+    {
+        /* "Section/Name=expression" */
+        gchar *slash = strchr (*override, '/');
+        gchar *equals = slash ? strchr (slash, '=') : NULL;
+
+        if (!equals)
+        {
+            g_warning("Ignoring malformed report option override %s", *override);
+            continue;
+        }
+        scm_overrides =
+            scm_cons (scm_list_3 (scm_from_utf8_stringn (*override, slash - *override),
+                                  scm_from_utf8_stringn (slash + 1, equals - slash - 1),
+                                  scm_from_utf8_string (equals + 1)),
+                      scm_overrides);
+    }
+
+    trace_start = qof_trace_begin ();
+    result = gfec_apply (run_to_file,
+                         scm_list_3 (scm_from_utf8_string (template_guid),
+                                     scm_reverse (scm_overrides),
+                                     scm_from_utf8_string (filename)),
+                         error_handler);
+    qof_trace_end (log_module, "gnc_run_report_to_file", trace_start);
+
+    return scm_is_true (result) && result != SCM_UNDEFINED;
+}
+
 gchar*
 gnc_report_name( SCM report )
 {
@@ -323,3 +382,742 @@ gnc_saved_reports_write_to_file (const gchar* report_def, gboolean overwrite)
 
     return success;
 }
+
+/* Report cache change tracking.
+ *
+ * The report cache in report.scm keeps rendered reports until one of
+ * their inputs changes. Every engine event advances the generation,
+ * and the event handler records it for each instance the event
+ * concerns: an account for its splits and lots, the commodity and
+ * currency of a price, an invoice with its owner and posted account,
+ * an owner with the accounts it posts to, and so on. Changes to the
+ * account tree, or to how an account is shown, have a generation of
+ * their own, as reports show the names of accounts they didn't read
+ * in transfer columns and subaccount rows.
+ *
+ * While a report runs, the engine passes what it reads to
+ * gnc_report_cache_read_cb(): accounts whose splits or balances are
+ * used, the instances queries are restricted to, and the commodities
+ * prices are looked up for. A query restricted to nothing makes the
+ * report depend on the whole book. A cache entry remembers these and
+ * the generation it was rendered at, and asks
+ * gnc_report_cache_inputs_changed() whether any of them moved past
+ * it. */
+
+typedef struct
+{
+    GHashTable *guids;
+    gboolean whole_book;
+    gboolean uses_prices;
+} GncReportCacheReads;
+
+static gint    cache_event_handler_id = 0;
+static guint   cache_suppressed_count = 0;
+static gint64  cache_generation = 0;
+static gint64  cache_change_generation = 0;
+static gint64  cache_structure_generation = 0;
+static gint64  cache_price_generation = 0;
+static GHashTable *cache_instance_generations = NULL;
+static GHashTable *cache_account_signatures = NULL;
+/* The reads of the reports being run, innermost first. */
+static GSList *cache_reads = NULL;
+
+static void
+gnc_report_cache_mark (const GncGUID *guid)
+{
+    gint64 *generation;
+
+    if (!guid)
+        return;
+    generation = g_hash_table_lookup (cache_instance_generations, guid);
+    if (!generation)
+    {
+        generation = g_new (gint64, 1);
+        g_hash_table_insert (cache_instance_generations, guid_copy (guid),
+                             generation);
+    }
+    *generation = cache_generation;
+    cache_change_generation = cache_generation;
+}
+
+static void
+gnc_report_cache_mark_structure (void)
+{
+    cache_change_generation = cache_generation;
+    cache_structure_generation = cache_generation;
+}
+
+/* Account events mostly come from splits moving in and out of it, and
+ * look the same as the one from an edit of the account itself. The
+ * properties a report could show for it tell the two apart. */
+static gchar *
+gnc_report_cache_account_signature (Account *acc)
+{
+    gnc_commodity *comm = xaccAccountGetCommodity (acc);
+    Account *parent = gnc_account_get_parent (acc);
+    gchar *parent_guid = parent ?
+        guid_to_string (qof_instance_get_guid (parent)) : NULL;
+    gchar *signature;
+
+    signature = g_strdup_printf ("%s\n%s\n%s\n%s\n%d\n%s\n%d%d",
+                                 xaccAccountGetName (acc),
+                                 parent_guid ? parent_guid : "",
+                                 xaccAccountGetCode (acc),
+                                 xaccAccountGetDescription (acc),
+                                 xaccAccountGetType (acc),
+                                 comm ? gnc_commodity_get_unique_name (comm) : "",
+                                 xaccAccountGetHidden (acc),
+                                 xaccAccountGetPlaceholder (acc));
+    g_free (parent_guid);
+    return signature;
+}
+
+static void
+gnc_report_cache_seed_account (Account *acc, gpointer data)
+{
+    g_hash_table_replace (cache_account_signatures,
+                          guid_copy (qof_instance_get_guid (acc)),
+                          gnc_report_cache_account_signature (acc));
+}
+
+/* Take down how every account of the book looks, so that the first
+ * event on one can tell whether it was renamed. */
+static void
+gnc_report_cache_seed_book (QofBook *book)
+{
+    Account *root = book ? gnc_book_get_root_account (book) : NULL;
+
+    g_hash_table_remove_all (cache_account_signatures);
+    if (root)
+        gnc_account_foreach_descendant (root, gnc_report_cache_seed_account,
+                                        NULL);
+}
+
+/* Whether the account looks different than it did at its last event. */
+static gboolean
+gnc_report_cache_account_reshown (Account *acc)
+{
+    const GncGUID *guid = qof_instance_get_guid (acc);
+    gchar *signature = gnc_report_cache_account_signature (acc);
+    const gchar *old = g_hash_table_lookup (cache_account_signatures, guid);
+    gboolean changed = old && g_strcmp0 (old, signature) != 0;
+
+    if (!old || changed)
+        g_hash_table_insert (cache_account_signatures, guid_copy (guid),
+                             signature);
+    else
+        g_free (signature);
+    return changed;
+}
+
+typedef gboolean (*GncReportCacheAccountMatch) (Account *acc, gpointer data);
+
+typedef struct
+{
+    GncReportCacheAccountMatch match;
+    gpointer data;
+} GncReportCacheMarkMatching;
+
+static void
+gnc_report_cache_mark_if_matching (Account *acc, gpointer data)
+{
+    GncReportCacheMarkMatching *mark = data;
+
+    if (mark->match (acc, mark->data))
+        gnc_report_cache_mark (qof_instance_get_guid (acc));
+}
+
+static void
+gnc_report_cache_mark_accounts (QofInstance *inst,
+                                GncReportCacheAccountMatch match,
+                                gpointer data)
+{
+    Account *root = gnc_book_get_root_account (qof_instance_get_book (inst));
+    GncReportCacheMarkMatching mark = { match, data };
+
+    if (root)
+        gnc_account_foreach_descendant (root, gnc_report_cache_mark_if_matching,
+                                        &mark);
+}
+
+static gboolean
+gnc_report_cache_account_in_commodity (Account *acc, gpointer data)
+{
+    return xaccAccountGetCommodity (acc) == data;
+}
+
+static gboolean
+gnc_report_cache_account_of_types (Account *acc, gpointer data)
+{
+    return g_list_find (data, GINT_TO_POINTER (xaccAccountGetType (acc))) != NULL;
+}
+
+/* An owner's name and terms show in the reports of the receivable or
+ * payable accounts its invoices post to. */
+static void
+gnc_report_cache_mark_owner (const GncOwner *owner)
+{
+    const GncOwner *end_owner = gncOwnerGetEndOwner (owner);
+    QofInstance *inst = end_owner ? qofOwnerGetOwner (end_owner) : NULL;
+    GList *types;
+
+    if (!inst)
+        return;
+    gnc_report_cache_mark (gncOwnerGetGUID (owner));
+    gnc_report_cache_mark (gncOwnerGetGUID (end_owner));
+    types = gncOwnerGetAccountTypesList (end_owner);
+    gnc_report_cache_mark_accounts (inst, gnc_report_cache_account_of_types,
+                                    types);
+    g_list_free (types);
+}
+
+static void
+gnc_report_cache_mark_invoice (GncInvoice *invoice)
+{
+    Account *posted;
+
+    if (!invoice)
+        return;
+    posted = gncInvoiceGetPostedAcc (invoice);
+    gnc_report_cache_mark (qof_instance_get_guid (invoice));
+    gnc_report_cache_mark (gncOwnerGetGUID (gncInvoiceGetOwner (invoice)));
+    if (posted)
+        gnc_report_cache_mark (qof_instance_get_guid (posted));
+}
+
+/* A scheduled transaction shows in projections of the accounts its
+ * template splits post to. Its template account is named after it. */
+static void
+gnc_report_cache_mark_sx (SchedXaction *sx)
+{
+    QofBook *book = qof_instance_get_book (sx);
+    Account *template_root = gnc_book_get_template_root (book);
+    gchar *guid_str = guid_to_string (qof_instance_get_guid (sx));
+    Account *template_acc = template_root ?
+        gnc_account_lookup_by_name (template_root, guid_str) : NULL;
+    GList *node;
+
+    g_free (guid_str);
+    gnc_report_cache_mark (qof_instance_get_guid (sx));
+    if (!template_acc)
+        return;
+    for (node = xaccAccountGetSplitList (template_acc); node; node = node->next)
+    {
+        GncGUID *acc_guid = NULL;
+
+        qof_instance_get (QOF_INSTANCE (node->data), "sx-account", &acc_guid,
+                          NULL);
+        gnc_report_cache_mark (acc_guid);
+        guid_free (acc_guid);
+    }
+}
+
+static void
+gnc_report_cache_event_handler (QofInstance *entity, QofEventId event_type,
+                                gpointer user_data, gpointer event_data)
+{
+    cache_generation++;
+
+    if (QOF_CHECK_TYPE (entity, GNC_ID_ACCOUNT))
+    {
+        Account *acc = GNC_ACCOUNT (entity);
+
+        if (event_type & (QOF_EVENT_CREATE | QOF_EVENT_DESTROY |
+                          QOF_EVENT_ADD | QOF_EVENT_REMOVE))
+        {
+            if (event_type & QOF_EVENT_DESTROY)
+                g_hash_table_remove (cache_account_signatures,
+                                     qof_instance_get_guid (acc));
+            else
+                gnc_report_cache_seed_account (acc, NULL);
+            gnc_report_cache_mark_structure ();
+        }
+        else if ((event_type & QOF_EVENT_MODIFY) &&
+                 gnc_report_cache_account_reshown (acc))
+            gnc_report_cache_mark_structure ();
+        else
+            gnc_report_cache_mark (qof_instance_get_guid (acc));
+    }
+    /* Splits and transactions raise events on their accounts. */
+    else if (QOF_CHECK_TYPE (entity, GNC_ID_SPLIT) ||
+             QOF_CHECK_TYPE (entity, GNC_ID_TRANS))
+        return;
+    else if (QOF_CHECK_TYPE (entity, GNC_ID_LOT))
+    {
+        Account *acc = gnc_lot_get_account (GNC_LOT (entity));
+
+        if (acc)
+            gnc_report_cache_mark (qof_instance_get_guid (acc));
+        else
+            gnc_report_cache_mark_structure ();
+    }
+    else if (QOF_CHECK_TYPE (entity, GNC_ID_PRICE))
+    {
+        GNCPrice *price = GNC_PRICE (entity);
+        gnc_commodity *comm = gnc_price_get_commodity (price);
+        gnc_commodity *curr = gnc_price_get_currency (price);
+
+        if (comm && curr)
+        {
+            gnc_report_cache_mark (qof_instance_get_guid (comm));
+            gnc_report_cache_mark (qof_instance_get_guid (curr));
+        }
+        else
+            cache_price_generation = cache_change_generation = cache_generation;
+    }
+    else if (QOF_CHECK_TYPE (entity, GNC_ID_PRICEDB))
+        cache_price_generation = cache_change_generation = cache_generation;
+    else if (QOF_CHECK_TYPE (entity, GNC_ID_COMMODITY))
+    {
+        gnc_report_cache_mark (qof_instance_get_guid (entity));
+        gnc_report_cache_mark_accounts (entity,
+                                        gnc_report_cache_account_in_commodity,
+                                        entity);
+    }
+    else if (QOF_CHECK_TYPE (entity, GNC_ID_INVOICE))
+        gnc_report_cache_mark_invoice (GNC_INVOICE (entity));
+    else if (QOF_CHECK_TYPE (entity, GNC_ID_ENTRY))
+    {
+        gnc_report_cache_mark_invoice (gncEntryGetInvoice (GNC_ENTRY (entity)));
+        gnc_report_cache_mark_invoice (gncEntryGetBill (GNC_ENTRY (entity)));
+    }
+    else if (QOF_CHECK_TYPE (entity, GNC_ID_CUSTOMER) ||
+             QOF_CHECK_TYPE (entity, GNC_ID_VENDOR) ||
+             QOF_CHECK_TYPE (entity, GNC_ID_EMPLOYEE) ||
+             QOF_CHECK_TYPE (entity, GNC_ID_JOB))
+    {
+        GncOwner owner;
+
+        qofOwnerSetEntity (&owner, entity);
+        gnc_report_cache_mark_owner (&owner);
+    }
+    else if (QOF_CHECK_TYPE (entity, GNC_ID_BUDGET))
+        gnc_report_cache_mark (qof_instance_get_guid (entity));
+    else if (QOF_CHECK_TYPE (entity, GNC_ID_SCHEDXACTION))
+        gnc_report_cache_mark_sx (GNC_SX (entity));
+    /* Nothing reports read: an address raises an event on its owner,
+     * commodities and scheduled transactions raise their own events,
+     * and no report shows orders. */
+    else if (QOF_CHECK_TYPE (entity, GNC_ID_ADDRESS) ||
+             QOF_CHECK_TYPE (entity, GNC_ID_COMMODITY_NAMESPACE) ||
+             QOF_CHECK_TYPE (entity, GNC_ID_COMMODITY_TABLE) ||
+             QOF_CHECK_TYPE (entity, GNC_ID_SXES) ||
+             QOF_CHECK_TYPE (entity, GNC_ID_SXTG) ||
+             QOF_CHECK_TYPE (entity, GNC_ID_SXTT) ||
+             QOF_CHECK_TYPE (entity, GNC_ID_ORDER))
+        return;
+    /* The book's options, and the tax tables and billing terms every
+     * unposted invoice may use, could change anything. */
+    else
+        gnc_report_cache_mark_structure ();
+}
+
+/* Events dropped while they were suspended could have touched
+ * anything, so treat them as a change to everything. */
+static void
+gnc_report_cache_check_suppressed (void)
+{
+    guint suppressed = qof_event_get_suppressed_count ();
+
+    if (suppressed == cache_suppressed_count)
+        return;
+    cache_suppressed_count = suppressed;
+    cache_generation++;
+    gnc_report_cache_mark_structure ();
+    cache_price_generation = cache_generation;
+}
+
+static void
+gnc_report_cache_add_read (const GncGUID *guid)
+{
+    GSList *node;
+
+    if (!guid)
+        return;
+    for (node = cache_reads; node; node = node->next)
+    {
+        GncReportCacheReads *reads = node->data;
+
+        if (!g_hash_table_contains (reads->guids, guid))
+            g_hash_table_add (reads->guids, guid_copy (guid));
+    }
+}
+
+static void
+gnc_report_cache_read_cb (QofInstance *inst, gpointer user_data)
+{
+    GSList *node;
+
+    if (QOF_IS_BOOK (inst))
+    {
+        for (node = cache_reads; node; node = node->next)
+            ((GncReportCacheReads*)node->data)->whole_book = TRUE;
+    }
+    else if (QOF_CHECK_TYPE (inst, GNC_ID_COMMODITY))
+    {
+        for (node = cache_reads; node; node = node->next)
+            ((GncReportCacheReads*)node->data)->uses_prices = TRUE;
+        gnc_report_cache_add_read (qof_instance_get_guid (inst));
+    }
+    else if (QOF_CHECK_TYPE (inst, GNC_ID_SPLIT))
+    {
+        Account *acc = xaccSplitGetAccount (GNC_SPLIT (inst));
+        gnc_report_cache_add_read (acc ? qof_instance_get_guid (acc) : NULL);
+    }
+    else if (QOF_CHECK_TYPE (inst, GNC_ID_TRANS))
+    {
+        GList *split;
+
+        for (split = xaccTransGetSplitList (GNC_TRANS (inst)); split;
+             split = split->next)
+        {
+            Account *acc = xaccSplitGetAccount (split->data);
+            gnc_report_cache_add_read (acc ? qof_instance_get_guid (acc) : NULL);
+        }
+    }
+    else if (QOF_CHECK_TYPE (inst, GNC_ID_LOT))
+    {
+        Account *acc = gnc_lot_get_account (GNC_LOT (inst));
+        gnc_report_cache_add_read (acc ? qof_instance_get_guid (acc) : NULL);
+    }
+    else
+        gnc_report_cache_add_read (qof_instance_get_guid (inst));
+}
+
+/* Append the size and time of @a path to @a stamp, or zeros if there
+ * is no such file. */
+static void
+gnc_report_cache_stamp_file (GString *stamp, const gchar *path)
+{
+    GStatBuf st;
+
+    if (g_stat (path, &st) != 0)
+        memset (&st, 0, sizeof (st));
+    g_string_append_printf (stamp, " %" G_GINT64_FORMAT " %" G_GINT64_FORMAT,
+                            (gint64)st.st_mtime, (gint64)st.st_size);
+}
+
+/* The first line of a persisted cache index: the book's guid and the
+ * size and time of its data file and of the journal an incremental
+ * save appends to. NULL if the book has unsaved changes, is still
+ * being saved or does not live in a file, as then there is no way to
+ * tell whether a later session sees the same data. */
+static gchar *
+gnc_report_cache_session_stamp (QofSession *session)
+{
+    QofBook *book = qof_session_get_book (session);
+    const gchar *url = qof_session_get_url (session);
+    gchar *path, *journal, *guid_str;
+    GString *stamp;
+    GStatBuf st;
+
+    if (!book || !url || qof_book_session_not_saved (book) ||
+        qof_session_save_in_progress (session) || !gnc_uri_is_file_uri (url))
+        return NULL;
+
+    path = gnc_uri_get_path (url);
+    if (g_stat (path, &st) != 0)
+    {
+        g_free (path);
+        return NULL;
+    }
+    guid_str = guid_to_string (qof_instance_get_guid (book));
+    stamp = g_string_new (guid_str);
+    gnc_report_cache_stamp_file (stamp, path);
+    journal = g_strconcat (path, ".journal", NULL);
+    gnc_report_cache_stamp_file (stamp, journal);
+
+    g_free (journal);
+    g_free (guid_str);
+    g_free (path);
+    return g_string_free (stamp, FALSE);
+}
+
+/* The directory holding the book's cache: an index naming the entries
+ * valid for the stamp it starts with, and a file per entry. */
+static gchar *
+gnc_report_cache_dir (QofSession *session)
+{
+    QofBook *book = qof_session_get_book (session);
+    gchar *guid_str = guid_to_string (qof_instance_get_guid (book));
+    gchar *dirname = g_strconcat (REPORT_CACHE_FILE_PREFIX, guid_str, NULL);
+    gchar *dir = gnc_build_userdata_path (dirname);
+
+    g_free (dirname);
+    g_free (guid_str);
+    return dir;
+}
+
+/* Write the entries rendered since the last save and an index of all
+ * current ones, and drop the files of the others. An entry's file is
+ * named after the checksum of its key, so the html of reports that
+ * didn't change is not written again. */
+static void
+gnc_report_cache_save (QofSession *session)
+{
+    gchar *stamp = gnc_report_cache_session_stamp (session);
+    SCM serialize = scm_c_eval_string ("gnc:report-cache-serialize");
+    GHashTable *names;
+    GString *index;
+    gchar *dir, *path;
+    GDir *gdir;
+    const gchar *name;
+    SCM entries;
+
+    if (!stamp)
+        return;
+
+    gnc_report_cache_check_suppressed ();
+    dir = gnc_report_cache_dir (session);
+    /* An earlier version kept the whole cache in one file there. */
+    if (g_file_test (dir, G_FILE_TEST_IS_REGULAR))
+        g_unlink (dir);
+    if (g_mkdir_with_parents (dir, 0700) != 0)
+    {
+        PWARN ("Cannot create report cache %s: %s", dir, strerror (errno));
+        g_free (dir);
+        g_free (stamp);
+        return;
+    }
+
+    DEBUG ("writing report cache to %s", dir);
+    names = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    index = g_string_new (stamp);
+    g_string_append_c (index, '\n');
+    for (entries = scm_call_0 (serialize); scm_is_pair (entries);
+         entries = SCM_CDR (entries))
+    {
+        SCM entry = SCM_CAR (entries);
+        gchar *key = gnc_scm_to_utf8_string (SCM_CAR (entry));
+        gchar *entry_name = g_compute_checksum_for_string (G_CHECKSUM_SHA1,
+                                                           key, -1);
+        gboolean ok = TRUE;
+
+        g_free (key);
+        path = g_build_filename (dir, entry_name, NULL);
+        if (scm_is_string (SCM_CDR (entry)))
+        {
+            gchar *contents = gnc_scm_to_utf8_string (SCM_CDR (entry));
+            ok = gnc_saved_reports_write_internal (path, contents, TRUE);
+            g_free (contents);
+        }
+        else
+            ok = g_file_test (path, G_FILE_TEST_EXISTS);
+        g_free (path);
+
+        if (ok)
+        {
+            g_string_append_printf (index, "%s\n", entry_name);
+            g_hash_table_add (names, entry_name);
+        }
+        else
+            g_free (entry_name);
+    }
+    path = g_build_filename (dir, "index", NULL);
+    gnc_saved_reports_write_internal (path, index->str, TRUE);
+    g_free (path);
+
+    gdir = g_dir_open (dir, 0, NULL);
+    while (gdir && (name = g_dir_read_name (gdir)))
+    {
+        if (strcmp (name, "index") == 0 || g_hash_table_contains (names, name))
+            continue;
+        path = g_build_filename (dir, name, NULL);
+        g_unlink (path);
+        g_free (path);
+    }
+    if (gdir)
+        g_dir_close (gdir);
+
+    g_hash_table_destroy (names);
+    g_string_free (index, TRUE);
+    g_free (dir);
+    g_free (stamp);
+}
+
+static void
+gnc_report_cache_book_saved_cb (gpointer data, gpointer user_data)
+{
+    gnc_report_cache_save ((QofSession*)data);
+}
+
+static void
+gnc_report_cache_book_closed_cb (gpointer data, gpointer user_data)
+{
+    gnc_report_cache_save ((QofSession*)data);
+    scm_call_0 (scm_c_eval_string ("gnc:report-cache-flush"));
+    g_hash_table_remove_all (cache_instance_generations);
+    g_hash_table_remove_all (cache_account_signatures);
+}
+
+static void
+gnc_report_cache_book_opened_cb (gpointer data, gpointer user_data)
+{
+    gnc_report_cache_seed_book (qof_session_get_book ((QofSession*)data));
+}
+
+void
+gnc_report_cache_init (void)
+{
+    if (cache_event_handler_id)
+        return;
+
+    cache_instance_generations =
+        g_hash_table_new_full (guid_hash_to_guint, guid_g_hash_table_equal,
+                               (GDestroyNotify)guid_free, g_free);
+    cache_account_signatures =
+        g_hash_table_new_full (guid_hash_to_guint, guid_g_hash_table_equal,
+                               (GDestroyNotify)guid_free, g_free);
+    cache_suppressed_count = qof_event_get_suppressed_count ();
+    cache_event_handler_id =
+        qof_event_register_handler (gnc_report_cache_event_handler, NULL);
+    if (gnc_current_session_exist ())
+        gnc_report_cache_seed_book (qof_session_get_book
+                                    (gnc_get_current_session ()));
+
+    gnc_hook_add_dangler (HOOK_BOOK_OPENED, gnc_report_cache_book_opened_cb,
+                          NULL);
+    gnc_hook_add_dangler (HOOK_BOOK_SAVED, gnc_report_cache_book_saved_cb,
+                          NULL);
+    gnc_hook_add_dangler (HOOK_BOOK_CLOSED, gnc_report_cache_book_closed_cb,
+                          NULL);
+}
+
+gint64
+gnc_report_cache_generation (void)
+{
+    gnc_report_cache_init ();
+    gnc_report_cache_check_suppressed ();
+    return cache_generation;
+}
+
+void
+gnc_report_cache_begin_reads (void)
+{
+    GncReportCacheReads *reads = g_new0 (GncReportCacheReads, 1);
+
+    gnc_report_cache_init ();
+    reads->guids = g_hash_table_new_full (guid_hash_to_guint,
+                                          guid_g_hash_table_equal,
+                                          (GDestroyNotify)guid_free, NULL);
+    if (!cache_reads)
+        qof_instance_set_read_func (gnc_report_cache_read_cb, NULL);
+    cache_reads = g_slist_prepend (cache_reads, reads);
+}
+
+static void
+gnc_report_cache_prepend_guid (gpointer key, gpointer value, gpointer data)
+{
+    SCM *list = data;
+    gchar *guid_str = guid_to_string (key);
+
+    *list = scm_cons (scm_from_utf8_string (guid_str), *list);
+    g_free (guid_str);
+}
+
+SCM
+gnc_report_cache_end_reads (void)
+{
+    GncReportCacheReads *reads;
+    SCM guids = SCM_EOL;
+    SCM result;
+
+    g_return_val_if_fail (cache_reads, scm_cons (SCM_BOOL_T, SCM_BOOL_T));
+
+    reads = cache_reads->data;
+    cache_reads = g_slist_delete_link (cache_reads, cache_reads);
+    if (!cache_reads)
+        qof_instance_set_read_func (NULL, NULL);
+
+    if (!reads->whole_book)
+        g_hash_table_foreach (reads->guids, gnc_report_cache_prepend_guid,
+                              &guids);
+    result = scm_cons (scm_from_bool (reads->uses_prices),
+                       reads->whole_book ? SCM_BOOL_T : guids);
+    g_hash_table_destroy (reads->guids);
+    g_free (reads);
+    return result;
+}
+
+gboolean
+gnc_report_cache_inputs_changed (gint64 generation, SCM guids,
+                                 gboolean uses_prices)
+{
+    gnc_report_cache_init ();
+    gnc_report_cache_check_suppressed ();
+
+    if (cache_structure_generation > generation)
+        return TRUE;
+    if (uses_prices && cache_price_generation > generation)
+        return TRUE;
+
+    /* #t stands for the whole book. */
+    if (!scm_is_null (guids) && !scm_is_pair (guids))
+        return cache_change_generation > generation;
+
+    for (; scm_is_pair (guids); guids = SCM_CDR (guids))
+    {
+        gchar *guid_str = gnc_scm_to_utf8_string (SCM_CAR (guids));
+        GncGUID guid;
+        gint64 *changed = NULL;
+
+        if (string_to_guid (guid_str, &guid))
+            changed = g_hash_table_lookup (cache_instance_generations, &guid);
+        g_free (guid_str);
+        if (changed && *changed > generation)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+gchar *
+gnc_report_cache_read_from_file (void)
+{
+    QofSession *session;
+    GString *entries = NULL;
+    gchar *stamp, *dir, *path, *contents = NULL, **lines, **line;
+
+    if (!gnc_current_session_exist ())
+        return NULL;
+
+    session = gnc_get_current_session ();
+    stamp = gnc_report_cache_session_stamp (session);
+    if (!stamp)
+        return NULL;
+
+    dir = gnc_report_cache_dir (session);
+    path = g_build_filename (dir, "index", NULL);
+    if (!g_file_get_contents (path, &contents, NULL, NULL))
+        contents = NULL;
+    g_free (path);
+
+    lines = g_strsplit (contents ? contents : "", "\n", -1);
+    if (lines[0] && strcmp (lines[0], stamp) == 0)
+    {
+        entries = g_string_new ("(");
+        for (line = lines + 1; *line; line++)
+        {
+            gchar *entry = NULL;
+
+            if (!**line)
+                continue;
+            path = g_build_filename (dir, *line, NULL);
+            if (g_file_get_contents (path, &entry, NULL, NULL))
+            {
+                g_string_append (entries, entry);
+                g_string_append_c (entries, '\n');
+            }
+            g_free (entry);
+            g_free (path);
+        }
+        g_string_append_c (entries, ')');
+    }
+    else if (contents)
+        DEBUG ("report cache %s is out of date", dir);
+
+    g_strfreev (lines);
+    g_free (contents);
+    g_free (dir);
+    g_free (stamp);
+    return entries ? g_string_free (entries, FALSE) : NULL;
+}
@@ -30,10 +30,23 @@
 
 #define SAVED_REPORTS_FILE "saved-reports-2.8"
 #define SAVED_REPORTS_FILE_OLD_REV "saved-reports-2.4"
+#define REPORT_CACHE_FILE_PREFIX "report-cache-"
 
 gboolean gnc_run_report (gint report_id, char ** data);
 gboolean gnc_run_report_id_string (const char * id_string, char **data);
 
+/** Run a new report of the given template, e.g. a saved report, and
+ *  write it to @a filename without involving the gui. The file is
+ *  exported with the report's export thunk when its extension names
+ *  one of the report's export types (like "csv"), else it is html.
+ *
+ *  @param overrides NULL or a NULL terminated array of
+ *  "Section/Name=expression" strings setting options to the value of
+ *  a scheme expression, e.g. "General/Report name=\"Entity A\"".
+ *  @return TRUE if the report was written. */
+gboolean gnc_run_report_to_file (const gchar *template_guid, gchar **overrides,
+                                 const gchar *filename);
+
 /**
  * @param report The SCM version of the report.
  * @return a caller-owned copy of the name of the report, or NULL if report
@@ -54,4 +67,43 @@ gchar* gnc_get_default_report_font_family(void);
 gboolean gnc_saved_reports_backup (void);
 gboolean gnc_saved_reports_write_to_file (const gchar* report_def, gboolean overwrite);
 
+/** Start tracking engine events for the report cache in report.scm
+ *  and saving it next to the saved reports whenever the book is saved
+ *  or closed. Called when the module is loaded; the other cache
+ *  functions call it too. */
+void gnc_report_cache_init (void);
+
+/** The current change generation. A report rendered now is up to date
+ *  until gnc_report_cache_inputs_changed() says otherwise. */
+gint64 gnc_report_cache_generation (void);
+
+/** Start recording which accounts, lots, business objects and
+ *  commodities the engine hands out, until the matching
+ *  gnc_report_cache_end_reads(). Calls nest; an inner run's reads
+ *  count for the outer ones as well. */
+void gnc_report_cache_begin_reads (void);
+
+/** Stop the recording started by the last
+ *  gnc_report_cache_begin_reads().
+ *
+ *  @return A pair of whether any price was looked up and the list of
+ *  guid strings of the instances read, or #t if a query over the whole
+ *  book ran. */
+SCM gnc_report_cache_end_reads (void);
+
+/** Whether anything a report rendered at @a generation read has
+ *  changed since.
+ *
+ *  @param guids A list of guid strings of the accounts and other
+ *  instances the report depends on, or #t if it depends on the whole
+ *  book.
+ *  @param uses_prices Whether the report converts with the price
+ *  database. */
+gboolean gnc_report_cache_inputs_changed (gint64 generation, SCM guids,
+                                          gboolean uses_prices);
+
+/** The report cache saved for the current book, or NULL if there is
+ *  none or the book's data file changed since it was saved. */
+gchar* gnc_report_cache_read_from_file (void);
+
 #endif
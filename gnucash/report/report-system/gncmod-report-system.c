@@ -31,6 +31,7 @@
 
 #include "gnc-module.h"
 #include "gnc-module-api.h"
+#include "gnc-report.h"
 
 GNC_MODULE_API_DECL(libgncmod_report_system)
 
@@ -79,6 +80,7 @@ libgncmod_report_system_gnc_module_init(int refcount)
     if (refcount == 0)
     {
         scm_c_eval_string("(gnc:reldate-initialize)");
+        gnc_report_cache_init();
     }
 
     return TRUE;
@@ -113,20 +113,50 @@
           ((string? e) (cons e accum))
           (else (cons (object->string e) accum)))))
 
+;; writes a tree to port as gnc:html-document-tree-collapse would
+;; flatten it. trees are built by consing, so every list is reversed.
+(define (gnc:html-document-tree-write tree port)
+  (let lp ((e tree))
+    (cond ((null? e) #f)
+          ((pair? e) (for-each lp (reverse e)))
+          ((string? e) (display e port))
+          (else (write e port)))))
+
+;; the port a document is being rendered to. table and table-cell
+;; renderers write their markup straight to it, row by row, instead
+;; of returning it; see gnc:html-object-render.
+(define html-render-port (make-fluid #f))
+
+;; the push procedure for a renderer which can stream: when rendering
+;; to a port it writes to the port, otherwise it calls collect.
+(define (gnc:html-render-pusher collect)
+  (let ((port (fluid-ref html-render-port)))
+    (if port
+        (lambda (l) (gnc:html-document-tree-write l port))
+        collect)))
+
 ;; first optional argument is "headers?"
-;; returns the html document as a string, I think.
+;; returns the html document as a string.
 (define (gnc:html-document-render doc . rest)
+  (let ((headers? (or (null? rest) (car rest))))
+    (call-with-output-string
+      (lambda (port)
+        (gnc:html-document-render-to-port doc port headers?)))))
+
+;; renders the html document to port. tables are written out row by
+;; row as they are rendered, so the whole document is never held in
+;; memory at once. first optional argument is "headers?"
+(define (gnc:html-document-render-to-port doc port . rest)
   (let ((stylesheet (gnc:html-document-style-sheet doc))
         (headers? (or (null? rest) (car rest)))
         (style-text (gnc:html-document-style-text doc)))
 
     (if stylesheet
         ;; if there's a style sheet, let it do the rendering
-        (gnc:html-style-sheet-render stylesheet doc headers?)
+        (gnc:html-style-sheet-render stylesheet doc headers? port)
 
         ;; otherwise, do the trivial render.
-        (let* ((retval '())
-               (push (lambda (l) (set! retval (cons l retval))))
+        (let* ((push (lambda (l) (gnc:html-document-tree-write l port)))
                (objs (gnc:html-document-objects doc))
                (work-to-do (length objs))
                (work-done 0)
@@ -158,12 +188,13 @@
             (push ((gnc:html-markup/open-tag-only "body") doc)))
 
           ;; now render the children
-          (for-each
-           (lambda (child)
+          (with-fluids ((html-render-port port))
+            (for-each
+             (lambda (child)
                (push (gnc:html-object-render child doc))
                (set! work-done (+ 1 work-done))
                (gnc:report-percent-done (* 100 (/ work-done work-to-do))))
-           objs)
+             objs))
 
           (when headers?
             (push "</body>\n")
@@ -171,9 +202,7 @@
 
           (gnc:report-finished)
           (gnc:html-document-pop-style doc)
-          (gnc:html-style-table-uncompile (gnc:html-document-style doc))
-
-          (string-concatenate (gnc:html-document-tree-collapse retval))))))
+          (gnc:html-style-table-uncompile (gnc:html-document-style doc))))))
 
 
 (define (gnc:html-document-push-style doc style)
@@ -382,6 +411,16 @@
 
 (define (gnc:html-object-render obj doc)
   (if (gnc:html-object? obj)
-      ((gnc:html-object-renderer obj) (gnc:html-object-data obj) doc)
+      (let ((renderer (gnc:html-object-renderer obj))
+            (data (gnc:html-object-data obj)))
+        (if (and (fluid-ref html-render-port)
+                 (not (eq? renderer gnc:html-table-render))
+                 (not (eq? renderer gnc:html-table-cell-render)))
+            ;; other renderers return their markup to be written
+            ;; later, so their children must not write to the port
+            ;; ahead of it.
+            (with-fluids ((html-render-port #f))
+              (renderer data doc))
+            (renderer data doc)))
       (let ((htmlo (gnc:make-html-object obj)))
         (gnc:html-object-render htmlo doc))))
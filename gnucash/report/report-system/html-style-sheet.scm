@@ -220,11 +220,14 @@
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 
 (define (gnc:html-style-sheet-render sheet doc . rest)
-  ;; render the document (returns an <html-document>)
+  ;; render the document (returns an <html-document>). optional
+  ;; arguments are headers? and a port; with a port the html is
+  ;; written to it instead of being returned as a string.
   (let ((newdoc ((gnc:html-style-sheet-renderer sheet) 
                  (gnc:html-style-sheet-options sheet)
                  doc))
-        (headers? (and (pair? rest) (car rest))))
+        (headers? (and (pair? rest) (car rest)))
+        (port (and (pair? rest) (pair? (cdr rest)) (cadr rest))))
 
     ;; Copy values over to stylesheet-produced document.  note that this is a
     ;; bug that should probably better be fixed by having the stylesheets
@@ -253,7 +256,9 @@
     ;; render the ssdocument (using the trivial stylesheet).  since
     ;; the objects from 'doc' are now in newdoc, this renders the whole
     ;; package.
-    (gnc:html-document-render newdoc headers?)))
+    (if port
+        (gnc:html-document-render-to-port newdoc port headers?)
+        (gnc:html-document-render newdoc headers?))))
 
 (define (gnc:get-html-style-sheets)
   (sort (map cdr (hash-map->list cons *gnc:_style-sheets_*))
@@ -145,7 +145,8 @@
   ;; gnc:monetary renderers do not have an automatic -neg tag
   ;; modifier. See bug 759005 and bug 797357.
   (let* ((retval '())
-         (push (lambda (l) (set! retval (cons l retval))))
+         (push (gnc:html-render-pusher
+                (lambda (l) (set! retval (cons l retval)))))
          (cell-tag (gnc:html-table-cell-tag cell))
          (cell-data (gnc:html-table-cell-data cell))
          (tag (if (and (not (null? cell-data))
@@ -453,8 +454,11 @@ with multiple rows. returning the first row only.") (car headers)))))
 
 
 (define (gnc:html-table-render table doc)
+  ;; when the document is rendered to a port the rows go straight to
+  ;; it and this returns '().
   (let* ((retval '())
-         (push (lambda (l) (set! retval (cons l retval)))))
+         (push (gnc:html-render-pusher
+                (lambda (l) (set! retval (cons l retval))))))
 
     ;; compile the table style to make other compiles faster
     (gnc:html-style-table-compile (gnc:html-table-style table)
@@ -36,9 +36,18 @@ SCM scm_init_sw_report_system_module (void);
 
 SCM gnc_report_find(gint id);
 gint gnc_report_add(SCM report);
+void gnc_report_remove_by_id(gint id);
 
 %newobject gnc_get_default_report_font_family;
 gchar* gnc_get_default_report_font_family();
 
 void gnc_saved_reports_backup (void);
-gboolean gnc_saved_reports_write_to_file (const gchar* report_def, gboolean overwrite);
\ No newline at end of file
+gboolean gnc_saved_reports_write_to_file (const gchar* report_def, gboolean overwrite);
+
+gint64 gnc_report_cache_generation (void);
+void gnc_report_cache_begin_reads (void);
+SCM gnc_report_cache_end_reads (void);
+gboolean gnc_report_cache_inputs_changed (gint64 generation, SCM guids,
+                                          gboolean uses_prices);
+%newobject gnc_report_cache_read_from_file;
+gchar* gnc_report_cache_read_from_file (void);
\ No newline at end of file
@@ -193,7 +193,13 @@
 (export gnc:report-to-template-new)
 (export gnc:report-to-template-update)
 (export gnc:report-render-html)
+(export gnc:report-render-to-port)
+(export gnc:report-cache-serialize)
+(export gnc:report-cache-flush)
+(export gnc:report-cache-remove!)
+(export gnc:report-stale?)
 (export gnc:report-run)
+(export gnc:report-run-to-file)
 (export gnc:report-templates-for-each)
 (export gnc:report-embedded-list)
 (export gnc:report-template-is-custom/template-guid?)
@@ -282,6 +288,8 @@
 (export gnc:html-document-set-style!)
 (export gnc:html-document-tree-collapse)
 (export gnc:html-document-render)
+(export gnc:html-document-render-to-port)
+(export gnc:html-document-tree-write)
 (export gnc:html-document-push-style)
 (export gnc:html-document-pop-style)
 (export gnc:html-document-add-object!)
@@ -457,6 +457,8 @@ flawed. see report-utilities.scm. please update reports.")
 ;;      dates-list (list of time64) - NOTE: IT WILL BE SORTED
 ;;      split->amount - an unary lambda. calling (split->amount split)
 ;;      returns a number, or #f which effectively skips the split.
+;;      if omitted the split amounts are summed by the engine, which
+;;      is much faster.
 ;; out: (list bal0 bal1 ...), each entry is a gnc-monetary object
 ;;
 ;; NOTE a prior incarnation accepted a #:ignore-closing? boolean
@@ -464,16 +466,22 @@ flawed. see report-utilities.scm. please update reports.")
 ;; (and (not (xaccTransGetIsClosingTxn (xaccSplitGetParent s)))
 ;; (xaccSplitGetAmount s)))
 (define* (gnc:account-get-balances-at-dates
-          account dates-list #:key (split->amount xaccSplitGetAmount))
+          account dates-list #:key split->amount)
   (define (amount->monetary bal)
     (gnc:make-gnc-monetary (xaccAccountGetCommodity account) (or bal 0)))
   (define balance 0)
-  (map amount->monetary
-       (gnc:account-accumulate-at-dates
-        account dates-list #:split->elt
-        (lambda (s)
-          (if s (set! balance (+ balance (or (split->amount s) 0))))
-          balance))))
+  (if split->amount
+      (map amount->monetary
+           (gnc:account-accumulate-at-dates
+            account dates-list #:split->elt
+            (lambda (s)
+              (if s (set! balance (+ balance (or (split->amount s) 0))))
+              balance)))
+      ;; the plain split amounts are summed by the engine; an account
+      ;; without children has exactly one total, in its own commodity.
+      (map (lambda (totals) (amount->monetary (cdar totals)))
+           (car (gnc-accounts-get-balances-at-dates
+                 (list account) (sort dates-list <) #f #f #f)))))
 
 
 ;; this function will scan through account splitlist, building a list
@@ -530,17 +538,14 @@ flawed. see report-utilities.scm. please update reports.")
 ;; thus takes care of children accounts with different currencies.
 (define (gnc:account-get-comm-balance-at-date
          account date include-children?)
-  (let ((balance-collector (gnc:make-commodity-collector))
-        (accounts (cons account
-                        (if include-children?
-                            (gnc-account-get-descendants account)
-                            '()))))
+  (let ((balance-collector (gnc:make-commodity-collector)))
+    ;; like xaccAccountGetBalanceAsOfDate, count splits posted strictly
+    ;; before date, i.e. on or before (1- date).
     (for-each
-     (lambda (acct)
-       (balance-collector 'add
-                          (xaccAccountGetCommodity acct)
-                          (xaccAccountGetBalanceAsOfDate acct date)))
-     accounts)
+     (lambda (total)
+       (balance-collector 'add (car total) (cdr total)))
+     (caar (gnc-accounts-get-balances-at-dates
+            (list account) (list (1- date)) #f include-children? #f)))
     balance-collector))
 
 ;; Calculate the increase in the balance of the account in terms of
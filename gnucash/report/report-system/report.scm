@@ -739,30 +739,257 @@ not found.")))
           (gnc:custom-report-templates-list))))
 
 
+;; The report cache.
+;;
+;; Rendered html is kept under a key made of the report type, its
+;; option values with relative dates resolved, and its style sheet's
+;; options, so a report reopened or re-run with the same settings can
+;; reuse it. Each entry also records what the run depended on: the
+;; accounts, invoices, owners and budgets chosen in its options, the
+;; accounts and commodities the engine handed out while it rendered
+;; (or #t, the whole book, if it queried all of it), and whether it
+;; converts with prices. gnc-report.c follows the engine events and
+;; tells whether any of those changed since the entry's generation, so
+;; editing one account only invalidates the reports that read it.
+;; Reports embedding other reports are not cached, the embedded ones
+;; are.
+;;
+;; The cache is written next to saved-reports once the book is saved
+;; or closed, one file per entry so that only the entries rendered
+;; since the last save are written, and read back the first time a
+;; report of a reopened book is rendered, provided neither the data
+;; file nor its journal changed in between.
+
+(define *gnc:_report-cache_* (make-hash-table))
+(define *gnc:_report-cache-by-id_* (make-hash-table))
+(define gnc:report-cache-loaded? #f)
+
+(define (make-report-cache-entry html generation guids uses-prices? saved?)
+  (vector html generation guids uses-prices? saved?))
+(define (report-cache-entry-html entry) (vector-ref entry 0))
+(define (report-cache-entry-guids entry) (vector-ref entry 2))
+(define (report-cache-entry-uses-prices? entry) (vector-ref entry 3))
+(define (report-cache-entry-saved? entry) (vector-ref entry 4))
+(define (report-cache-entry-set-saved! entry) (vector-set! entry 4 #t))
+
+(define (report-cache-entry-current? entry)
+  (not (gnc-report-cache-inputs-changed
+        (vector-ref entry 1)
+        (report-cache-entry-guids entry)
+        (report-cache-entry-uses-prices? entry))))
+
+(define (report-cacheable? report)
+  (null? (or (gnc:report-embedded-list (gnc:report-options report)) '())))
+
+(define (report-cache-key report headers?)
+  (let ((options (gnc:report-options report))
+        (stylesheet (gnc:report-stylesheet report))
+        (dates '()))
+    (gnc:options-for-each
+     (lambda (option)
+       (if (eq? (gnc:option-type option) 'date)
+           (set! dates (cons (gnc:date-option-absolute-time
+                              (gnc:option-value option))
+                             dates))))
+     options)
+    (string-append
+     (format #f "~a ~a ~s ~s\n" (gnc:report-type report) headers?
+             (qof-date-format-get) dates)
+     (gnc:generate-restore-forms options "options")
+     (if stylesheet
+         (gnc:generate-restore-forms
+          (gnc:html-style-sheet-options stylesheet) "options")
+         ""))))
+
+;; returns the guids of the accounts the report's account options
+;; select, with their subaccounts, and of the invoices, owners and
+;; budgets its other options select.
+(define (report-cache-option-guids report)
+  (let ((guids '()))
+    (define (add! guid)
+      (set! guids (cons guid guids)))
+    (gnc:options-for-each
+     (lambda (option)
+       (let ((value (gnc:option-value option)))
+         (case (gnc:option-type option)
+           ((account-list account-sel)
+            (for-each
+             (lambda (acc)
+               (if (and acc (not (null? acc)))
+                   (for-each (lambda (a) (add! (gncAccountGetGUID a)))
+                             (cons acc (gnc-account-get-descendants acc)))))
+             (if (list? value) value (list value))))
+           ((invoice)
+            (if (and value (not (null? value)))
+                (add! (gncInvoiceReturnGUID value))))
+           ((owner)
+            (if (and value (not (null? value)))
+                (for-each (lambda (owner) (add! (gncOwnerReturnGUID owner)))
+                          (list value (gncOwnerGetEndOwner value)))))
+           ((budget)
+            (if value (add! (gncBudgetGetGUID value)))))))
+     (gnc:report-options report))
+    guids))
+
+(define (report-cache-uses-prices? report)
+  (let ((uses-prices? #f))
+    (gnc:options-for-each
+     (lambda (option)
+       (if (or (eq? (gnc:option-type option) 'currency)
+               (string=? (gnc:option-name option) (N_ "Price Source")))
+           (set! uses-prices? #t)))
+     (gnc:report-options report))
+    uses-prices?))
+
+(define (report-cache-load!)
+  (set! gnc:report-cache-loaded? #t)
+  (let ((contents (gnc-report-cache-read-from-file))
+        (generation (gnc-report-cache-generation)))
+    (if contents
+        (for-each
+         (lambda (saved)
+           (hash-set! *gnc:_report-cache_* (car saved)
+                      (make-report-cache-entry (list-ref saved 1) generation
+                                               (list-ref saved 2)
+                                               (list-ref saved 3) #t)))
+         (false-if-exception (call-with-input-string contents read))))))
+
+(define (report-cache-lookup key)
+  (if (not gnc:report-cache-loaded?)
+      (report-cache-load!))
+  (let ((entry (hash-ref *gnc:_report-cache_* key)))
+    (cond
+     ((not entry) #f)
+     ((report-cache-entry-current? entry) entry)
+     (else (hash-remove! *gnc:_report-cache_* key) #f))))
+
+;; the keys of the still valid cache entries for gnc-report.c to save,
+;; each paired with the entry as a string if it was not saved before
+;; or #f if it was.
+(define (gnc:report-cache-serialize)
+  (hash-fold
+   (lambda (key entry result)
+     (cond
+      ((not (report-cache-entry-current? entry)) result)
+      ((report-cache-entry-saved? entry) (cons (cons key #f) result))
+      (else
+       (report-cache-entry-set-saved! entry)
+       (cons (cons key
+                   (with-output-to-string
+                     (lambda ()
+                       (write (list key (report-cache-entry-html entry)
+                                    (report-cache-entry-guids entry)
+                                    (report-cache-entry-uses-prices? entry))))))
+             result))))
+   '() *gnc:_report-cache_*))
+
+;; forget everything, the book was closed
+(define (gnc:report-cache-flush)
+  (hash-clear! *gnc:_report-cache_*)
+  (hash-clear! *gnc:_report-cache-by-id_*)
+  (set! gnc:report-cache-loaded? #f))
+
+;; drop the cached html of a report and its embedded reports so the
+;; next render runs them again
+(define (gnc:report-cache-remove! report)
+  (for-each
+   (lambda (subreport-id)
+     (let ((subreport (gnc-report-find subreport-id)))
+       (if subreport (gnc:report-cache-remove! subreport))))
+   (or (gnc:report-embedded-list (gnc:report-options report)) '()))
+  (hash-remove! *gnc:_report-cache-by-id_* (gnc:report-id report))
+  (if (report-cacheable? report)
+      (for-each
+       (lambda (headers?)
+         (hash-remove! *gnc:_report-cache_* (report-cache-key report headers?)))
+       '(#t #f))))
+
+;; #t if the report shows html whose inputs changed since it was
+;; rendered. Only known for reports rendered through the cache.
+(define (gnc:report-stale? report)
+  (let ((entry (hash-ref *gnc:_report-cache-by-id_* (gnc:report-id report))))
+    (and entry
+         (not (gnc:report-dirty? report))
+         (gnc:report-ctext report)
+         (not (report-cache-entry-current? entry)))))
+
 ;; gets the renderer from the report template;
 ;; gets the stylesheet from the report;
 ;; renders the html doc and caches the resulting string;
 ;; returns the html string.
 ;; Now accepts either an html-doc or finished HTML from the renderer -
 ;; the former requires further processing, the latter is just returned.
+;; A dirty report is only rendered again if the report cache has no
+;; up to date html for its current options.
 (define (gnc:report-render-html report headers?)
+  (define (render template)
+    (let* ((renderer (gnc:report-template-renderer template))
+           (stylesheet (gnc:report-stylesheet report))
+           (doc (renderer report)))
+      (cond
+       ((string? doc) doc)
+       (else
+        (gnc:html-document-set-style-sheet! doc stylesheet)
+        (gnc:html-document-render doc headers?)))))
+
+  ;; renders and records what the engine handed out meanwhile, see
+  ;; gnc-report-cache-end-reads
+  (define (render-recorded template)
+    (let* ((html #f)
+           (reads (dynamic-wind
+                    gnc-report-cache-begin-reads
+                    (lambda () (set! html (render template)))
+                    gnc-report-cache-end-reads)))
+      (cons html reads)))
+
+  (define (render-cached template)
+    (let* ((key (report-cache-key report headers?))
+           (entry (or (report-cache-lookup key)
+                      (let* ((generation (gnc-report-cache-generation))
+                             (rendered (render-recorded template))
+                             (read-prices? (cadr rendered))
+                             (read-guids (cddr rendered))
+                             (entry (make-report-cache-entry
+                                     (car rendered) generation
+                                     (if (list? read-guids)
+                                         (delete-duplicates
+                                          (append (report-cache-option-guids
+                                                   report)
+                                                  read-guids))
+                                         #t)
+                                     (or read-prices?
+                                         (report-cache-uses-prices? report))
+                                     #f)))
+                        (hash-set! *gnc:_report-cache_* key entry)
+                        entry))))
+      (hash-set! *gnc:_report-cache-by-id_* (gnc:report-id report) entry)
+      (report-cache-entry-html entry)))
+
   (if (and (not (gnc:report-dirty? report))
            (gnc:report-ctext report))
       (gnc:report-ctext report)
       (let ((template (hash-ref *gnc:_report-templates_* (gnc:report-type report))))
         (and template
-             (let* ((renderer (gnc:report-template-renderer template))
-                    (stylesheet (gnc:report-stylesheet report))
-                    (doc (renderer report))
-                    (html (cond
-                           ((string? doc) doc)
-                           (else
-                            (gnc:html-document-set-style-sheet! doc stylesheet)
-                            (gnc:html-document-render doc headers?)))))
+             (let ((html (if (report-cacheable? report)
+                             (render-cached template)
+                             (render template))))
                (gnc:report-set-ctext! report html) ;; cache the html
                (gnc:report-set-dirty?! report #f)  ;; mark it clean
                html)))))
 
+;; renders the report straight to port, for reports too large to hold
+;; as one html string. the html is neither kept in the report nor in
+;; the report cache.
+(define (gnc:report-render-to-port report port headers?)
+  (let* ((template (hash-ref *gnc:_report-templates_* (gnc:report-type report)))
+         (doc (and template ((gnc:report-template-renderer template) report))))
+    (cond
+     ((not doc) #f)
+     ((string? doc) (display doc port))
+     (else
+      (gnc:html-document-set-style-sheet! doc (gnc:report-stylesheet report))
+      (gnc:html-document-render-to-port doc port headers?)))))
+
 ;; looks up the report by id and renders it with gnc:report-render-html
 ;; marks the cursor busy during rendering; returns the html
 ;; Note: the final html document is post-processed to ensure there's only one single
@@ -785,6 +1012,56 @@ not found.")))
     html))
 
 
+;; runs a report without the gui and writes it to file-name: the
+;; report's export thunk makes the file if the extension names one of
+;; its export types (e.g. csv), otherwise the html is streamed to it. overrides is a list of (section name expression) setting
+;; option values from scheme expressions. returns #t on success.
+(define (gnc:report-run-to-file template-id overrides file-name)
+  (let* ((id (gnc:make-report template-id))
+         (report (gnc-report-find id))
+         (options (gnc:report-options report))
+         (dot (string-rindex file-name #\.))
+         (extension (and dot (string-downcase (substring file-name (1+ dot)))))
+         (export-type (and extension
+                           (find (lambda (type)
+                                   (string=? (symbol->string (cdr type)) extension))
+                                 (or (gnc:report-export-types report) '())))))
+    (for-each
+     (lambda (override)
+       (let ((option (gnc:lookup-option options (car override) (cadr override))))
+         (if option
+             (gnc:option-set-value
+              option (eval-string (caddr override)
+                                  #:module (resolve-module
+                                            '(gnucash report report-system))))
+             (gnc:warn "report " template-id " has no option "
+                       (car override) "/" (cadr override)))))
+     overrides)
+    (let ((result
+           (if export-type
+               (gnc:backtrace-if-exception
+                (lambda ()
+                  ((gnc:report-export-thunk report) report (cdr export-type)
+                   file-name)
+                  #t))
+               (if (null? (or (gnc:report-embedded-list options) '()))
+                   (gnc:backtrace-if-exception
+                    (lambda ()
+                      (call-with-output-file file-name
+                        (lambda (port)
+                          (gnc:report-render-to-port report port #t)))
+                      #t))
+                   ;; embedded reports need gnc:report-run to remove
+                   ;; their duplicate script includes from the html.
+                   (let ((html (gnc:report-run id)))
+                     (and html
+                          (begin
+                            (call-with-output-file file-name
+                              (lambda (port) (display html port)))
+                            #t)))))))
+      (gnc-report-remove-by-id id)
+      result)))
+
 ;; "thunk" should take the report-type and the report template record
 (define (gnc:report-templates-for-each thunk)
   (hash-for-each
@@ -39,6 +39,7 @@
     (test-html-objects)
     (test-html-cells)
     (test-html-table)
+    (test-html-render-to-port)
     (test-gnc:html-table-add-labeled-amount-line!)
     (test-gnc:make-html-acct-table/env/accts)
     (test-end "Testing/Temporary/test-report-html")
@@ -619,6 +620,52 @@ HTML Document Title</title></head><body></body>\n\
 
 ;; -----------------------------------------------------------------------
 
+(define (test-html-render-to-port)
+  ;; tables stream their rows to the port; the html must be the same
+  ;; as when every object is rendered to a tree first.
+  (define (make-test-table)
+    (let ((table (gnc:make-html-table))
+          (inner (gnc:make-html-table)))
+      (gnc:html-table-append-row! inner (list "inner 1" "inner 2"))
+      (gnc:html-table-set-col-headers! table (list "Col A" "Col B"))
+      (gnc:html-table-append-row! table (list "a1" 12))
+      (gnc:html-table-append-row!
+       table (list (gnc:make-html-table-cell/size 1 1 inner) "b2"))
+      (gnc:html-table-append-row!
+       table (list (gnc:make-html-text (gnc:html-markup-b "c1") (make-test-inner))
+                   "c2"))
+      table))
+  (define (make-test-inner)
+    (let ((inner (gnc:make-html-table)))
+      (gnc:html-table-append-row! inner (list "text 1"))
+      inner))
+  (define (tree->string tree)
+    (string-concatenate (gnc:html-document-tree-collapse tree)))
+
+  (test-begin "HTML Document - Render to port")
+  (let* ((doc (gnc:make-html-document))
+         (expected (string-append
+                    html-doc-header-no-title
+                    (tree->string (gnc:html-table-render
+                                   (make-test-table) (gnc:make-html-document)))
+                    (tree->string (gnc:html-text-render
+                                   (gnc:make-html-text (make-test-inner))
+                                   (gnc:make-html-document)))
+                    html-doc-tail)))
+    (gnc:html-document-add-object! doc (make-test-table))
+    (gnc:html-document-add-object! doc (gnc:make-html-text (make-test-inner)))
+    (test-equal "render-to-port streams tables in document order"
+      expected
+      (call-with-output-string
+        (lambda (port)
+          (gnc:html-document-render-to-port doc port))))
+    (test-equal "render returns the same html"
+      expected
+      (gnc:html-document-render doc)))
+  (test-end "HTML Document - Render to port"))
+
+;; -----------------------------------------------------------------------
+
 (define (test-html-table)
 
    ;; A table is list of rows in reverse order
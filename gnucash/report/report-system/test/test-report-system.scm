@@ -19,6 +19,7 @@
   (test-report-template-getters)
   (test-make-report)
   (test-report)
+  (test-report-cache)
   (test-end "Testing/Temporary/test-report-system"))
 
 (define test4-guid "54c2fc051af64a08ba2334c2e9179e24")
@@ -212,3 +213,84 @@
     (test-assert "gnc:report-serialize = string"
       (string?
        (gnc:report-serialize report)))))
+
+(define (test-report-cache)
+  (define test-uuid "report-cache-guid")
+  (define runs 0)
+  (let* ((env (create-test-env))
+         (account-alist (env-create-test-accounts env))
+         (bank (cdr (assoc "Bank" account-alist)))
+         (wallet (cdr (assoc "Wallet" account-alist)))
+         (other (cdr (assoc "Other" account-alist)))
+         (expense (cdr (assoc "Expenses" account-alist))))
+    (gnc:define-report
+     'version 1
+     'name "cached report"
+     'report-guid test-uuid
+     'options-generator (lambda ()
+                          (let ((options (gnc:new-options)))
+                            (gnc:register-option
+                             options
+                             (gnc:make-account-list-option
+                              gnc:pagename-accounts "Accounts" "a" "accounts"
+                              (lambda () (list bank)) #f #t))
+                            options))
+     'renderer (lambda (report)
+                 (set! runs (1+ runs))
+                 (format #f "run ~a" runs)))
+    (let ((report (gnc-report-find (gnc:make-report test-uuid))))
+      (test-begin "test-report-cache")
+      (test-equal "first render runs the report"
+        "run 1"
+        (gnc:report-render-html report #t))
+      (gnc:report-set-dirty?! report #t)
+      (test-equal "unchanged inputs reuse the html"
+        "run 1"
+        (gnc:report-render-html report #t))
+      (env-create-transaction env (current-time) wallet other
+                              (gnc:make-gnc-numeric 10 1))
+      (test-assert "unrelated change keeps the report current"
+        (not (gnc:report-stale? report)))
+      (env-create-transaction env (current-time) bank expense
+                              (gnc:make-gnc-numeric 10 1))
+      (test-assert "change to an input makes the report stale"
+        (gnc:report-stale? report))
+      (gnc:report-set-dirty?! report #t)
+      (test-equal "stale html is rendered again"
+        "run 2"
+        (gnc:report-render-html report #t))
+      (gnc:report-cache-remove! report)
+      (gnc:report-set-dirty?! report #t)
+      (test-equal "removed html is rendered again"
+        "run 3"
+        (gnc:report-render-html report #t))
+      (test-assert "new entries are serialized"
+        (and-map (lambda (saved) (string? (cdr saved)))
+                 (gnc:report-cache-serialize)))
+      (test-assert "saved entries are not serialized again"
+        (and-map (lambda (saved) (not (cdr saved)))
+                 (gnc:report-cache-serialize)))
+      (test-end "test-report-cache"))
+    (gnc:define-report
+     'version 1
+     'name "cached report reading a balance"
+     'report-guid "report-cache-reads-guid"
+     'options-generator gnc:new-options
+     'renderer (lambda (report)
+                 (set! runs (1+ runs))
+                 (format #f "balance ~a"
+                         (gnc-numeric-to-double
+                          (xaccAccountGetBalance wallet)))))
+    (let ((report (gnc-report-find
+                   (gnc:make-report "report-cache-reads-guid"))))
+      (test-begin "test-report-cache-reads")
+      (gnc:report-render-html report #t)
+      (env-create-transaction env (current-time) bank expense
+                              (gnc:make-gnc-numeric 10 1))
+      (test-assert "account not read keeps the report current"
+        (not (gnc:report-stale? report)))
+      (env-create-transaction env (current-time) wallet other
+                              (gnc:make-gnc-numeric 10 1))
+      (test-assert "change to an account read makes the report stale"
+        (gnc:report-stale? report))
+      (test-end "test-report-cache-reads"))))
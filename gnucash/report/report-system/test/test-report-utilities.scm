@@ -655,6 +655,7 @@
                                   (list "Bank4"))
                             (list "Income" (list (cons 'type ACCT-TYPE-INCOME)))))
            (accounts (env-create-account-structure-alist env structure))
+           (asset (assoc-ref accounts "Asset"))
            (bank1 (assoc-ref accounts "Bank1"))
            (bank2 (assoc-ref accounts "Bank2"))
            (bank3 (assoc-ref accounts "Bank3"))
@@ -729,5 +730,33 @@
 
       (test-equal "1 txn in early slot"
         '(#f 10 10 10)
-        (gnc:account-accumulate-at-dates bank4 dates)))
+        (gnc:account-accumulate-at-dates bank4 dates))
+
+      (let ((matrix->pairs
+             (lambda (matrix)
+               (map (lambda (row)
+                      (map (lambda (cell)
+                             (map (lambda (total)
+                                    (cons (gnc-commodity-get-mnemonic (car total))
+                                          (cdr total)))
+                                  cell))
+                           row))
+                    matrix))))
+
+        (test-equal "gnc-accounts-get-balances-at-dates, incl children"
+          '(((("USD" . 20)) (("USD" . 40)) (("USD" . 60)) (("USD" . 90)))
+            ((("USD" . 0)) (("USD" . 10)) (("USD" . 20)) (("USD" . 40))))
+          (matrix->pairs
+           (gnc-accounts-get-balances-at-dates (list asset bank1) dates #f #t #f)))
+
+        (test-equal "gnc-accounts-get-balances-at-dates, excl children and closing"
+          '(((("USD" . 0)) (("USD" . 0)) (("USD" . 0)) (("USD" . 0)))
+            ((("USD" . 0)) (("USD" . 10)) (("USD" . 20)) (("USD" . 30))))
+          (matrix->pairs
+           (gnc-accounts-get-balances-at-dates (list asset bank1) dates #f #f #t)))
+
+        (test-equal "gnc-accounts-get-balances-at-dates, value"
+          '(((("USD" . 20)) (("USD" . 40)) (("USD" . 60)) (("USD" . 80))))
+          (matrix->pairs
+           (gnc-accounts-get-balances-at-dates (list asset) dates #t #t #t)))))
     (teardown)))
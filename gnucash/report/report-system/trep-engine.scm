@@ -130,6 +130,7 @@ in the Options panel."))
   ;; together with the subtotal functions. Each entry:
   ;;  'sortkey             - sort parameter sent via qof-query
   ;;  'split-sortvalue     - function retrieves number/string for comparing splits
+  ;;  'split-column        - column used by gnc-splits-sort, #f if unsorted
   ;;  'text                - text displayed in Display tab
   ;;  'tip                 - tooltip displayed in Display tab
   ;;  'renderer-fn         - helper function to select subtotal/subheading renderer
@@ -142,6 +143,7 @@ in the Options panel."))
               (cons 'sortkey (list SPLIT-ACCT-FULLNAME))
               (cons 'split-sortvalue
                     (compose gnc-account-get-full-name xaccSplitGetAccount))
+              (cons 'split-column 'account-name)
               (cons 'text (_ "Account Name"))
               (cons 'tip (_ "Sort & subtotal by account name."))
               (cons 'renderer-fn xaccSplitGetAccount))
@@ -149,6 +151,7 @@ in the Options panel."))
         (list 'account-code
               (cons 'sortkey (list SPLIT-ACCOUNT ACCOUNT-CODE-))
               (cons 'split-sortvalue (compose xaccAccountGetCode xaccSplitGetAccount))
+              (cons 'split-column 'account-code)
               (cons 'text (_ "Account Code"))
               (cons 'tip (_ "Sort & subtotal by account code."))
               (cons 'renderer-fn xaccSplitGetAccount))
@@ -156,6 +159,7 @@ in the Options panel."))
         (list 'date
               (cons 'sortkey (list SPLIT-TRANS TRANS-DATE-POSTED))
               (cons 'split-sortvalue (compose xaccTransGetDate xaccSplitGetParent))
+              (cons 'split-column 'date-posted)
               (cons 'text (_ "Date"))
               (cons 'tip (_ "Sort by date."))
               (cons 'renderer-fn #f))
@@ -163,6 +167,7 @@ in the Options panel."))
         (list 'reconciled-date
               (cons 'sortkey (list SPLIT-DATE-RECONCILED))
               (cons 'split-sortvalue xaccSplitGetDateReconciled)
+              (cons 'split-column 'date-reconciled)
               (cons 'text (_ "Reconciled Date"))
               (cons 'tip (_ "Sort by the Reconciled Date."))
               (cons 'renderer-fn #f))
@@ -172,6 +177,7 @@ in the Options panel."))
               (cons 'split-sortvalue (lambda (s)
                                        (length (memv (xaccSplitGetReconcile s)
                                                      (map car reconcile-list)))))
+              (cons 'split-column 'reconcile)
               (cons 'text (_ "Reconciled Status"))
               (cons 'tip (_ "Sort by the Reconciled Status"))
               (cons 'renderer-fn (lambda (s)
@@ -181,6 +187,7 @@ in the Options panel."))
         (list 'register-order
               (cons 'sortkey (list QUERY-DEFAULT-SORT))
               (cons 'split-sortvalue #f)
+              (cons 'split-column #f)
               (cons 'text (_ "Register Order"))
               (cons 'tip (_ "Sort as in the register."))
               (cons 'renderer-fn #f))
@@ -188,6 +195,7 @@ in the Options panel."))
         (list 'corresponding-acc-name
               (cons 'sortkey (list SPLIT-CORR-ACCT-NAME))
               (cons 'split-sortvalue xaccSplitGetCorrAccountFullName)
+              (cons 'split-column 'other-account-name)
               (cons 'text (_ "Other Account Name"))
               (cons 'tip (_ "Sort by account transferred from/to's name."))
               (cons 'renderer-fn (compose xaccSplitGetAccount xaccSplitGetOtherSplit)))
@@ -195,6 +203,7 @@ in the Options panel."))
         (list 'corresponding-acc-code
               (cons 'sortkey (list SPLIT-CORR-ACCT-CODE))
               (cons 'split-sortvalue xaccSplitGetCorrAccountCode)
+              (cons 'split-column 'other-account-code)
               (cons 'text (_ "Other Account Code"))
               (cons 'tip (_ "Sort by account transferred from/to's code."))
               (cons 'renderer-fn (compose xaccSplitGetAccount xaccSplitGetOtherSplit)))
@@ -202,6 +211,7 @@ in the Options panel."))
         (list 'amount
               (cons 'sortkey (list SPLIT-VALUE))
               (cons 'split-sortvalue xaccSplitGetValue)
+              (cons 'split-column 'value)
               (cons 'text (_ "Amount"))
               (cons 'tip (_ "Sort by amount."))
               (cons 'renderer-fn #f))
@@ -210,6 +220,7 @@ in the Options panel."))
               (cons 'sortkey (list SPLIT-TRANS TRANS-DESCRIPTION))
               (cons 'split-sortvalue (compose xaccTransGetDescription
                                               xaccSplitGetParent))
+              (cons 'split-column 'description)
               (cons 'text (_ "Description"))
               (cons 'tip (_ "Sort by description."))
               (cons 'renderer-fn (compose xaccTransGetDescription xaccSplitGetParent)))
@@ -218,6 +229,7 @@ in the Options panel."))
             (list 'number
                   (cons 'sortkey (list SPLIT-ACTION))
                   (cons 'split-sortvalue xaccSplitGetAction)
+                  (cons 'split-column 'action)
                   (cons 'text (_ "Number/Action"))
                   (cons 'tip (_ "Sort by check number/action."))
                   (cons 'renderer-fn #f))
@@ -225,6 +237,7 @@ in the Options panel."))
             (list 'number
                   (cons 'sortkey (list SPLIT-TRANS TRANS-NUM))
                   (cons 'split-sortvalue (compose xaccTransGetNum xaccSplitGetParent))
+                  (cons 'split-column 'num)
                   (cons 'text (_ "Number"))
                   (cons 'tip (_ "Sort by check/transaction number."))
                   (cons 'renderer-fn #f)))
@@ -232,6 +245,7 @@ in the Options panel."))
         (list 't-number
               (cons 'sortkey (list SPLIT-TRANS TRANS-NUM))
               (cons 'split-sortvalue (compose xaccTransGetNum xaccSplitGetParent))
+              (cons 'split-column 'num)
               (cons 'text (_ "Transaction Number"))
               (cons 'tip (_ "Sort by transaction number."))
               (cons 'renderer-fn #f))
@@ -239,6 +253,7 @@ in the Options panel."))
         (list 'memo
               (cons 'sortkey (list SPLIT-MEMO))
               (cons 'split-sortvalue xaccSplitGetMemo)
+              (cons 'split-column 'memo)
               (cons 'text (_ "Memo"))
               (cons 'tip (_ "Sort by memo."))
               (cons 'renderer-fn xaccSplitGetMemo))
@@ -246,6 +261,7 @@ in the Options panel."))
         (list 'notes
               (cons 'sortkey #f)
               (cons 'split-sortvalue (compose xaccTransGetNotes xaccSplitGetParent))
+              (cons 'split-column 'notes)
               (cons 'text (_ "Notes"))
               (cons 'tip (_ "Sort by transaction notes."))
               (cons 'renderer-fn (compose xaccTransGetNotes xaccSplitGetParent)))
@@ -253,6 +269,7 @@ in the Options panel."))
         (list 'none
               (cons 'sortkey '())
               (cons 'split-sortvalue #f)
+              (cons 'split-column #f)
               (cons 'text (_ "None"))
               (cons 'tip (_ "Do not sort."))
               (cons 'renderer-fn #f))))
@@ -2029,43 +2046,15 @@ be excluded from periodic reporting.")
                        (string-contains str transaction-matcher))))
          (query (qof-query-create-for-splits)))
 
-    (define (generic-less? split-X split-Y sortkey date-subtotal-key ascend?)
-      ;; compare splits X and Y, whereby
-      ;; sortkey and date-subtotal-key specify the options used
-      ;; ascend? specifies whether ascending or descending
-      (let* ((comparator-function
-              (if (memq sortkey DATE-SORTING-TYPES)
-                  (let ((date (keylist-get-info
-                               (sortkey-list BOOK-SPLIT-ACTION)
-                               sortkey 'split-sortvalue))
-                        (date-comparator
-                         (keylist-get-info date-subtotal-list
-                                           date-subtotal-key 'date-sortvalue)))
-                    (lambda (s)
-                      (and date-comparator (date-comparator (date s)))))
-                  (or (keylist-get-info (sortkey-list BOOK-SPLIT-ACTION)
-                                        sortkey 'split-sortvalue)
-                      (lambda (s) #f))))
-             (value-of-X (comparator-function split-X))
-             (value-of-Y (comparator-function split-Y))
-             (op (if (string? value-of-X)
-                     (if ascend? string<? string>?)
-                     (if ascend? < >))))
-        (and value-of-X (op value-of-X value-of-Y))))
-
-    (define (primary-comparator? X Y)
-      (generic-less? X Y primary-key
-                     primary-date-subtotal
-                     (eq? primary-order 'ascend)))
-
-    (define (secondary-comparator? X Y)
-      (generic-less? X Y secondary-key
-                     secondary-date-subtotal
-                     (eq? secondary-order 'ascend)))
-
-    ;; This will, by default, sort the split list by ascending posted-date.
-    (define (date-comparator? X Y)
-      (generic-less? X Y 'date 'none #t))
+    (define (sort-key sortkey date-subtotal-key ascend?)
+      ;; a key for gnc-splits-sort. date keys only order the splits
+      ;; when they are grouped by a date-subtotal period.
+      (list (and (not (and (memq sortkey DATE-SORTING-TYPES)
+                           (eq? date-subtotal-key 'none)))
+                 (keylist-get-info (sortkey-list BOOK-SPLIT-ACTION)
+                                   sortkey 'split-column))
+            date-subtotal-key
+            ascend?))
 
     (define (transaction-filter-match split)
       (or (match? (xaccTransGetDescription (xaccSplitGetParent split)))
@@ -2165,9 +2154,13 @@ be excluded from periodic reporting.")
          splits))
 
       (when custom-sort?
-        (set! splits (stable-sort! splits date-comparator?))
-        (set! splits (stable-sort! splits secondary-comparator?))
-        (set! splits (stable-sort! splits primary-comparator?)))
+        (set! splits
+          (gnc-splits-sort
+           splits
+           (list (sort-key primary-key primary-date-subtotal
+                           (eq? primary-order 'ascend))
+                 (sort-key secondary-key secondary-date-subtotal
+                           (eq? secondary-order 'ascend))))))
 
       (cond
        ((null? splits)
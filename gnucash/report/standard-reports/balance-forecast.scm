@@ -208,12 +208,9 @@ date point, a projected minimum balance including scheduled transactions."))
       ;; Calculate balances
       (let ((balances
              (map
-              (lambda (date accounts-balance)
-                (let* ((start-date (car date))
-                       (end-date (cadr date))
-                       (balance (gnc:make-commodity-collector))
-                       (sx-value (gnc-sx-all-instantiate-cashflow-all
-                                  start-date end-date)))
+              (lambda (date accounts-balance sx-value)
+                (let* ((end-date (cadr date))
+                       (balance (gnc:make-commodity-collector)))
                   (for-each
                    (lambda (account account-balance)
                      (accum 'add (xaccAccountGetCommodity account)
@@ -227,7 +224,8 @@ date point, a projected minimum balance including scheduled transactions."))
                     balance currency
                     (lambda (monetary target-curr)
                       (exchange-fn monetary target-curr end-date))))))
-              intervals (apply zip accounts-balancelist))))
+              intervals (apply zip accounts-balancelist)
+              (gnc-sx-all-instantiate-cashflow-intervals intervals))))
 
         ;; Minimum line
         (when show-minimum
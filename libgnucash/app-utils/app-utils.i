@@ -34,6 +34,7 @@
 #include <gnc-component-manager.h>
 #include <guile-util.h>
 #include <gnc-sx-instance-model.h>
+#include <SX-book.h>
 
 #include "engine-helpers-guile.h"
 %}
@@ -157,12 +158,15 @@ void gnc_detach_process(Process *proc, const gboolean kill_it);
 
 time64 gnc_parse_time_to_time64(const gchar *s, const gchar *format);
 
-%typemap(out) GHashTable * {
-  SCM table = scm_c_make_hash_table (g_hash_table_size($1) + 17);
+%{
+static SCM
+gnc_guid_numeric_hash_to_scm (GHashTable *hash)
+{
+  SCM table = scm_c_make_hash_table (g_hash_table_size(hash) + 17);
   GHashTableIter iter;
   gpointer key, value;
 
-  g_hash_table_iter_init (&iter, $1);
+  g_hash_table_iter_init (&iter, hash);
   while (g_hash_table_iter_next (&iter, &key, &value)) {
     const GncGUID* c_guid = (const GncGUID*) key;
     const gnc_numeric* c_numeric = (const gnc_numeric*) value;
@@ -171,9 +175,50 @@ time64 gnc_parse_time_to_time64(const gchar *s, const gchar *format);
 
     scm_hash_set_x(table, scm_guid, scm_numeric);
   }
-  g_hash_table_destroy($1);
-  $result = table;
+  g_hash_table_destroy(hash);
+  return table;
+}
+
+/* The cash flow of the current book's SXs for each (start end) pair of
+ * times in intervals, as a list of hash tables like the one
+ * gnc_sx_all_instantiate_cashflow_all() returns. */
+static SCM
+gnc_sx_all_instantiate_cashflow_intervals (SCM intervals)
+{
+  GList *all_sxes = gnc_book_get_schedxactions(gnc_get_current_book())->sx_list;
+  int num_ranges = scm_ilength (intervals);
+  GDate *starts, *ends;
+  GHashTable **maps;
+  SCM result = SCM_EOL;
+  int n;
+
+  if (num_ranges <= 0)
+    return SCM_EOL;
+  starts = g_new (GDate, num_ranges);
+  ends = g_new (GDate, num_ranges);
+  maps = g_new (GHashTable*, num_ranges);
+  for (n = 0; n < num_ranges; ++n, intervals = SCM_CDR (intervals))
+  {
+    SCM interval = SCM_CAR (intervals);
+    starts[n] = gnc_time64_to_GDate (SCM_CAR (interval));
+    ends[n] = gnc_time64_to_GDate (SCM_CADR (interval));
+    maps[n] = gnc_g_hash_new_guid_numeric ();
+  }
+  gnc_sx_all_instantiate_cashflow_ranges (all_sxes, starts, ends, num_ranges,
+                                          maps, NULL);
+  while (n-- > 0)
+    result = scm_cons (gnc_guid_numeric_hash_to_scm (maps[n]), result);
+  g_free (starts);
+  g_free (ends);
+  g_free (maps);
+  return result;
+}
+%}
+
+%typemap(out) GHashTable * {
+  $result = gnc_guid_numeric_hash_to_scm ($1);
 }
 GHashTable* gnc_sx_all_instantiate_cashflow_all(GDate range_start, GDate range_end);
 %clear GHashTable *;
+SCM gnc_sx_all_instantiate_cashflow_intervals (SCM intervals);
 #endif
@@ -376,12 +376,10 @@ gnc_sx_instance_new(GncSxInstances *parent, GncSxInstanceState state, GDate *dat
     g_hash_table_foreach(parent->variable_names, _clone_sx_var_hash_entry, rtn->variable_bindings);
 
     {
-        int instance_i_value;
         gnc_numeric i_num;
         GncSxVariable *as_var;
 
-        instance_i_value = gnc_sx_get_instance_count(rtn->parent->sx, rtn->temporal_state);
-        i_num = gnc_numeric_create(instance_i_value, 1);
+        i_num = gnc_numeric_create(sequence_num, 1);
         as_var = gnc_sx_variable_new_full("i", i_num, FALSE);
 
         g_hash_table_insert(rtn->variable_bindings, g_strdup("i"), as_var);
@@ -411,6 +409,19 @@ gnc_sx_instance_get_variables(GncSxInstance *inst)
     return vars;
 }
 
+/* gnc_sx_incr_temporal_state() for when the caller already has the
+ * next instance date; that saves evaluating the recurrence twice per
+ * instance. */
+static void
+_advance_temporal_state(const SchedXaction *sx, SXTmpStateData *tsd,
+                        const GDate *next_date)
+{
+    tsd->last_date = *next_date;
+    if (xaccSchedXactionHasOccurDef(sx))
+        --tsd->num_occur_rem;
+    ++tsd->num_inst;
+}
+
 static GncSxInstances*
 _gnc_sx_gen_instances(gpointer *data, gpointer user_data)
 {
@@ -420,6 +431,7 @@ _gnc_sx_gen_instances(gpointer *data, gpointer user_data)
     GDate creation_end, remind_end;
     GDate cur_date;
     SXTmpStateData *temporal_state = gnc_sx_create_temporal_state(sx);
+    GList *instance_list = NULL;
 
     instances->sx = sx;
 
@@ -442,11 +454,10 @@ _gnc_sx_gen_instances(gpointer *data, gpointer user_data)
             seq_num = gnc_sx_get_instance_count(sx, postponed->data);
             inst = gnc_sx_instance_new(instances, SX_INSTANCE_STATE_POSTPONED,
                                        &inst_date, postponed->data, seq_num);
-            instances->instance_list =
-                g_list_append(instances->instance_list, inst);
+            instance_list = g_list_prepend(instance_list, inst);
             gnc_sx_destroy_temporal_state(temporal_state);
             temporal_state = gnc_sx_clone_temporal_state(postponed->data);
-            gnc_sx_incr_temporal_state(sx, temporal_state);
+            _advance_temporal_state(sx, temporal_state, &inst_date);
         }
     }
 
@@ -461,8 +472,8 @@ _gnc_sx_gen_instances(gpointer *data, gpointer user_data)
         seq_num = gnc_sx_get_instance_count(sx, temporal_state);
         inst = gnc_sx_instance_new(instances, SX_INSTANCE_STATE_TO_CREATE,
                                    &cur_date, temporal_state, seq_num);
-        instances->instance_list = g_list_append(instances->instance_list, inst);
-        gnc_sx_incr_temporal_state(sx, temporal_state);
+        instance_list = g_list_prepend(instance_list, inst);
+        _advance_temporal_state(sx, temporal_state, &cur_date);
         cur_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
     }
 
@@ -475,12 +486,13 @@ _gnc_sx_gen_instances(gpointer *data, gpointer user_data)
         seq_num = gnc_sx_get_instance_count(sx, temporal_state);
         inst = gnc_sx_instance_new(instances, SX_INSTANCE_STATE_REMINDER,
                                    &cur_date, temporal_state, seq_num);
-        instances->instance_list = g_list_append(instances->instance_list,
-                                                 inst);
-        gnc_sx_incr_temporal_state(sx, temporal_state);
+        instance_list = g_list_prepend(instance_list, inst);
+        _advance_temporal_state(sx, temporal_state, &cur_date);
         cur_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
     }
 
+    instances->instance_list = g_list_reverse(instance_list);
+    gnc_sx_destroy_temporal_state(temporal_state);
     return instances;
 }
 
@@ -520,9 +532,10 @@ gnc_sx_get_instances(const GDate *range_end, gboolean include_disabled)
             SchedXaction *sx = (SchedXaction*)sx_iter->data;
             if (xaccSchedXactionGetEnabled(sx))
             {
-                enabled_sxes = g_list_append(enabled_sxes, sx);
+                enabled_sxes = g_list_prepend(enabled_sxes, sx);
             }
         }
+        enabled_sxes = g_list_reverse(enabled_sxes);
         instances->sx_instance_list = gnc_g_list_map(enabled_sxes, (GncGMapFunc)_gnc_sx_gen_instances, (gpointer)range_end);
         g_list_free(enabled_sxes);
     }
@@ -1812,35 +1825,58 @@ instantiate_cashflow_internal(const SchedXaction* sx,
                                   &create_cashflow_data);
 }
 
-typedef struct
+/* The occurrences of the SX after its last created instance, up to
+ * and including last_date. */
+static GArray*
+_gnc_sx_get_future_occurrences(const SchedXaction *sx, const GDate *last_date)
 {
-    GHashTable *hash;
-    GList **creation_errors;
-    const GDate *range_start;
-    const GDate *range_end;
-} SxAllCashflow;
+    GArray *dates = g_array_new(FALSE, FALSE, sizeof(GDate));
+    SXTmpStateData *temporal_state = gnc_sx_create_temporal_state(sx);
+    GDate next_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
+
+    while (g_date_valid(&next_date) && g_date_compare(&next_date, last_date) <= 0)
+    {
+        g_array_append_val(dates, next_date);
+        _advance_temporal_state(sx, temporal_state, &next_date);
+        next_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
+    }
+    gnc_sx_destroy_temporal_state(temporal_state);
+    return dates;
+}
 
-static void instantiate_cashflow_cb(gpointer data, gpointer _user_data)
+/* Index of the first date in the sorted array that is after date, or
+ * not before it if inclusive. */
+static guint
+_gnc_sx_dates_bound(const GArray *dates, const GDate *date, gboolean inclusive)
 {
-    const SchedXaction* sx = (const SchedXaction*) data;
-    SxAllCashflow* userdata = (SxAllCashflow*) _user_data;
-    gint count;
+    guint lo = 0, hi = dates->len;
+    while (lo < hi)
+    {
+        guint mid = lo + (hi - lo) / 2;
+        gint cmp = g_date_compare(&g_array_index(dates, GDate, mid), date);
+        if (cmp < 0 || (cmp == 0 && !inclusive))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
 
-    g_assert(sx);
-    g_assert(userdata);
+static void
+_add_cashflow_times(GHashTable *map, GHashTable *flow, gint count)
+{
+    GHashTableIter iter;
+    gpointer key, value;
+    gnc_numeric count_num = gnc_numeric_create(count, 1);
 
-    /* How often does this particular SX occur in the date range? */
-    count = gnc_sx_get_num_occur_daterange(sx, userdata->range_start,
-                                           userdata->range_end);
-    if (count > 0)
+    g_hash_table_iter_init(&iter, flow);
+    while (g_hash_table_iter_next(&iter, &key, &value))
     {
-        /* If it occurs at least once, calculate ("instantiate") its
-         * cash flow and add it to the result
-         * g_hash<GUID,gnc_numeric> */
-        instantiate_cashflow_internal(sx,
-                                      userdata->hash,
-                                      userdata->creation_errors,
-                                      count);
+        gnc_numeric once = *(gnc_numeric*)value;
+        gnc_numeric amount = gnc_numeric_mul(once, count_num,
+                                             gnc_numeric_denom(once),
+                                             GNC_HOW_RND_ROUND_HALF_UP);
+        add_to_hash_amount(map, (const GncGUID*)key, &amount);
     }
 }
 
@@ -1848,14 +1884,60 @@ void gnc_sx_all_instantiate_cashflow(GList *all_sxes,
                                      const GDate *range_start, const GDate *range_end,
                                      GHashTable* map, GList **creation_errors)
 {
-    SxAllCashflow userdata;
-    userdata.hash = map;
-    userdata.creation_errors = creation_errors;
-    userdata.range_start = range_start;
-    userdata.range_end = range_end;
+    gnc_sx_all_instantiate_cashflow_ranges(all_sxes, range_start, range_end, 1,
+                                           &map, creation_errors);
+}
+
+void gnc_sx_all_instantiate_cashflow_ranges(GList *all_sxes,
+                                            const GDate *range_starts,
+                                            const GDate *range_ends,
+                                            guint num_ranges,
+                                            GHashTable **maps,
+                                            GList **creation_errors)
+{
+    GDate last_end;
+    GList *node;
+    guint n;
+
+    if (num_ranges == 0)
+        return;
+    last_end = range_ends[0];
+    for (n = 1; n < num_ranges; ++n)
+        if (g_date_compare(&range_ends[n], &last_end) > 0)
+            last_end = range_ends[n];
+
+    for (node = all_sxes; node != NULL; node = node->next)
+    {
+        const SchedXaction *sx = (const SchedXaction*)node->data;
+        GHashTable *flow = NULL;
+        GArray *dates;
+
+        if (!xaccSchedXactionGetEnabled(sx))
+            continue;
 
-    /* The work is done in the callback for each SX */
-    g_list_foreach(all_sxes, instantiate_cashflow_cb, &userdata);
+        /* Walk the occurrences once for all the ranges. */
+        dates = _gnc_sx_get_future_occurrences(sx, &last_end);
+        for (n = 0; n < num_ranges; ++n)
+        {
+            gint count = _gnc_sx_dates_bound(dates, &range_ends[n], FALSE) -
+                _gnc_sx_dates_bound(dates, &range_starts[n], TRUE);
+            if (count <= 0)
+                continue;
+
+            /* The cash flow uses no variables, so every occurrence has
+             * the same amounts: evaluate the template formulas once. */
+            if (flow == NULL)
+            {
+                flow = gnc_g_hash_new_guid_numeric();
+                instantiate_cashflow_internal(sx, flow, creation_errors, 1);
+            }
+            _add_cashflow_times(maps[n], flow, count);
+        }
+
+        if (flow != NULL)
+            g_hash_table_destroy(flow);
+        g_array_free(dates, TRUE);
+    }
 }
 
 
@@ -247,6 +247,19 @@ void gnc_sx_all_instantiate_cashflow(GList *all_sxes,
                                      const GDate *range_start, const GDate *range_end,
                                      GHashTable* map, GList **creation_errors);
 
+/** gnc_sx_all_instantiate_cashflow() for several date ranges at once:
+ * maps[n] receives the cash flow for range_starts[n] to range_ends[n].
+ * Each SX's occurrences are worked out once for all the ranges and its
+ * template formulas are evaluated once, however many ranges it occurs
+ * in, so projecting a cash flow day by day costs about as much as
+ * projecting it for the whole period. */
+void gnc_sx_all_instantiate_cashflow_ranges(GList *all_sxes,
+                                            const GDate *range_starts,
+                                            const GDate *range_ends,
+                                            guint num_ranges,
+                                            GHashTable **maps,
+                                            GList **creation_errors);
+
 /** Simplified wrapper around gnc_sx_all_instantiate_cashflow(): Run
  * that function on all SX of the current book for the given date
  * range. Ignore any potential error messages. Returns a newly
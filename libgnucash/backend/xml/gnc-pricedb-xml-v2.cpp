@@ -142,52 +142,18 @@ price_parse_xml_sub_node (GNCPrice* p, xmlNodePtr sub_node, QofBook* book)
     return TRUE;
 }
 
-static gboolean
-price_parse_xml_end_handler (gpointer data_for_children,
-                             GSList* data_from_children,
-                             GSList* sibling_data,
-                             gpointer parent_data,
-                             gpointer global_data,
-                             gpointer* result,
-                             const gchar* tag)
+GNCPrice*
+dom_tree_to_price (xmlNodePtr node, QofBook* book)
 {
-    gboolean ok = TRUE;
-    xmlNodePtr price_xml = (xmlNodePtr) data_for_children;
+    GNCPrice* p;
     xmlNodePtr child;
-    GNCPrice* p = NULL;
-    gxpf_data* gdata = static_cast<decltype (gdata)> (global_data);
-    QofBook* book = static_cast<decltype (book)> (gdata->bookdata);
 
-    /* we haven't been handed the *top* level node yet... */
-    if (parent_data) return TRUE;
-
-    *result = NULL;
-
-    if (!price_xml) return FALSE;
-    if (price_xml->next)
-    {
-        ok = FALSE;
-        goto cleanup_and_exit;
-    }
-    if (price_xml->prev)
-    {
-        ok = FALSE;
-        goto cleanup_and_exit;
-    }
-    if (!price_xml->xmlChildrenNode)
-    {
-        ok = FALSE;
-        goto cleanup_and_exit;
-    }
+    if (!node || !node->xmlChildrenNode) return NULL;
 
     p = gnc_price_create (book);
-    if (!p)
-    {
-        ok = FALSE;
-        goto cleanup_and_exit;
-    }
+    if (!p) return NULL;
 
-    for (child = price_xml->xmlChildrenNode; child; child = child->next)
+    for (child = node->xmlChildrenNode; child; child = child->next)
     {
         switch (child->type)
         {
@@ -197,31 +163,45 @@ price_parse_xml_end_handler (gpointer data_for_children,
         case XML_ELEMENT_NODE:
             if (!price_parse_xml_sub_node (p, child, book))
             {
-                ok = FALSE;
-                goto cleanup_and_exit;
+                gnc_price_unref (p);
+                return NULL;
             }
             break;
         default:
             PERR ("Unknown node type (%d) while parsing gnc-price xml.", child->type);
-            child = NULL;
-            ok = FALSE;
-            goto cleanup_and_exit;
-            break;
+            gnc_price_unref (p);
+            return NULL;
         }
     }
+    return p;
+}
 
-cleanup_and_exit:
-    if (ok)
-    {
-        *result = p;
-    }
-    else
-    {
-        *result = NULL;
-        gnc_price_unref (p);
-    }
+static gboolean
+price_parse_xml_end_handler (gpointer data_for_children,
+                             GSList* data_from_children,
+                             GSList* sibling_data,
+                             gpointer parent_data,
+                             gpointer global_data,
+                             gpointer* result,
+                             const gchar* tag)
+{
+    xmlNodePtr price_xml = (xmlNodePtr) data_for_children;
+    GNCPrice* p = NULL;
+    gxpf_data* gdata = static_cast<decltype (gdata)> (global_data);
+    QofBook* book = static_cast<decltype (book)> (gdata->bookdata);
+
+    /* we haven't been handed the *top* level node yet... */
+    if (parent_data) return TRUE;
+
+    *result = NULL;
+
+    if (!price_xml) return FALSE;
+    if (!price_xml->next && !price_xml->prev)
+        p = dom_tree_to_price (price_xml, book);
+
+    *result = p;
     xmlFreeNode (price_xml);
-    return ok;
+    return p != NULL;
 }
 
 static void
@@ -508,6 +488,12 @@ gnc_pricedb_to_dom_tree (const xmlChar* tag, GNCPriceDB* db)
     return db_xml;
 }
 
+xmlNodePtr
+gnc_price_dom_tree_create (GNCPrice* price)
+{
+    return gnc_price_to_dom_tree (BAD_CAST "price", price);
+}
+
 xmlNodePtr
 gnc_pricedb_dom_tree_create (GNCPriceDB* db)
 {
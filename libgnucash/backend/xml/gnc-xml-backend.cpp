@@ -21,6 +21,7 @@ extern "C"
 #include <platform.h>
 #if PLATFORM(WINDOWS)
 #include <windows.h>
+#include <io.h>
 #endif
 #include <errno.h>
 #include <string.h>
@@ -34,10 +35,14 @@ extern "C"
 #include <gnc-engine.h> //for GNC_MOD_BACKEND
 #include <gnc-uri-utils.h>
 #include <TransLog.h>
+#include <Transaction.h>
+#include <gncInvoice.h>
 #include <gnc-prefs.h>
+#include <gnc-hooks.h>
 
 }
 
+#include <atomic>
 #include <sstream>
 
 #include "gnc-xml-backend.hpp"
@@ -49,6 +54,70 @@ extern "C"
 #define FILE_URI_PREFIX "file://"
 static QofLogModule log_module = GNC_MOD_BACKEND;
 
+/* An incremental save writes everything instead once the journal has
+ * grown to this fraction of the data file, or the data file is this
+ * many seconds old, so that loading never has much to replay. */
+static const gint64 journal_max_fraction = 4;
+static const gint64 journal_max_age = 86400;
+
+/* A full save that compresses the book on a thread. The engine may only
+ * be read on the main thread, so the book is written out uncompressed
+ * there first; the thread compresses that copy, and the main thread puts
+ * the result in place once it is done. */
+struct GncXmlSaveJob
+{
+    std::string snapshot;
+    std::string tmp_name;
+    gint64 commits;
+    bool ok = false;
+    std::atomic<bool> done{false};
+};
+
+static gpointer
+save_thread_func (gpointer data)
+{
+    auto job = static_cast<GncXmlSaveJob*> (data);
+
+    job->ok = gnc_xml_compress_file (job->snapshot.c_str(),
+                                     job->tmp_name.c_str());
+    g_unlink (job->snapshot.c_str());
+    job->done = true;
+    return nullptr;
+}
+
+/* A name for a new file next to @a fullpath, or NULL. */
+static gchar*
+make_temp_name (const std::string& fullpath)
+{
+    auto tmp_name = g_new (char, strlen (fullpath.c_str()) + 12);
+    strcpy (tmp_name, fullpath.c_str());
+    strcat (tmp_name, ".tmp-XXXXXX");
+
+    /* Clang static analyzer flags this as a security risk, which is
+     * theoretically true, but we can't use mkstemp because we need to
+     * open the file ourselves because of compression. None of the alternatives
+     * is any more secure.
+     */
+    if (!mktemp (tmp_name))
+    {
+        g_free (tmp_name);
+        return NULL;
+    }
+    return tmp_name;
+}
+
+GncXmlBackend::~GncXmlBackend()
+{
+    /* session_end() normally finished the save already. */
+    if (m_save_source)
+        g_source_remove (m_save_source);
+    if (m_save_thread)
+        g_thread_join (m_save_thread);
+    if (m_save_job)
+        g_unlink (m_save_job->tmp_name.c_str());
+    delete m_save_job;
+}
+
 bool
 GncXmlBackend::check_path (const char* fullpath, bool create)
 {
@@ -109,6 +178,7 @@ void
 GncXmlBackend::session_begin(QofSession* session, const char* book_id,
                        bool ignore_lock, bool create, bool force)
 {
+    m_session = session;
     /* Make sure the directory is there */
     m_fullpath = gnc_uri_get_path (book_id);
 
@@ -170,6 +240,8 @@ GncXmlBackend::session_begin(QofSession* session, const char* book_id,
 void
 GncXmlBackend::session_end()
 {
+    finish_save ();
+
     if (m_book && qof_book_is_readonly (m_book))
     {
         set_error(ERR_BACKEND_READONLY);
@@ -243,6 +315,7 @@ GncXmlBackend::load(QofBook* book, QofBackendLoadType loadType)
 
     error = ERR_BACKEND_NO_ERR;
     m_book = book;
+    m_loading = true;
 
     int rc;
     switch (determine_file_type (m_fullpath))
@@ -255,6 +328,8 @@ GncXmlBackend::load(QofBook* book, QofBackendLoadType loadType)
             PWARN ("Syntax error in Xml File %s", m_fullpath.c_str());
             error = ERR_FILEIO_PARSE_ERROR;
         }
+        else
+            error = replay_journal ();
         break;
 
     case GNC_BOOK_XML2_FILE_NO_ENCODING:
@@ -303,6 +378,143 @@ GncXmlBackend::load(QofBook* book, QofBackendLoadType loadType)
 
     /* We just got done loading, it can't possibly be dirty !! */
     qof_book_mark_session_saved (book);
+    m_loading = false;
+}
+
+void
+GncXmlBackend::commit (QofInstance* inst)
+{
+    if (m_loading || !m_book || qof_instance_get_book (inst) != m_book)
+        return;
+    if (qof_instance_get_dirty_flag (inst))
+        ++m_commits;
+
+    /* Transactions are journaled whole, so a changed split stands for
+     * its transaction. Splits and transactions are recorded even when
+     * not dirty because moving a split only dirties the split. */
+    auto type = inst->e_type;
+    auto is_split = g_strcmp0 (type, GNC_ID_SPLIT) == 0;
+    if (is_split || g_strcmp0 (type, GNC_ID_TRANS) == 0)
+    {
+        auto trans = is_split ? xaccSplitGetParent (GNC_SPLIT (inst)) :
+            GNC_TRANSACTION (inst);
+        /* Replay can't swap an invoice's posting for a new copy without
+         * leaving the invoice pointing at the old one. */
+        if (trans && gncInvoiceGetInvoiceFromTxn (trans))
+            m_journal_needs_snapshot = true;
+        else if (trans)
+            m_journal_changes.add (*qof_instance_get_guid (trans), GNC_ID_TRANS);
+    }
+    else if (g_strcmp0 (type, GNC_ID_PRICE) == 0)
+        m_journal_changes.add (*qof_instance_get_guid (inst), GNC_ID_PRICE);
+    else if (g_strcmp0 (type, GNC_ID_PRICEDB) != 0 &&
+             (qof_instance_get_dirty_flag (inst) ||
+              qof_instance_get_destroying (inst)))
+        m_journal_needs_snapshot = true;
+}
+
+QofBackendError
+GncXmlBackend::replay_journal ()
+{
+    auto journal = gnc_xml_journal_path (m_fullpath);
+
+    m_journal_ok = false;
+    m_journal_size = 0;
+    if (!gnc_xml_journal_stat_base (m_fullpath, m_journal_base))
+        return ERR_BACKEND_NO_ERR;
+
+    switch (gnc_xml_journal_replay (journal, m_book, m_journal_base,
+                                    &m_journal_size))
+    {
+    case GNC_XML_JOURNAL_STALE:
+        /* Left over from a crash during a full save. The next
+         * incremental save starts it over. */
+        PWARN ("Ignoring journal %s, it doesn't belong to %s",
+               journal.c_str(), m_fullpath.c_str());
+        m_journal_ok = true;
+        break;
+    case GNC_XML_JOURNAL_NONE:
+    case GNC_XML_JOURNAL_REPLAYED:
+        m_journal_ok = true;
+        break;
+    case GNC_XML_JOURNAL_CORRUPT:
+        /* The book is as the last good delta left it, but the user
+         * saved more than that and has to be told. */
+        return ERR_FILEIO_JOURNAL_CORRUPT;
+    default:
+        /* Never append behind a damaged delta, write everything on the
+         * next save instead. */
+        break;
+    }
+    return ERR_BACKEND_NO_ERR;
+}
+
+void
+GncXmlBackend::reset_journal ()
+{
+    auto journal = gnc_xml_journal_path (m_fullpath);
+
+    if (g_unlink (journal.c_str()) != 0 && errno != ENOENT)
+        PWARN ("unable to unlink journal %s: %s", journal.c_str(),
+               g_strerror (errno) ? g_strerror (errno) : "");
+    m_journal_changes.clear ();
+    m_journal_needs_snapshot = false;
+    m_journal_size = 0;
+    m_journal_ok = gnc_xml_journal_stat_base (m_fullpath, m_journal_base);
+}
+
+bool
+GncXmlBackend::write_journal ()
+{
+    GncXmlJournalBase base;
+
+    if (!m_journal_ok || m_journal_needs_snapshot ||
+        !gnc_xml_journal_stat_base (m_fullpath, base) ||
+        !(base == m_journal_base))
+        return false;
+
+    if (m_journal_size > base.size / journal_max_fraction ||
+        gnc_time (NULL) - base.mtime > journal_max_age)
+        return false;
+
+    ENTER (" book=%p changes=%zu", m_book, m_journal_changes.size());
+    if (!m_journal_changes.empty ())
+    {
+        auto journal = gnc_xml_journal_path (m_fullpath);
+        auto out = g_fopen (journal.c_str(), m_journal_size ? "ab" : "wb");
+        if (!out)
+        {
+            PWARN ("unable to open journal %s: %s", journal.c_str(),
+                   g_strerror (errno) ? g_strerror (errno) : "");
+            LEAVE ("");
+            return false;
+        }
+
+        auto ok = (m_journal_size || gnc_xml_journal_write_header (out, base))
+                  && gnc_xml_journal_write_delta (out, m_book, m_journal_changes)
+                  && fflush (out) == 0;
+#ifdef G_OS_WIN32
+        ok = ok && _commit (fileno (out)) == 0;
+#else
+        ok = ok && fsync (fileno (out)) == 0;
+#endif
+        if (ok)
+            m_journal_size = ftell (out);
+        if (fclose (out) != 0 || !ok)
+        {
+            /* Whatever part of the delta made it out is ignored when
+             * loading, and the full save that follows removes it. */
+            PWARN ("unable to write journal %s", journal.c_str());
+            m_journal_ok = false;
+            LEAVE ("");
+            return false;
+        }
+    }
+
+    m_journal_changes.clear ();
+    qof_book_mark_session_saved (m_book);
+    LEAVE (" journal=%" G_GINT64_FORMAT " bytes", m_journal_size);
+    return true;
 }
 
 void
@@ -324,10 +536,157 @@ GncXmlBackend::sync(QofBook* book)
         return;
     }
 
-    write_to_file (true);
+    /* A failed background save is retried in the foreground below,
+     * which reports the error itself. */
+    finish_save ();
+    if (m_save_failed)
+        get_error ();
+
+    if (gnc_prefs_get_file_save_incremental () && write_journal ())
+        return;
+
+    if (gnc_prefs_get_file_save_background () && !m_save_failed &&
+        gnc_prefs_get_file_save_compressed () && start_save ())
+        return;
+
+    if (write_to_file (true))
+        m_save_failed = false;
     remove_old_files();
 }
 
+bool
+GncXmlBackend::start_save ()
+{
+    ENTER (" book=%p file=%s", m_book, m_fullpath.c_str());
+
+    auto snapshot = make_temp_name (m_fullpath);
+    if (!snapshot)
+    {
+        LEAVE ("");
+        return false;
+    }
+    if (!gnc_book_write_to_xml_file_v2 (m_book, snapshot, FALSE))
+    {
+        /* Let the foreground save find out what is wrong. */
+        g_unlink (snapshot);
+        g_free (snapshot);
+        LEAVE ("");
+        return false;
+    }
+    auto tmp_name = make_temp_name (m_fullpath);
+    if (!tmp_name)
+    {
+        g_unlink (snapshot);
+        g_free (snapshot);
+        LEAVE ("");
+        return false;
+    }
+
+    m_save_job = new GncXmlSaveJob;
+    m_save_job->snapshot = snapshot;
+    m_save_job->tmp_name = tmp_name;
+    m_save_job->commits = m_commits;
+    g_free (snapshot);
+    g_free (tmp_name);
+
+    /* The snapshot has every change so far; later ones go to the journal
+     * that starts once the new file is in place. */
+    m_journal_changes.clear ();
+    m_journal_needs_snapshot = false;
+
+    m_save_thread = g_thread_try_new ("xml-save", save_thread_func,
+                                      m_save_job, NULL);
+    if (!m_save_thread)
+    {
+        save_thread_func (m_save_job);
+        finish_save ();
+    }
+    else
+        m_save_source = g_timeout_add (100, save_poll_cb, this);
+    LEAVE ("");
+    return true;
+}
+
+gboolean
+GncXmlBackend::save_poll_cb (gpointer data)
+{
+    auto be = static_cast<GncXmlBackend*> (data);
+
+    if (!be->m_save_job->done)
+        return G_SOURCE_CONTINUE;
+    be->m_save_source = 0;
+    be->finish_save ();
+    return G_SOURCE_REMOVE;
+}
+
+/* Wait for the background save, if any, and put its file in place. The
+ * book is only marked clean if nothing changed while the save ran. */
+void
+GncXmlBackend::finish_save ()
+{
+    if (!m_save_job)
+        return;
+
+    ENTER (" book=%p file=%s", m_book, m_fullpath.c_str());
+    if (m_save_source)
+    {
+        g_source_remove (m_save_source);
+        m_save_source = 0;
+    }
+    /* If the job didn't get a thread, start_save is still in progress and
+     * its caller tells everyone about the save. */
+    auto in_background = m_save_thread != nullptr;
+    if (m_save_thread)
+    {
+        g_thread_join (m_save_thread);
+        m_save_thread = nullptr;
+    }
+
+    auto job = m_save_job;
+    m_save_job = nullptr;
+    auto tmp_name = job->tmp_name.c_str();
+
+    /* start_save cleared the journal changes, so these were made while
+     * the save ran and aren't in its file. install_file starts the new
+     * journal over; they have to go into it. */
+    GncXmlJournalChanges pending;
+    std::swap (pending, m_journal_changes);
+    auto pending_snapshot = m_journal_needs_snapshot;
+    if (job->ok && backup_file () && install_file (tmp_name))
+    {
+        m_journal_changes = std::move (pending);
+        /* Not every change is journaled; don't let the next save mark
+         * the book clean without writing one it missed. */
+        m_journal_needs_snapshot = pending_snapshot ||
+            (m_commits != job->commits && m_journal_changes.empty ());
+        if (m_commits == job->commits)
+            qof_book_mark_session_saved (m_book);
+        remove_old_files ();
+        LEAVE (" successful save of book=%p to file=%s", m_book,
+               m_fullpath.c_str());
+        delete job;
+        /* Only now is the saved file in place. */
+        if (in_background && m_session)
+            gnc_hook_run (HOOK_BOOK_SAVED, m_session);
+        return;
+    }
+    else
+    {
+        g_unlink (tmp_name);
+        if (!check_error ())
+            set_error (ERR_FILEIO_WRITE_ERROR);
+        PERR ("Saving %s in the background failed", m_fullpath.c_str());
+        m_save_failed = true;
+        /* The retry writes the whole book. */
+        m_journal_changes = std::move (pending);
+        m_journal_needs_snapshot = pending_snapshot;
+        m_journal_ok = false;
+        qof_book_mark_session_dirty (m_book);
+        LEAVE ("");
+    }
+    delete job;
+}
+
 bool
 GncXmlBackend::save_may_clobber_data()
 {
@@ -372,18 +731,9 @@ GncXmlBackend::write_to_file (bool make_backup)
     /* if (FALSE == qof_book_session_not_saved (book)) return FALSE; */
 
 
-    auto tmp_name = g_new (char, strlen (m_fullpath.c_str()) + 12);
-    strcpy (tmp_name, m_fullpath.c_str());
-    strcat (tmp_name, ".tmp-XXXXXX");
-
-    /* Clang static analyzer flags this as a security risk, which is
-     * theoretically true, but we can't use mkstemp because we need to
-     * open the file ourselves because of compression. None of the alternatives
-     * is any more secure.
-     */
-    if (!mktemp (tmp_name))
+    auto tmp_name = make_temp_name (m_fullpath);
+    if (!tmp_name)
     {
-        g_free (tmp_name);
         set_error(ERR_BACKEND_MISC);
         set_message("Failed to make temp file");
         LEAVE ("");
@@ -403,81 +753,13 @@ GncXmlBackend::write_to_file (bool make_backup)
     if (gnc_book_write_to_xml_file_v2 (m_book, tmp_name,
                                        gnc_prefs_get_file_save_compressed ()))
     {
-        /* Record the file's permissions before g_unlinking it */
-        GStatBuf statbuf;
-        auto rc = g_stat (m_fullpath.c_str(), &statbuf);
-        if (rc == 0)
-        {
-            /* We must never chmod the file /dev/null */
-            g_assert (g_strcmp0 (tmp_name, "/dev/null") != 0);
-
-            /* Use the permissions from the original data file */
-            if (g_chmod (tmp_name, statbuf.st_mode) != 0)
-            {
-                /* set_error(ERR_BACKEND_PERM); */
-                /* set_message("Failed to chmod filename %s", tmp_name ); */
-                /* Even if the chmod did fail, the save
-                   nevertheless completed successfully. It is
-                   therefore wrong to signal the ERR_BACKEND_PERM
-                   error here which implies that the saving itself
-                   failed. Instead, we simply ignore this. */
-                PWARN ("unable to chmod filename %s: %s",
-                       tmp_name ? tmp_name : "(null)",
-                       g_strerror (errno) ? g_strerror (errno) : "");
-#if VFAT_DOESNT_SUCK  /* chmod always fails on vfat/samba fs */
-                /* g_free(tmp_name); */
-                /* return FALSE; */
-#endif
-            }
-#ifdef HAVE_CHOWN
-            /* Don't try to change the owner. Only root can do
-               that. */
-            if (chown (tmp_name, -1, statbuf.st_gid) != 0)
-            {
-                /* set_error(ERR_BACKEND_PERM); */
-                /* set_message("Failed to chown filename %s", tmp_name ); */
-                /* A failed chown doesn't mean that the saving itself
-                failed. So don't abort with an error here! */
-                PWARN ("unable to chown filename %s: %s",
-                       tmp_name ? tmp_name : "(null)",
-                       strerror (errno) ? strerror (errno) : "");
-#if VFAT_DOESNT_SUCK /* chown always fails on vfat fs */
-                /* g_free(tmp_name);
-                return FALSE; */
-#endif
-            }
-#endif
-        }
-        if (g_unlink (m_fullpath.c_str()) != 0 && errno != ENOENT)
-        {
-            set_error(ERR_BACKEND_READONLY);
-            PWARN ("unable to unlink filename %s: %s",
-                   m_fullpath.empty() ? "(null)" : m_fullpath.c_str(),
-                   g_strerror (errno) ? g_strerror (errno) : "");
-            g_free (tmp_name);
-            LEAVE ("");
-            return FALSE;
-        }
-        if (!link_or_make_backup (tmp_name, m_fullpath))
+        auto installed = install_file (tmp_name);
+        g_free (tmp_name);
+        if (!installed)
         {
-            set_error(ERR_FILEIO_BACKUP_ERROR);
-            std::string msg{"Failed to make backup file "};
-            set_message(msg + (m_fullpath.empty() ? "NULL" : m_fullpath));
-            g_free (tmp_name);
             LEAVE ("");
             return FALSE;
         }
-        if (g_unlink (tmp_name) != 0)
-        {
-            set_error(ERR_BACKEND_PERM);
-            PWARN ("unable to unlink temp filename %s: %s",
-                   tmp_name ? tmp_name : "(null)",
-                   g_strerror (errno) ? g_strerror (errno) : "");
-            g_free (tmp_name);
-            LEAVE ("");
-            return FALSE;
-        }
-        g_free (tmp_name);
 
         /* Since we successfully saved the book,
          * we should mark it clean. */
@@ -525,6 +807,84 @@ GncXmlBackend::write_to_file (bool make_backup)
     return TRUE;
 }
 
+/* Put the new file @a tmp_name in place of the data file. */
+bool
+GncXmlBackend::install_file (const char* tmp_name)
+{
+    /* Record the file's permissions before g_unlinking it */
+    GStatBuf statbuf;
+    auto rc = g_stat (m_fullpath.c_str(), &statbuf);
+    if (rc == 0)
+    {
+        /* We must never chmod the file /dev/null */
+        g_assert (g_strcmp0 (tmp_name, "/dev/null") != 0);
+
+        /* Use the permissions from the original data file */
+        if (g_chmod (tmp_name, statbuf.st_mode) != 0)
+        {
+            /* set_error(ERR_BACKEND_PERM); */
+            /* set_message("Failed to chmod filename %s", tmp_name ); */
+            /* Even if the chmod did fail, the save
+               nevertheless completed successfully. It is
+               therefore wrong to signal the ERR_BACKEND_PERM
+               error here which implies that the saving itself
+               failed. Instead, we simply ignore this. */
+            PWARN ("unable to chmod filename %s: %s",
+                   tmp_name ? tmp_name : "(null)",
+                   g_strerror (errno) ? g_strerror (errno) : "");
+#if VFAT_DOESNT_SUCK  /* chmod always fails on vfat/samba fs */
+            /* g_free(tmp_name); */
+            /* return FALSE; */
+#endif
+        }
+#ifdef HAVE_CHOWN
+        /* Don't try to change the owner. Only root can do
+           that. */
+        if (chown (tmp_name, -1, statbuf.st_gid) != 0)
+        {
+            /* set_error(ERR_BACKEND_PERM); */
+            /* set_message("Failed to chown filename %s", tmp_name ); */
+            /* A failed chown doesn't mean that the saving itself
+            failed. So don't abort with an error here! */
+            PWARN ("unable to chown filename %s: %s",
+                   tmp_name ? tmp_name : "(null)",
+                   strerror (errno) ? strerror (errno) : "");
+#if VFAT_DOESNT_SUCK /* chown always fails on vfat fs */
+            /* g_free(tmp_name);
+            return FALSE; */
+#endif
+        }
+#endif
+    }
+    if (g_unlink (m_fullpath.c_str()) != 0 && errno != ENOENT)
+    {
+        set_error(ERR_BACKEND_READONLY);
+        PWARN ("unable to unlink filename %s: %s",
+               m_fullpath.empty() ? "(null)" : m_fullpath.c_str(),
+               g_strerror (errno) ? g_strerror (errno) : "");
+        return false;
+    }
+    if (!link_or_make_backup (tmp_name, m_fullpath))
+    {
+        set_error(ERR_FILEIO_BACKUP_ERROR);
+        std::string msg{"Failed to make backup file "};
+        set_message(msg + (m_fullpath.empty() ? "NULL" : m_fullpath));
+        return false;
+    }
+    if (g_unlink (tmp_name) != 0)
+    {
+        set_error(ERR_BACKEND_PERM);
+        PWARN ("unable to unlink temp filename %s: %s",
+               tmp_name ? tmp_name : "(null)",
+               g_strerror (errno) ? g_strerror (errno) : "");
+        return false;
+    }
+
+    /* The new file holds everything the journal did. */
+    reset_journal ();
+    return true;
+}
+
 static bool
 copy_file (const std::string& orig, const std::string& bkup)
 {
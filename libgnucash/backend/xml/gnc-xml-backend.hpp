@@ -25,6 +25,9 @@ extern "C"
 
 #include <string>
 #include <qof-backend.hpp>
+#include "io-gncxml-journal.h"
+
+struct GncXmlSaveJob;
 
 class GncXmlBackend : public QofBackend
 {
@@ -34,12 +37,14 @@ public:
     GncXmlBackend operator=(const GncXmlBackend&) = delete;
     GncXmlBackend(const GncXmlBackend&&) = delete;
     GncXmlBackend operator=(const GncXmlBackend&&) = delete;
-    ~GncXmlBackend() = default;
+    ~GncXmlBackend();
     void session_begin(QofSession* session, const char* book_id,
                        bool ignore_lock, bool create, bool force) override;
     void session_end() override;
     void load(QofBook* book, QofBackendLoadType loadType) override;
-    /* The XML backend isn't able to do anything with individual instances. */
+    /* The XML backend only notes which instances changed, so that an
+     * incremental save knows what to write to the journal. */
+    void commit(QofInstance* inst) override;
     void export_coa(QofBook*) override;
     void sync(QofBook* book) override;
     void safe_sync(QofBook* book) override { sync(book); } // XML sync is inherently safe.
@@ -52,6 +57,13 @@ private:
     bool link_or_make_backup(const std::string& orig, const std::string& bkup);
     bool backup_file();
     bool write_to_file(bool make_backup);
+    bool install_file(const char* tmp_name);
+    bool start_save();
+    void finish_save();
+    static gboolean save_poll_cb(gpointer data);
+    bool write_journal();
+    void reset_journal();
+    QofBackendError replay_journal();
     void remove_old_files();
     void write_accounts(QofBook* book);
     bool check_path(const char* fullpath, bool create);
@@ -62,5 +74,27 @@ private:
     int m_lockfd;
 
     QofBook* m_book = nullptr;  /* The primary, main open book */
+    /* For HOOK_BOOK_SAVED when a background save completes. */
+    QofSession* m_session = nullptr;
+
+    bool m_loading = false;
+    /* The journal belongs to m_journal_base and may be appended to. */
+    bool m_journal_ok = false;
+    /* Something changed that only a full save can write. */
+    bool m_journal_needs_snapshot = false;
+    GncXmlJournalBase m_journal_base;
+    gint64 m_journal_size = 0;
+    GncXmlJournalChanges m_journal_changes;
+
+    /* The save whose compression is still running, if any. */
+    GncXmlSaveJob* m_save_job = nullptr;
+    GThread* m_save_thread = nullptr;
+    guint m_save_source = 0;
+    /* Commits that dirtied the book, to tell whether the book changed
+     * while the save ran. */
+    gint64 m_commits = 0;
+    /* Save in the foreground until a save succeeds, so that errors reach
+     * the user. */
+    bool m_save_failed = false;
 };
 #endif // __GNC_XML_BACKEND_HPP__
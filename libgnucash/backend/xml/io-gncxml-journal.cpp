@@ -0,0 +1,355 @@
+/********************************************************************\
+ * io-gncxml-journal.cpp -- append-only journal for XML books       *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+extern "C"
+{
+#include <config.h>
+
+#include <string.h>
+#include <glib/gstdio.h>
+
+#include "gnc-engine.h"
+#include "gnc-pricedb.h"
+#include "gnc-pricedb-p.h"
+#include "Transaction.h"
+#include "TransLog.h"
+#include "gncInvoice.h"
+}
+
+#include "gnc-xml.h"
+#include "io-gncxml-journal.h"
+#include "io-gncxml-v2.h"
+#include "sixtp.h"
+#include "sixtp-parsers.h"
+#include "sixtp-dom-parsers.h"
+#include "sixtp-dom-generators.h"
+
+static QofLogModule log_module = GNC_MOD_IO;
+
+#define JOURNAL_DELTA_TAG "gnc-journal-delta"
+#define DESTROYED_TRANS_TAG "gnc:destroyed-transaction"
+#define DESTROYED_PRICE_TAG "gnc:destroyed-price"
+
+std::string
+gnc_xml_journal_path (const std::string& datafile)
+{
+    return datafile + ".journal";
+}
+
+bool
+gnc_xml_journal_stat_base (const std::string& filename, GncXmlJournalBase& base)
+{
+    GStatBuf statbuf;
+
+    if (g_stat (filename.c_str(), &statbuf) != 0)
+        return false;
+    base.size = statbuf.st_size;
+    base.mtime = statbuf.st_mtime;
+    base.ino = statbuf.st_ino;
+    return true;
+}
+
+/* WRITING */
+/***********************************************************************/
+
+bool
+gnc_xml_journal_write_header (FILE* out, const GncXmlJournalBase& base)
+{
+    return fprintf (out, "<gnc-journal version=\"1\" base-size=\"%" G_GINT64_FORMAT
+                    "\" base-mtime=\"%" G_GINT64_FORMAT "\" base-ino=\"%"
+                    G_GINT64_FORMAT "\"/>\n", base.size, base.mtime, base.ino) >= 0;
+}
+
+static xmlNodePtr
+journal_node (QofBook* book, const GncGUID& guid, QofIdTypeConst type)
+{
+    if (g_strcmp0 (type, GNC_ID_TRANS) == 0)
+    {
+        auto trans = xaccTransLookup (&guid, book);
+        if (trans)
+            return gnc_transaction_dom_tree_create (trans);
+        return guid_to_dom_tree (DESTROYED_TRANS_TAG, &guid);
+    }
+    if (g_strcmp0 (type, GNC_ID_PRICE) == 0)
+    {
+        /* A price that isn't in the database has been removed, or hasn't
+         * been added yet. Either way it isn't saved. */
+        auto price = gnc_price_lookup (&guid, book);
+        if (price && price->db)
+            return gnc_price_dom_tree_create (price);
+        return guid_to_dom_tree (DESTROYED_PRICE_TAG, &guid);
+    }
+    return NULL;
+}
+
+bool
+gnc_xml_journal_write_delta (FILE* out, QofBook* book,
+                             const GncXmlJournalChanges& changes)
+{
+    if (fprintf (out, "<" JOURNAL_DELTA_TAG) < 0
+        || !gnc_xml2_write_namespace_decl (out, "gnc")
+        || !gnc_xml2_write_namespace_decl (out, "cmdty")
+        || !gnc_xml2_write_namespace_decl (out, "price")
+        || !gnc_xml2_write_namespace_decl (out, "slot")
+        || !gnc_xml2_write_namespace_decl (out, "split")
+        || !gnc_xml2_write_namespace_decl (out, "trn")
+        || !gnc_xml2_write_namespace_decl (out, "ts")
+        || fprintf (out, ">\n") < 0)
+        return false;
+
+    for (auto& change : changes)
+    {
+        auto node = journal_node (book, change.first, change.second);
+        if (!node)
+            continue;
+        xmlElemDump (out, NULL, node);
+        xmlFreeNode (node);
+        if (ferror (out) || fprintf (out, "\n") < 0)
+            return false;
+    }
+
+    return fprintf (out, "</" JOURNAL_DELTA_TAG ">\n") >= 0 && !ferror (out);
+}
+
+/* READING */
+/***********************************************************************/
+
+static gboolean
+journal_delta_end_handler (gpointer data_for_children,
+                           GSList* data_from_children, GSList* sibling_data,
+                           gpointer parent_data, gpointer global_data,
+                           gpointer* result, const gchar* tag)
+{
+    auto tree = static_cast<xmlNodePtr> (data_for_children);
+    auto delta = static_cast<xmlNodePtr*> (global_data);
+
+    /* Only the top level element is wanted; the document itself ends
+     * with a NULL tag. */
+    if (parent_data || !tag)
+        return TRUE;
+
+    g_return_val_if_fail (tree, FALSE);
+    *delta = tree;
+    return TRUE;
+}
+
+static GncGUID*
+journal_node_guid (xmlNodePtr node, const char* id_tag)
+{
+    if (!id_tag)
+        return dom_tree_to_guid (node);
+
+    for (auto child = node->xmlChildrenNode; child; child = child->next)
+        if (child->type == XML_ELEMENT_NODE &&
+            g_strcmp0 ((char*)child->name, id_tag) == 0)
+            return dom_tree_to_guid (child);
+    return NULL;
+}
+
+static bool
+journal_remove_trans (QofBook* book, const GncGUID* guid)
+{
+    auto trans = xaccTransLookup (guid, book);
+    if (!trans)
+        return true;
+    /* The invoice would be left pointing at the destroyed copy. The
+     * backend takes a snapshot instead of journaling these. */
+    if (gncInvoiceGetInvoiceFromTxn (trans))
+    {
+        gchar guidstr[GUID_ENCODING_LENGTH + 1];
+        PERR ("transaction %s posts an invoice, it can't be replayed",
+              guid_to_string_buff (guid, guidstr));
+        return false;
+    }
+    /* A voided transaction refuses to be destroyed. Its journaled state
+     * carries its own read-only reason, if any. */
+    xaccTransBeginEdit (trans);
+    if (xaccTransGetReadOnly (trans))
+        xaccTransClearReadOnly (trans);
+    xaccTransDestroy (trans);
+    xaccTransCommitEdit (trans);
+    return xaccTransLookup (guid, book) == NULL;
+}
+
+static void
+journal_remove_price (QofBook* book, const GncGUID* guid)
+{
+    auto price = gnc_price_lookup (guid, book);
+    if (price && price->db)
+        gnc_pricedb_remove_price (price->db, price);
+}
+
+/* Apply one journaled instance. If @a undo is given, the state it
+ * replaces is prepended to it, so that it can be put back. */
+static bool
+journal_apply_node (QofBook* book, xmlNodePtr node, GSList** undo)
+{
+    auto name = (const char*)node->name;
+    auto is_trans = g_strcmp0 (name, "gnc:transaction") == 0;
+    auto is_price = g_strcmp0 (name, "price") == 0;
+    GncGUID* guid;
+
+    if (is_trans || is_price)
+        guid = journal_node_guid (node, is_trans ? "trn:id" : "price:id");
+    else if (g_strcmp0 (name, DESTROYED_TRANS_TAG) == 0 ||
+             g_strcmp0 (name, DESTROYED_PRICE_TAG) == 0)
+        guid = journal_node_guid (node, NULL);
+    else
+    {
+        PERR ("unexpected tag %s in journal", name);
+        return false;
+    }
+    if (!guid)
+        return false;
+
+    /* A changed instance replaces the one loaded so far. */
+    auto removed = true;
+    auto trans_node = is_trans || g_strcmp0 (name, DESTROYED_TRANS_TAG) == 0;
+    auto before = undo ? journal_node (book, *guid, trans_node ?
+                                       GNC_ID_TRANS : GNC_ID_PRICE) : NULL;
+    if (trans_node)
+        removed = journal_remove_trans (book, guid);
+    else
+        journal_remove_price (book, guid);
+    guid_free (guid);
+    if (!removed)
+    {
+        /* Nothing was changed. */
+        if (before)
+            xmlFreeNode (before);
+        return false;
+    }
+    if (before)
+        *undo = g_slist_prepend (*undo, before);
+
+    if (is_trans)
+        return dom_tree_to_transaction (node, book) != NULL;
+    if (is_price)
+    {
+        auto price = dom_tree_to_price (node, book);
+        if (!price)
+            return false;
+        gnc_pricedb_add_price (gnc_pricedb_get_db (book), price);
+        gnc_price_unref (price);
+    }
+    return true;
+}
+
+static bool
+journal_apply_delta (QofBook* book, sixtp* parser, char* buf, int size)
+{
+    xmlNodePtr delta = NULL;
+    gpointer parse_result = NULL;
+    bool ok;
+
+    if (!sixtp_parse_buffer (parser, buf, size, NULL, &delta, &parse_result)
+        || !delta)
+    {
+        if (delta)
+            xmlFreeNode (delta);
+        return false;
+    }
+
+    /* Keep the state each node replaces, so that a delta that fails
+     * part way through leaves the book as the previous one did. */
+    GSList* undo = NULL;
+    ok = g_strcmp0 ((char*)delta->name, JOURNAL_DELTA_TAG) == 0;
+    for (auto node = delta->xmlChildrenNode; ok && node; node = node->next)
+        if (node->type == XML_ELEMENT_NODE)
+            ok = journal_apply_node (book, node, &undo);
+
+    /* The list is newest first, which is the order to undo in. */
+    for (auto iter = undo; iter; iter = iter->next)
+    {
+        auto node = static_cast<xmlNodePtr> (iter->data);
+        if (!ok && !journal_apply_node (book, node, NULL))
+            PERR ("unable to restore %s after a failed delta",
+                  (const char*)node->name);
+        xmlFreeNode (node);
+    }
+    g_slist_free (undo);
+    xmlFreeNode (delta);
+    return ok;
+}
+
+GncXmlJournalStatus
+gnc_xml_journal_replay (const std::string& filename, QofBook* book,
+                        const GncXmlJournalBase& base, gint64* valid_size)
+{
+    GncXmlJournalBase journal_base;
+    gchar* contents = NULL;
+    gsize length = 0;
+    auto status = GNC_XML_JOURNAL_REPLAYED;
+
+    *valid_size = 0;
+    if (!g_file_test (filename.c_str(), G_FILE_TEST_EXISTS))
+        return GNC_XML_JOURNAL_NONE;
+    if (!g_file_get_contents (filename.c_str(), &contents, &length, NULL))
+        return GNC_XML_JOURNAL_CORRUPT;
+
+    auto header_end = static_cast<char*> (memchr (contents, '\n', length));
+    if (!header_end ||
+        sscanf (contents, "<gnc-journal version=\"1\" base-size=\"%" G_GINT64_FORMAT
+                "\" base-mtime=\"%" G_GINT64_FORMAT "\" base-ino=\"%"
+                G_GINT64_FORMAT "\"/>", &journal_base.size,
+                &journal_base.mtime, &journal_base.ino) != 3 ||
+        !(journal_base == base))
+    {
+        g_free (contents);
+        return GNC_XML_JOURNAL_STALE;
+    }
+
+    auto parser = sixtp_dom_parser_new (journal_delta_end_handler, NULL, NULL);
+    xaccLogDisable ();
+
+    auto pos = header_end + 1;
+    auto end = contents + length;
+    static const char end_tag[] = "</" JOURNAL_DELTA_TAG ">\n";
+    while (pos < end)
+    {
+        /* Each delta was appended and synced in one go, so only the last
+         * one can be incomplete. */
+        auto delta_end = g_strstr_len (pos, end - pos, end_tag);
+        if (!delta_end)
+        {
+            PWARN ("Ignoring incomplete delta at the end of %s",
+                   filename.c_str());
+            status = GNC_XML_JOURNAL_TORN;
+            break;
+        }
+        delta_end += strlen (end_tag);
+        if (!journal_apply_delta (book, parser, pos, delta_end - pos))
+        {
+            PERR ("Unable to apply delta at offset %ld of %s, it and the "
+                  "deltas after it are ignored",
+                  (long)(pos - contents), filename.c_str());
+            status = GNC_XML_JOURNAL_CORRUPT;
+            break;
+        }
+        pos = delta_end;
+    }
+
+    xaccLogEnable ();
+    sixtp_destroy (parser);
+    *valid_size = pos - contents;
+    g_free (contents);
+    return status;
+}
@@ -0,0 +1,151 @@
+/********************************************************************\
+ * io-gncxml-journal.h -- append-only journal for XML books         *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+
+/** @file io-gncxml-journal.h
+ *  @brief Save changes to an XML book without rewriting the whole file.
+ *
+ *  The journal lives next to the data file, as <datafile>.journal. Its
+ *  first line names the data file it belongs to by size, modification
+ *  time and inode; every save after that appends one
+ *  \<gnc-journal-delta\> element holding the current state of each
+ *  transaction and price changed since the previous save, and the GUIDs
+ *  of the ones deleted. The data file itself stays a plain v2 file.
+ *
+ *  A journal whose first line doesn't match the data file is ignored,
+ *  and so is a delta that was cut short by a crash while appending it.
+ */
+
+#ifndef IO_GNCXML_JOURNAL_H
+#define IO_GNCXML_JOURNAL_H
+
+extern "C"
+{
+#include <stdio.h>
+#include <glib.h>
+#include <qof.h>
+}
+
+#include <list>
+#include <map>
+#include <string>
+
+struct GncXmlJournalBase
+{
+    gint64 size;
+    gint64 mtime;
+    gint64 ino;
+    bool operator== (const GncXmlJournalBase& other) const
+    {
+        return size == other.size && mtime == other.mtime && ino == other.ino;
+    }
+};
+
+struct GncGUIDLess
+{
+    bool operator() (const GncGUID& a, const GncGUID& b) const
+    {
+        return guid_compare (&a, &b) < 0;
+    }
+};
+
+/** The instances to write to the next delta, with their QofIdType, in
+ * the order they were last committed. Only GNC_ID_TRANS and
+ * GNC_ID_PRICE are written. */
+class GncXmlJournalChanges
+{
+public:
+    using Change = std::pair<GncGUID, QofIdTypeConst>;
+    using const_iterator = std::list<Change>::const_iterator;
+
+    GncXmlJournalChanges () = default;
+    GncXmlJournalChanges (GncXmlJournalChanges&&) = default;
+    GncXmlJournalChanges& operator= (GncXmlJournalChanges&&) = default;
+    /* m_index points into m_order, a copy would point into the original. */
+    GncXmlJournalChanges (const GncXmlJournalChanges&) = delete;
+    GncXmlJournalChanges& operator= (const GncXmlJournalChanges&) = delete;
+
+    /** Record a commit of @a guid, moving it behind every other change. */
+    void add (const GncGUID& guid, QofIdTypeConst type)
+    {
+        auto found = m_index.find (guid);
+        if (found != m_index.end ())
+        {
+            found->second->second = type;
+            m_order.splice (m_order.end (), m_order, found->second);
+            return;
+        }
+        m_index.emplace (guid, m_order.emplace (m_order.end (), guid, type));
+    }
+    void clear ()
+    {
+        m_index.clear ();
+        m_order.clear ();
+    }
+    bool empty () const { return m_order.empty (); }
+    size_t size () const { return m_order.size (); }
+    const_iterator begin () const { return m_order.begin (); }
+    const_iterator end () const { return m_order.end (); }
+
+private:
+    std::list<Change> m_order;
+    std::map<GncGUID, std::list<Change>::iterator, GncGUIDLess> m_index;
+};
+
+typedef enum
+{
+    GNC_XML_JOURNAL_NONE,       /**< There is no journal. */
+    GNC_XML_JOURNAL_STALE,      /**< The journal is for another data file. */
+    GNC_XML_JOURNAL_REPLAYED,   /**< Every delta was applied. */
+    GNC_XML_JOURNAL_TORN,       /**< A partial delta at the end was ignored. */
+    GNC_XML_JOURNAL_CORRUPT,    /**< A delta couldn't be applied. */
+} GncXmlJournalStatus;
+
+std::string gnc_xml_journal_path (const std::string& datafile);
+
+/** Get the identity of the data file @a filename. */
+bool gnc_xml_journal_stat_base (const std::string& filename,
+                                GncXmlJournalBase& base);
+
+/** Start a new journal by writing its first line. */
+bool gnc_xml_journal_write_header (FILE* out, const GncXmlJournalBase& base);
+
+/** Append one delta with the current state in @a book of each instance
+ * in @a changes, in their commit order. Instances that no longer exist
+ * are written as deleted.
+ */
+bool gnc_xml_journal_write_delta (FILE* out, QofBook* book,
+                                  const GncXmlJournalChanges& changes);
+
+/** Apply the journal @a filename to @a book, which has just been loaded
+ * from the data file identified by @a base. The deltas are applied in
+ * order, each one either completely or, if any part of it fails, not at
+ * all; replay stops at the first delta that fails.
+ *
+ * @param valid_size Set to the number of bytes of the journal that were
+ * applied, or to 0 if nothing was.
+ */
+GncXmlJournalStatus gnc_xml_journal_replay (const std::string& filename,
+                                            QofBook* book,
+                                            const GncXmlJournalBase& base,
+                                            gint64* valid_size);
+
+#endif /* IO_GNCXML_JOURNAL_H */
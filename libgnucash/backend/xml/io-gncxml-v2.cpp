@@ -1616,6 +1616,46 @@ gnc_book_write_to_xml_file_v2 (
     return success;
 }
 
+gboolean
+gnc_xml_compress_file (const char* src, const char* dest)
+{
+    gchar buffer[BUFLEN];
+    size_t bytes;
+    FILE* in;
+    FILE* out;
+    gboolean success = TRUE;
+
+    in = g_fopen (src, "rb");
+    if (!in)
+        return FALSE;
+
+    out = try_gz_open (dest, "w", TRUE, TRUE);
+    if (!out)
+    {
+        fclose (in);
+        return FALSE;
+    }
+
+    while ((bytes = fread (buffer, 1, BUFLEN, in)) > 0)
+    {
+        if (fwrite (buffer, 1, bytes, out) != bytes)
+        {
+            success = FALSE;
+            break;
+        }
+    }
+    if (ferror (in))
+        success = FALSE;
+    fclose (in);
+
+    if (fclose (out))
+        success = FALSE;
+    if (!wait_for_gzip (out))
+        success = FALSE;
+
+    return success;
+}
+
 /*
  * Have to pass in the backend as this routine needs the temporary
  * backend for file export, not the real backend which could be
@@ -93,6 +93,10 @@ gboolean gnc_book_write_to_xml_filehandle_v2 (QofBook* book, FILE* fh);
 gboolean gnc_book_write_to_xml_file_v2 (QofBook* book, const char* filename,
                                         gboolean compress);
 
+/** Write a gzip compressed copy of the file @a src to @a dest. Touches
+ * no engine data, so it may run on any thread. */
+gboolean gnc_xml_compress_file (const char* src, const char* dest);
+
 /** write just the commodities and accounts to a file */
 gboolean gnc_book_write_accounts_to_xml_filehandle_v2 (QofBackend* be,
                                                        QofBook* book, FILE* fh);
@@ -0,0 +1,441 @@
+/********************************************************************\
+ * test-xml-journal.cpp -- test the incremental save journal        *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+extern "C"
+{
+#include <config.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cashobjects.h"
+#include "gnc-engine.h"
+#include "gnc-hooks.h"
+#include "gnc-prefs.h"
+#include "gnc-pricedb.h"
+#include "Account.h"
+#include "Transaction.h"
+#include "TransactionP.h"
+#include "gncInvoice.h"
+#include "gncInvoiceP.h"
+}
+
+#include "qofinstance-p.h"
+#include "io-gncxml-journal.h"
+#include "test-stuff.h"
+
+static gnc_commodity* usd;
+static Account* bank;
+static Account* food;
+
+static void
+setup_book (QofBook* book)
+{
+    auto root = gnc_account_create_root (book);
+
+    usd = gnc_commodity_new (book, "US Dollar", "CURRENCY", "USD", "", 100);
+    usd = gnc_commodity_table_insert (gnc_commodity_table_get_table (book), usd);
+
+    bank = xaccMallocAccount (book);
+    food = xaccMallocAccount (book);
+    for (auto acc : {bank, food})
+    {
+        xaccAccountBeginEdit (acc);
+        xaccAccountSetName (acc, acc == bank ? "Bank" : "Food");
+        xaccAccountSetCommodity (acc, usd);
+        xaccAccountCommitEdit (acc);
+        gnc_account_append_child (root, acc);
+    }
+}
+
+static Transaction*
+make_trans (QofBook* book, const char* desc, gint64 cents)
+{
+    auto trans = xaccMallocTransaction (book);
+    auto value = gnc_numeric_create (cents, 100);
+
+    xaccTransBeginEdit (trans);
+    xaccTransSetCurrency (trans, usd);
+    xaccTransSetDatePostedSecsNormalized (trans, gnc_dmy2time64 (1, 3, 2019));
+    xaccTransSetDescription (trans, desc);
+    auto from = xaccMallocSplit (book);
+    xaccSplitSetParent (from, trans);
+    xaccSplitSetAccount (from, bank);
+    xaccSplitSetValue (from, gnc_numeric_neg (value));
+    xaccSplitSetAmount (from, gnc_numeric_neg (value));
+    auto to = xaccMallocSplit (book);
+    xaccSplitSetParent (to, trans);
+    xaccSplitSetAccount (to, food);
+    xaccSplitSetValue (to, value);
+    xaccSplitSetAmount (to, value);
+    xaccTransCommitEdit (trans);
+    return trans;
+}
+
+static void
+destroy_trans (Transaction* trans)
+{
+    xaccTransBeginEdit (trans);
+    xaccTransDestroy (trans);
+    xaccTransCommitEdit (trans);
+}
+
+static void
+test_journal (void)
+{
+    auto session = qof_session_new ();
+    auto book = qof_session_get_book (session);
+    auto db = gnc_pricedb_get_db (book);
+    GncXmlJournalBase base;
+    GncXmlJournalChanges changes;
+    gint64 valid_size;
+
+    setup_book (book);
+
+    /* Anything will do for the data file, it is only stat'ed. */
+    gchar* datafile = g_strdup ("test_journal_XXXXXX");
+    int fd = g_mkstemp (datafile);
+    do_test (fd >= 0 && write (fd, "base", 4) == 4, "make data file");
+    close (fd);
+    do_test (gnc_xml_journal_stat_base (datafile, base), "stat data file");
+    auto journal = gnc_xml_journal_path (datafile);
+
+    auto groceries = make_trans (book, "Groceries", 3000);
+    GncGUID groceries_guid = *qof_instance_get_guid (groceries);
+    auto rent = make_trans (book, "Rent", 50000);
+    GncGUID rent_guid = *qof_instance_get_guid (rent);
+
+    auto price = gnc_price_create (book);
+    gnc_price_begin_edit (price);
+    gnc_price_set_commodity (price, usd);
+    gnc_price_set_currency (price, usd);
+    gnc_price_set_time64 (price, gnc_dmy2time64 (1, 3, 2019));
+    gnc_price_set_source (price, PRICE_SOURCE_USER_PRICE);
+    gnc_price_set_value (price, gnc_numeric_create (3, 2));
+    gnc_price_commit_edit (price);
+    gnc_pricedb_add_price (db, price);
+    GncGUID price_guid = *qof_instance_get_guid (price);
+    gnc_price_unref (price);
+
+    /* First save: the new transaction and the price. Second save: the
+     * rent transaction is gone. */
+    auto out = g_fopen (journal.c_str(), "wb");
+    changes.add (price_guid, GNC_ID_PRICE);
+    changes.add (groceries_guid, GNC_ID_TRANS);
+    changes.add (price_guid, GNC_ID_PRICE);
+    do_test (changes.size () == 2 &&
+             guid_equal (&changes.begin ()->first, &groceries_guid) &&
+             guid_equal (&std::next (changes.begin ())->first, &price_guid),
+             "changes kept in the order last committed");
+    do_test (gnc_xml_journal_write_header (out, base) &&
+             gnc_xml_journal_write_delta (out, book, changes),
+             "write first delta");
+    destroy_trans (rent);
+    changes.clear ();
+    changes.add (rent_guid, GNC_ID_TRANS);
+    do_test (gnc_xml_journal_write_delta (out, book, changes),
+             "write second delta");
+    fclose (out);
+
+    /* Put the book back into the state of the data file. */
+    xaccTransBeginEdit (groceries);
+    xaccTransSetDescription (groceries, "Changed");
+    xaccTransCommitEdit (groceries);
+    gnc_pricedb_remove_price (db, gnc_price_lookup (&price_guid, book));
+    rent = make_trans (book, "Rent", 50000);
+    xaccTransSetGUID (rent, &rent_guid);
+
+    auto status = gnc_xml_journal_replay (journal, book, base, &valid_size);
+    do_test (status == GNC_XML_JOURNAL_REPLAYED, "replay journal");
+    groceries = xaccTransLookup (&groceries_guid, book);
+    do_test (groceries && strcmp (xaccTransGetDescription (groceries),
+                                  "Groceries") == 0,
+             "changed transaction replayed");
+    do_test (groceries && xaccTransCountSplits (groceries) == 2,
+             "replayed transaction has its splits");
+    do_test (xaccTransLookup (&rent_guid, book) == NULL,
+             "deleted transaction replayed");
+    price = gnc_price_lookup (&price_guid, book);
+    do_test (price && gnc_numeric_equal (gnc_price_get_value (price),
+                                         gnc_numeric_create (3, 2)),
+             "price replayed");
+    do_test (gnc_pricedb_get_num_prices (db) == 1, "price added once");
+    do_test (gnc_numeric_equal (xaccAccountGetBalance (food),
+                                gnc_numeric_create (3000, 100)),
+             "balance after replay");
+
+    /* A crash while appending leaves a partial delta behind. */
+    auto full_size = valid_size;
+    out = g_fopen (journal.c_str(), "ab");
+    fputs ("<gnc-journal-delta>\n<gnc:transaction", out);
+    fclose (out);
+    status = gnc_xml_journal_replay (journal, book, base, &valid_size);
+    do_test (status == GNC_XML_JOURNAL_TORN && valid_size == full_size,
+             "partial delta ignored");
+    do_test (gnc_pricedb_get_num_prices (db) == 1, "replay is repeatable");
+
+    /* The data file was rewritten after the journal was started. */
+    auto other = base;
+    other.size++;
+    status = gnc_xml_journal_replay (journal, book, other, &valid_size);
+    do_test (status == GNC_XML_JOURNAL_STALE && valid_size == 0,
+             "journal for another file ignored");
+
+    g_unlink (journal.c_str());
+    status = gnc_xml_journal_replay (journal, book, base, &valid_size);
+    do_test (status == GNC_XML_JOURNAL_NONE, "no journal");
+
+    g_unlink (datafile);
+    g_free (datafile);
+    qof_session_end (session);
+    qof_session_destroy (session);
+}
+
+static void
+test_journal_read_only (void)
+{
+    auto session = qof_session_new ();
+    auto book = qof_session_get_book (session);
+    GncXmlJournalBase base;
+    GncXmlJournalChanges changes;
+    gint64 valid_size;
+
+    setup_book (book);
+
+    gchar* datafile = g_strdup ("test_journal_XXXXXX");
+    int fd = g_mkstemp (datafile);
+    do_test (fd >= 0 && write (fd, "base", 4) == 4, "make data file");
+    close (fd);
+    do_test (gnc_xml_journal_stat_base (datafile, base), "stat data file");
+    auto journal = gnc_xml_journal_path (datafile);
+
+    /* The data file has the transaction voided, the journal has it
+     * unvoided again. */
+    auto refund = make_trans (book, "Refund", 2000);
+    GncGUID refund_guid = *qof_instance_get_guid (refund);
+    xaccTransVoid (refund, "Mistake");
+    xaccTransUnvoid (refund);
+    auto out = g_fopen (journal.c_str(), "wb");
+    changes.add (refund_guid, GNC_ID_TRANS);
+    do_test (gnc_xml_journal_write_header (out, base) &&
+             gnc_xml_journal_write_delta (out, book, changes),
+             "write unvoid delta");
+    fclose (out);
+    xaccTransVoid (refund, "Mistake");
+
+    auto status = gnc_xml_journal_replay (journal, book, base, &valid_size);
+    do_test (status == GNC_XML_JOURNAL_REPLAYED, "replay over voided");
+    refund = xaccTransLookup (&refund_guid, book);
+    do_test (refund && !xaccTransGetVoidStatus (refund),
+             "voided transaction replaced");
+    do_test (g_list_length (xaccAccountGetSplitList (food)) == 1,
+             "voided transaction not duplicated");
+    do_test (gnc_numeric_equal (xaccAccountGetBalance (food),
+                                gnc_numeric_create (2000, 100)),
+             "balance after replay over voided");
+    auto unvoid_size = valid_size;
+
+    /* An invoice's posting is never journaled by the backend. A journal
+     * that has one anyway must not replace it, nor keep the part of the
+     * delta that came before it. */
+    auto invoice = gncInvoiceCreate (book);
+    auto posted = make_trans (book, "Posted", 5000);
+    GncGUID posted_guid = *qof_instance_get_guid (posted);
+    gncInvoiceAttachToTxn (invoice, posted);
+    xaccTransSetReadOnly (posted, "Generated from an invoice.");
+    xaccTransBeginEdit (refund);
+    xaccTransSetDescription (refund, "Refund again");
+    xaccTransCommitEdit (refund);
+    out = g_fopen (journal.c_str(), "ab");
+    changes.clear ();
+    changes.add (refund_guid, GNC_ID_TRANS);
+    changes.add (posted_guid, GNC_ID_TRANS);
+    do_test (gnc_xml_journal_write_delta (out, book, changes),
+             "write invoice delta");
+    fclose (out);
+
+    status = gnc_xml_journal_replay (journal, book, base, &valid_size);
+    do_test (status == GNC_XML_JOURNAL_CORRUPT && valid_size == unvoid_size,
+             "invoice posting not replayed");
+    refund = xaccTransLookup (&refund_guid, book);
+    do_test (refund && strcmp (xaccTransGetDescription (refund),
+                               "Refund") == 0,
+             "failed delta rolled back");
+    do_test (gncInvoiceGetPostedTxn (invoice) == posted &&
+             xaccTransLookup (&posted_guid, book) == posted,
+             "invoice keeps its posting");
+    do_test (g_list_length (xaccAccountGetSplitList (food)) == 2,
+             "invoice posting not duplicated");
+    do_test (gnc_numeric_equal (xaccAccountGetBalance (food),
+                                gnc_numeric_create (7000, 100)),
+             "balance after refused replay");
+
+    g_unlink (journal.c_str());
+    g_unlink (datafile);
+    g_free (datafile);
+    qof_session_end (session);
+    qof_session_destroy (session);
+}
+
+static void
+remove_dir (const gchar* dirname)
+{
+    auto dir = g_dir_open (dirname, 0, NULL);
+    if (dir)
+    {
+        while (auto entry = g_dir_read_name (dir))
+        {
+            auto path = g_build_filename (dirname, entry, (gchar*)NULL);
+            if (g_file_test (path, G_FILE_TEST_IS_DIR))
+                remove_dir (path);
+            else
+                g_unlink (path);
+            g_free (path);
+        }
+        g_dir_close (dir);
+    }
+    g_rmdir (dirname);
+}
+
+static QofSession*
+open_session (const gchar* uri, gboolean create)
+{
+    auto session = qof_session_new ();
+    qof_session_begin (session, uri, FALSE, create, FALSE);
+    if (!create)
+        qof_session_load (session, NULL);
+    return session;
+}
+
+static void
+close_session (QofSession* session)
+{
+    qof_session_end (session);
+    qof_session_destroy (session);
+}
+
+static bool
+has_trans (QofSession* session, const GncGUID* guid, const char* desc)
+{
+    auto trans = xaccTransLookup (guid, qof_session_get_book (session));
+    return trans && g_strcmp0 (xaccTransGetDescription (trans), desc) == 0;
+}
+
+struct SavedHookData
+{
+    const gchar *datafile;
+    int calls;
+    bool file_present;
+};
+
+static void
+saved_hook_cb (gpointer session, gpointer user_data)
+{
+    auto data = static_cast<SavedHookData*> (user_data);
+    ++data->calls;
+    data->file_present = g_file_test (data->datafile, G_FILE_TEST_IS_REGULAR);
+}
+
+static void
+test_background_save (void)
+{
+    auto dirname = g_dir_make_tmp ("test-xml-journal-XXXXXX", NULL);
+    auto datafile = g_build_filename (dirname, "book.gnucash", (gchar*)NULL);
+    auto uri = g_strconcat ("xml://", datafile, NULL);
+
+    gnc_prefs_set_file_save_compressed (TRUE);
+    gnc_prefs_set_file_save_background (TRUE);
+    gnc_prefs_set_file_save_incremental (TRUE);
+
+    /* The first save runs in the background. The transaction made while
+     * it runs goes to the journal started by the save after it. */
+    SavedHookData hook_data {datafile, 0, false};
+    gnc_hook_add_dangler (HOOK_BOOK_SAVED, saved_hook_cb, &hook_data);
+    auto session = open_session (uri, TRUE);
+    setup_book (qof_session_get_book (session));
+    qof_session_save (session, NULL);
+    do_test (hook_data.calls == 0, "no saved hook while the save runs");
+    auto during = make_trans (qof_session_get_book (session), "During", 1000);
+    GncGUID during_guid = *qof_instance_get_guid (during);
+    qof_session_save (session, NULL);
+    do_test (qof_session_get_error (session) == ERR_BACKEND_NO_ERR,
+             "save after background save");
+    do_test (hook_data.calls == 1 && hook_data.file_present,
+             "saved hook run once the file is in place");
+    gnc_hook_remove_dangler (HOOK_BOOK_SAVED, saved_hook_cb);
+    close_session (session);
+
+    session = open_session (uri, FALSE);
+    do_test (has_trans (session, &during_guid, "During"),
+             "change made during background save kept");
+
+    /* A background save that fails is retried in the foreground, with
+     * the changes made while it ran. */
+    gnc_prefs_set_file_save_incremental (FALSE);
+    auto failed = make_trans (qof_session_get_book (session), "Failed", 2000);
+    GncGUID failed_guid = *qof_instance_get_guid (failed);
+    qof_session_save (session, NULL);
+    auto retried = make_trans (qof_session_get_book (session), "Retried", 3000);
+    GncGUID retried_guid = *qof_instance_get_guid (retried);
+    /* Nothing can replace a directory. */
+    g_unlink (datafile);
+    g_mkdir (datafile, 0700);
+    qof_session_save (session, NULL);
+    do_test (qof_session_pop_error (session) != ERR_BACKEND_NO_ERR,
+             "failed background save reported");
+    g_rmdir (datafile);
+    qof_session_save (session, NULL);
+    do_test (qof_session_get_error (session) == ERR_BACKEND_NO_ERR,
+             "failed background save retried");
+    close_session (session);
+
+    session = open_session (uri, FALSE);
+    do_test (has_trans (session, &during_guid, "During") &&
+             has_trans (session, &failed_guid, "Failed") &&
+             has_trans (session, &retried_guid, "Retried"),
+             "changes kept after retry");
+    close_session (session);
+
+    gnc_prefs_set_file_save_background (FALSE);
+    remove_dir (dirname);
+    g_free (uri);
+    g_free (datafile);
+    g_free (dirname);
+}
+
+int
+main (int argc, char** argv)
+{
+    g_setenv ("GNC_UNINSTALLED", "1", TRUE);
+    qof_init ();
+    cashobjects_register ();
+    do_test (qof_load_backend_library ("xml", "gncmod-backend-xml"),
+             "load xml backend");
+    test_journal ();
+    test_journal_read_only ();
+    test_background_save ();
+    print_test_results ();
+    qof_close ();
+    exit (get_rv ());
+}
@@ -32,6 +32,8 @@ static gchar *namespace_regexp    = NULL;
 static gboolean is_debugging      = FALSE;
 static gboolean extras_enabled    = FALSE;
 static gboolean use_compression   = TRUE; // This is also the default in the prefs backend
+static gboolean use_incremental   = FALSE; // This is also the default in the prefs backend
+static gboolean use_background    = FALSE; // Only the GUI has a main loop to finish the save
 static gint file_retention_policy = 1;    // 1 = "days", the default in the prefs backend
 static gint file_retention_days   = 30;   // This is also the default in the prefs backend
 
@@ -89,6 +91,30 @@ gnc_prefs_set_file_save_compressed(gboolean compressed)
     use_compression = compressed;
 }
 
+gboolean
+gnc_prefs_get_file_save_incremental(void)
+{
+    return use_incremental;
+}
+
+void
+gnc_prefs_set_file_save_incremental(gboolean incremental)
+{
+    use_incremental = incremental;
+}
+
+gboolean
+gnc_prefs_get_file_save_background(void)
+{
+    return use_background;
+}
+
+void
+gnc_prefs_set_file_save_background(gboolean background)
+{
+    use_background = background;
+}
+
 gint
 gnc_prefs_get_file_retention_policy(void)
 {
@@ -109,6 +109,16 @@ void gnc_prefs_set_extra(gboolean enabled);
 gboolean gnc_prefs_get_file_save_compressed(void);
 void gnc_prefs_set_file_save_compressed(gboolean compressed);
 
+/** Whether the XML backend may save by appending the changes to a
+ *  journal next to the data file instead of rewriting the file. */
+gboolean gnc_prefs_get_file_save_incremental(void);
+void gnc_prefs_set_file_save_incremental(gboolean incremental);
+
+/** Whether the XML backend may compress and write a saved file on a
+ *  separate thread, so that saving returns before the file is written. */
+gboolean gnc_prefs_get_file_save_background(void);
+void gnc_prefs_set_file_save_background(gboolean background);
+
 gint gnc_prefs_get_file_retention_policy(void);
 void gnc_prefs_set_file_retention_policy(gint policy);
 
@@ -43,13 +43,21 @@
 #include "gnc-features.h"
 #include "guid.hpp"
 
+#include <algorithm>
 #include <numeric>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 static QofLogModule log_module = GNC_MOD_ACCOUNT;
 
 /* The Canonical Account Separator.  Pre-Initialized. */
 static gchar account_separator[8] = ".";
 static gunichar account_uc_separator = ':';
+/* Bumped whenever the separator changes. Cached full names and the
+ * lookup indexes are rebuilt when they are older than this; renames,
+ * moves and the like update them in place. */
+static guint64 account_names_generation = 1;
 /* Predefined KVP paths */
 static const std::string KEY_ASSOC_INCOME_ACCOUNT("ofx/associated-income-account");
 static const std::string KEY_RECONCILE_INFO("reconcile-info");
@@ -64,6 +72,11 @@ static const std::string AB_BANK_CODE("bank-code");
 static const std::string AB_TRANS_RETRIEVAL("trans-retrieval");
 
 static gnc_numeric GetBalanceAsOfDate (Account *acc, time64 date, gboolean ignclosing);
+static void account_index_detach (Account *acc);
+static void account_index_attach (Account *acc);
+static void account_index_set_code (Account *acc, const char *code);
+static void account_index_forget_root (Account *root);
+static void account_full_names_forget (Account *acc);
 
 using FinalProbabilityVec=std::vector<std::pair<std::string, int32_t>>;
 using ProbabilityVec=std::vector<std::pair<std::string, struct AccountProbability>>;
@@ -167,12 +180,14 @@ gnc_set_account_separator (const gchar *separator)
     {
         account_uc_separator = ':';
         strcpy(account_separator, ":");
+        ++account_names_generation;
         return;
     }
 
     account_uc_separator = uc;
     count = g_unichar_to_utf8(uc, account_separator);
     account_separator[count] = '\0';
+    ++account_names_generation;
 }
 
 gchar *gnc_account_name_violations_errmsg (const gchar *separator, GList* invalid_account_names)
@@ -270,6 +285,8 @@ gnc_account_init(Account* acc)
     priv->accountName = static_cast<char*>(qof_string_cache_insert(""));
     priv->accountCode = static_cast<char*>(qof_string_cache_insert(""));
     priv->description = static_cast<char*>(qof_string_cache_insert(""));
+    priv->full_name = NULL;
+    priv->full_name_generation = 0;
 
     priv->type = ACCT_TYPE_NONE;
 
@@ -277,6 +294,8 @@ gnc_account_init(Account* acc)
 
     priv->policy = xaccGetFIFOPolicy();
     priv->lots = NULL;
+    priv->open_lots = NULL;
+    priv->open_lot_nodes = NULL;
 
     priv->commodity = NULL;
     priv->commodity_scu = 0;
@@ -1216,6 +1235,16 @@ xaccFreeOneChildAccount (Account *acc, gpointer dummy)
     xaccAccountDestroy(acc);
 }
 
+static void
+free_open_lots (AccountPrivate *priv)
+{
+    g_list_free (priv->open_lots);
+    priv->open_lots = NULL;
+    if (priv->open_lot_nodes)
+        g_hash_table_destroy (priv->open_lot_nodes);
+    priv->open_lot_nodes = NULL;
+}
+
 static void
 xaccFreeAccountChildren (Account *acc)
 {
@@ -1272,6 +1301,7 @@ xaccFreeAccount (Account *acc)
         g_list_free (priv->lots);
         priv->lots = NULL;
     }
+    free_open_lots (priv);
 
     /* Next, clean up the splits */
     /* NB there shouldn't be any splits by now ... they should
@@ -1298,10 +1328,16 @@ xaccFreeAccount (Account *acc)
 */
     }
 
+    if (priv->parent)
+        account_index_detach (acc);
+    else
+        account_index_forget_root (acc);
     qof_string_cache_remove(priv->accountName);
     qof_string_cache_remove(priv->accountCode);
     qof_string_cache_remove(priv->description);
     priv->accountName = priv->accountCode = priv->description = nullptr;
+    g_free (priv->full_name);
+    priv->full_name = nullptr;
 
     /* zero out values, just in case stray
      * pointers are pointing here. */
@@ -1437,6 +1473,7 @@ xaccAccountCommitEdit (Account *acc)
         }
         g_list_free(priv->lots);
         priv->lots = NULL;
+        free_open_lots (priv);
 
         qof_instance_set_dirty(&acc->inst);
         qof_instance_decrease_editlevel(acc);
@@ -1982,6 +2019,54 @@ gnc_account_set_policy (Account *acc, GNCPolicy *policy)
 /********************************************************************\
 \********************************************************************/
 
+void
+gnc_account_lot_closed_changed (Account *acc, GNCLot *lot, gboolean is_closed)
+{
+    AccountPrivate *priv;
+    GList *node;
+
+    g_return_if_fail(GNC_IS_ACCOUNT(acc));
+
+    priv = GET_PRIVATE(acc);
+    if (!priv->open_lot_nodes)
+        priv->open_lot_nodes = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    node = static_cast<GList*>(g_hash_table_lookup (priv->open_lot_nodes, lot));
+    if (is_closed && node)
+    {
+        priv->open_lots = g_list_delete_link (priv->open_lots, node);
+        g_hash_table_remove (priv->open_lot_nodes, lot);
+    }
+    else if (!is_closed && !node)
+    {
+        /* Keep the open lots in the order of priv->lots, which decides
+         * between lots that the policies and sort functions consider
+         * equal: put the lot right after the nearest open lot in front
+         * of it. */
+        GList *prev = NULL;
+        for (GList *lnode = priv->lots; lnode && lnode->data != lot;
+             lnode = lnode->next)
+        {
+            auto open_node = static_cast<GList*>(g_hash_table_lookup (priv->open_lot_nodes,
+                                                                      lnode->data));
+            if (open_node)
+                prev = open_node;
+        }
+        if (prev)
+        {
+            priv->open_lots = g_list_insert_before (priv->open_lots,
+                                                    prev->next, lot);
+            node = prev->next;
+        }
+        else
+        {
+            priv->open_lots = g_list_prepend (priv->open_lots, lot);
+            node = priv->open_lots;
+        }
+        g_hash_table_insert (priv->open_lot_nodes, lot, node);
+    }
+}
+
 void
 xaccAccountRemoveLot (Account *acc, GNCLot *lot)
 {
@@ -1995,6 +2080,7 @@ xaccAccountRemoveLot (Account *acc, GNCLot *lot)
 
     ENTER ("(acc=%p, lot=%p)", acc, lot);
     priv->lots = g_list_remove(priv->lots, lot);
+    gnc_account_lot_closed_changed (acc, lot, TRUE);
     qof_event_gen (QOF_INSTANCE(lot), QOF_EVENT_REMOVE, NULL);
     qof_event_gen (&acc->inst, QOF_EVENT_MODIFY, NULL);
     LEAVE ("(acc=%p, lot=%p)", acc, lot);
@@ -2024,11 +2110,13 @@ xaccAccountInsertLot (Account *acc, GNCLot *lot)
         old_acc = lot_account;
         opriv = GET_PRIVATE(old_acc);
         opriv->lots = g_list_remove(opriv->lots, lot);
+        gnc_account_lot_closed_changed (old_acc, lot, TRUE);
     }
 
     priv = GET_PRIVATE(acc);
     priv->lots = g_list_prepend(priv->lots, lot);
     gnc_lot_set_account(lot, acc);
+    gnc_account_lot_closed_changed (acc, lot, gnc_lot_is_closed (lot));
 
     /* Don't move the splits to the new account.  The caller will do this
      * if appropriate, and doing it here will not work if we are being
@@ -2319,7 +2407,10 @@ xaccAccountSetName (Account *acc, const char *str)
         return;
 
     xaccAccountBeginEdit(acc);
+    account_index_detach (acc);
     priv->accountName = qof_string_cache_replace(priv->accountName, str);
+    account_full_names_forget (acc);
+    account_index_attach (acc);
     mark_account (acc);
     xaccAccountCommitEdit(acc);
 }
@@ -2338,6 +2429,7 @@ xaccAccountSetCode (Account *acc, const char *str)
         return;
 
     xaccAccountBeginEdit(acc);
+    account_index_set_code (acc, str ? str : "");
     priv->accountCode = qof_string_cache_replace(priv->accountCode, str ? str : "");
     mark_account (acc);
     xaccAccountCommitEdit(acc);
@@ -2634,6 +2726,9 @@ gnc_account_append_child (Account *new_parent, Account *child)
     }
     cpriv->parent = new_parent;
     ppriv->children = g_list_append(ppriv->children, child);
+    account_index_forget_root (child);
+    account_full_names_forget (child);
+    account_index_attach (child);
     qof_instance_set_dirty(&new_parent->inst);
     qof_instance_set_dirty(&child->inst);
 
@@ -2673,6 +2768,7 @@ gnc_account_remove_child (Account *parent, Account *child)
     ed.node = parent;
     ed.idx = g_list_index(ppriv->children, child);
 
+    account_index_detach (child);
     ppriv->children = g_list_remove(ppriv->children, child);
 
     /* Now send the event. */
@@ -2680,6 +2776,7 @@ gnc_account_remove_child (Account *parent, Account *child)
 
     /* clear the account's parent pointer after REMOVE event generation. */
     cpriv->parent = NULL;
+    account_full_names_forget (child);
 
     qof_event_gen (&parent->inst, QOF_EVENT_MODIFY, NULL);
 }
@@ -2864,8 +2961,238 @@ gnc_account_get_descendants_sorted (const Account *account)
     return descendants;
 }
 
-Account *
-gnc_account_lookup_by_name (const Account *parent, const char * name)
+/********************************************************************\
+ * The lookup index                                                 *
+\********************************************************************/
+
+/* The accounts below one root by full name, name and code. None of
+ * them need be unique; where there are several accounts under a key
+ * the lookups fall back to searching the tree, which knows which of
+ * them to prefer. */
+using AccountTable = std::unordered_map<std::string, std::vector<Account*>>;
+
+struct AccountTreeIndex
+{
+    AccountTable by_full_name;
+    AccountTable by_name;
+    AccountTable by_code;
+};
+
+/* Kept per book and per tree, and updated in place as accounts are
+ * renamed, recoded, moved and freed, so that creating accounts one
+ * after another while looking them up, as the importers do, doesn't
+ * rebuild it every time. */
+struct AccountLookupIndex
+{
+    guint64 generation = 0;
+    std::unordered_map<const Account*, AccountTreeIndex> trees;
+};
+
+#define GNC_ACCOUNT_LOOKUP_INDEX "gnc-account-lookup-index"
+
+static void
+account_lookup_index_free (QofBook *book, gpointer key, gpointer data)
+{
+    delete static_cast<AccountLookupIndex*>(data);
+}
+
+static void
+account_table_erase (AccountTable& table, const char *key, Account *acc)
+{
+    auto entry = table.find (key ? key : "");
+    if (entry == table.end ())
+        return;
+    auto& accounts = entry->second;
+    accounts.erase (std::remove (accounts.begin (), accounts.end (), acc),
+                    accounts.end ());
+    if (accounts.empty ())
+        table.erase (entry);
+}
+
+/* A full name is split at the separator before it is looked up, so an
+ * account with the separator in its path can't be found by it. */
+static bool
+account_name_in_path_ok (const Account *acc)
+{
+    auto name = GET_PRIVATE(acc)->accountName;
+    return !name || !strstr (name, account_separator);
+}
+
+static void
+account_tree_index_insert (AccountTreeIndex& index, Account *acc,
+                           bool path_ok)
+{
+    auto priv = GET_PRIVATE(acc);
+
+    path_ok = path_ok && account_name_in_path_ok (acc);
+    if (path_ok)
+        index.by_full_name[gnc_account_peek_full_name (acc)].push_back (acc);
+    index.by_name[priv->accountName ? priv->accountName : ""].push_back (acc);
+    index.by_code[priv->accountCode ? priv->accountCode : ""].push_back (acc);
+    for (auto node = priv->children; node; node = node->next)
+        account_tree_index_insert (index, static_cast<Account*>(node->data),
+                                   path_ok);
+}
+
+/* Must run before anything that changes the keys @a acc and its
+ * descendants were inserted under. */
+static void
+account_tree_index_remove (AccountTreeIndex& index, Account *acc)
+{
+    auto priv = GET_PRIVATE(acc);
+
+    account_table_erase (index.by_full_name, gnc_account_peek_full_name (acc),
+                         acc);
+    account_table_erase (index.by_name, priv->accountName, acc);
+    account_table_erase (index.by_code, priv->accountCode, acc);
+    for (auto node = priv->children; node; node = node->next)
+        account_tree_index_remove (index, static_cast<Account*>(node->data));
+}
+
+static const Account *
+account_get_root (const Account *acc)
+{
+    while (GET_PRIVATE(acc)->parent)
+        acc = GET_PRIVATE(acc)->parent;
+    return acc;
+}
+
+/* The book's index, or nullptr if there can't be one or @a create is
+ * false and there isn't one yet. */
+static AccountLookupIndex*
+account_lookup_index (const Account *root, bool create)
+{
+    auto book = qof_instance_get_book (root);
+    if (!book || qof_book_shutting_down (book))
+        return nullptr;
+
+    auto index = static_cast<AccountLookupIndex*>
+        (qof_book_get_data (book, GNC_ACCOUNT_LOOKUP_INDEX));
+    if (!index)
+    {
+        if (!create)
+            return nullptr;
+        index = new AccountLookupIndex;
+        qof_book_set_data_fin (book, GNC_ACCOUNT_LOOKUP_INDEX, index,
+                               account_lookup_index_free);
+    }
+    if (index->generation != account_names_generation)
+    {
+        index->trees.clear ();
+        index->generation = account_names_generation;
+    }
+    return index;
+}
+
+/* The index of the tree @a acc is in if it has been built already. */
+static AccountTreeIndex*
+account_tree_index_peek (const Account *acc)
+{
+    auto root = account_get_root (acc);
+    auto index = account_lookup_index (root, false);
+    if (!index)
+        return nullptr;
+    auto tree = index->trees.find (root);
+    return tree == index->trees.end () ? nullptr : &tree->second;
+}
+
+/* The index of the tree @a acc is in, or nullptr if there can't be one. */
+static const AccountTreeIndex*
+account_tree_index (const Account *acc)
+{
+    auto root = account_get_root (acc);
+    auto index = account_lookup_index (root, true);
+    if (!index)
+        return nullptr;
+
+    auto tree = index->trees.find (root);
+    if (tree == index->trees.end ())
+    {
+        tree = index->trees.emplace (root, AccountTreeIndex ()).first;
+        for (auto node = GET_PRIVATE(root)->children; node; node = node->next)
+            account_tree_index_insert (tree->second,
+                                       static_cast<Account*>(node->data),
+                                       true);
+    }
+    return &tree->second;
+}
+
+/* Take @a acc and its descendants out of their tree's index. */
+static void
+account_index_detach (Account *acc)
+{
+    if (!GET_PRIVATE(acc)->parent)
+        return;
+    auto index = account_tree_index_peek (acc);
+    if (index)
+        account_tree_index_remove (*index, acc);
+}
+
+/* Put @a acc and its descendants back into their tree's index. */
+static void
+account_index_attach (Account *acc)
+{
+    auto parent = GET_PRIVATE(acc)->parent;
+    if (!parent)
+        return;
+    auto index = account_tree_index_peek (acc);
+    if (!index)
+        return;
+
+    auto path_ok = true;
+    for (auto anc = parent; GET_PRIVATE(anc)->parent;
+         anc = GET_PRIVATE(anc)->parent)
+        path_ok = path_ok && account_name_in_path_ok (anc);
+    account_tree_index_insert (*index, acc, path_ok);
+}
+
+static void
+account_index_set_code (Account *acc, const char *code)
+{
+    if (!GET_PRIVATE(acc)->parent)
+        return;
+    auto index = account_tree_index_peek (acc);
+    if (!index)
+        return;
+    account_table_erase (index->by_code, GET_PRIVATE(acc)->accountCode, acc);
+    index->by_code[code].push_back (acc);
+}
+
+/* @a root is joining another tree or going away. */
+static void
+account_index_forget_root (Account *root)
+{
+    auto index = account_lookup_index (root, false);
+    if (index)
+        index->trees.erase (root);
+}
+
+/* Find the one account in @a table under @a key that descends from
+ * @a parent. If there are several the search falls back to @a search,
+ * which knows which of them to prefer. */
+static Account *
+account_index_lookup (const AccountTable& table,
+                      const Account *parent, const char *key,
+                      Account *(*search)(const Account*, const char*))
+{
+    Account *found = nullptr;
+
+    auto entry = table.find (key);
+    if (entry == table.end ())
+        return nullptr;
+    for (auto acc : entry->second)
+    {
+        if (acc == parent || !xaccAccountHasAncestor (acc, parent))
+            continue;
+        if (found)
+            return search (parent, key);
+        found = acc;
+    }
+    return found;
+}
+
+static Account *
+account_search_by_name (const Account *parent, const char * name)
 {
     AccountPrivate *cpriv, *ppriv;
     Account *child, *result;
@@ -2889,7 +3216,7 @@ gnc_account_lookup_by_name (const Account *parent, const char * name)
     for (node = ppriv->children; node; node = node->next)
     {
         child = static_cast<Account*>(node->data);
-        result = gnc_account_lookup_by_name (child, name);
+        result = account_search_by_name (child, name);
         if (result)
             return result;
     }
@@ -2897,8 +3224,8 @@ gnc_account_lookup_by_name (const Account *parent, const char * name)
     return NULL;
 }
 
-Account *
-gnc_account_lookup_by_code (const Account *parent, const char * code)
+static Account *
+account_search_by_code (const Account *parent, const char * code)
 {
     AccountPrivate *cpriv, *ppriv;
     Account *child, *result;
@@ -2922,7 +3249,7 @@ gnc_account_lookup_by_code (const Account *parent, const char * code)
     for (node = ppriv->children; node; node = node->next)
     {
         child = static_cast<Account*>(node->data);
-        result = gnc_account_lookup_by_code (child, code);
+        result = account_search_by_code (child, code);
         if (result)
             return result;
     }
@@ -2930,6 +3257,36 @@ gnc_account_lookup_by_code (const Account *parent, const char * code)
     return NULL;
 }
 
+Account *
+gnc_account_lookup_by_name (const Account *parent, const char * name)
+{
+    const AccountTreeIndex *index;
+
+    g_return_val_if_fail(GNC_IS_ACCOUNT(parent), NULL);
+    g_return_val_if_fail(name, NULL);
+
+    index = account_tree_index (parent);
+    if (!index)
+        return account_search_by_name (parent, name);
+    return account_index_lookup (index->by_name, parent, name,
+                                 account_search_by_name);
+}
+
+Account *
+gnc_account_lookup_by_code (const Account *parent, const char * code)
+{
+    const AccountTreeIndex *index;
+
+    g_return_val_if_fail(GNC_IS_ACCOUNT(parent), NULL);
+    g_return_val_if_fail(code, NULL);
+
+    index = account_tree_index (parent);
+    if (!index)
+        return account_search_by_code (parent, code);
+    return account_index_lookup (index->by_code, parent, code,
+                                 account_search_by_code);
+}
+
 /********************************************************************\
  * Fetch an account, given its full name                            *
 \********************************************************************/
@@ -2981,6 +3338,7 @@ gnc_account_lookup_by_full_name (const Account *any_acc,
                                  const gchar *name)
 {
     const AccountPrivate *rpriv;
+    const AccountTreeIndex *index;
     const Account *root;
     Account *found;
     gchar **names;
@@ -2988,6 +3346,19 @@ gnc_account_lookup_by_full_name (const Account *any_acc,
     g_return_val_if_fail(GNC_IS_ACCOUNT(any_acc), NULL);
     g_return_val_if_fail(name, NULL);
 
+    index = account_tree_index (any_acc);
+    if (index)
+    {
+        /* An empty name splits into no names at all. */
+        if (!*name)
+            return nullptr;
+        auto entry = index->by_full_name.find (name);
+        if (entry == index->by_full_name.end ())
+            return nullptr;
+        if (entry->second.size () == 1)
+            return entry->second.front ();
+    }
+
     root = any_acc;
     rpriv = GET_PRIVATE(root);
     while (rpriv->parent)
@@ -3099,52 +3470,53 @@ xaccAccountGetName (const Account *acc)
     return GET_PRIVATE(acc)->accountName;
 }
 
-gchar *
-gnc_account_get_full_name(const Account *account)
+const gchar *
+gnc_account_peek_full_name (const Account *account)
 {
     AccountPrivate *priv;
-    const Account *a;
-    char *fullname;
-    gchar **names;
-    int level;
 
     /* So much for hardening the API. Too many callers to this function don't
      * bother to check if they have a non-NULL pointer before calling. */
     if (NULL == account)
-        return g_strdup("");
+        return "";
 
     /* errors */
-    g_return_val_if_fail(GNC_IS_ACCOUNT(account), g_strdup(""));
+    g_return_val_if_fail(GNC_IS_ACCOUNT(account), "");
 
-    /* optimizations */
     priv = GET_PRIVATE(account);
-    if (!priv->parent)
-        return g_strdup("");
+    if (priv->full_name_generation == account_names_generation)
+        return priv->full_name;
 
-    /* Figure out how much space is needed by counting the nodes up to
-     * the root. */
-    level = 0;
-    for (a = account; a; a = priv->parent)
-    {
-        priv = GET_PRIVATE(a);
-        level++;
-    }
+    /* The root account's name isn't part of anyone's full name, and the
+     * parent's full name is cached too so only the last part is new. */
+    g_free (priv->full_name);
+    if (!priv->parent)
+        priv->full_name = g_strdup ("");
+    else if (!GET_PRIVATE(priv->parent)->parent)
+        priv->full_name = g_strdup (priv->accountName);
+    else
+        priv->full_name = g_strconcat (gnc_account_peek_full_name (priv->parent),
+                                       account_separator, priv->accountName,
+                                       nullptr);
+    priv->full_name_generation = account_names_generation;
+    return priv->full_name;
+}
 
-    /* Get all the pointers in the right order. The root node "entry"
-     * becomes the terminating NULL pointer for the array of strings. */
-    names = (gchar **)g_malloc(level * sizeof(gchar *));
-    names[--level] = NULL;
-    for (a = account; level > 0; a = priv->parent)
-    {
-        priv = GET_PRIVATE(a);
-        names[--level] = priv->accountName;
-    }
+/* Renaming or moving an account changes the full names below it too. */
+static void
+account_full_names_forget (Account *acc)
+{
+    auto priv = GET_PRIVATE(acc);
 
-    /* Build the full name */
-    fullname =  g_strjoinv(account_separator, names);
-    g_free(names);
+    priv->full_name_generation = 0;
+    for (auto node = priv->children; node; node = node->next)
+        account_full_names_forget (static_cast<Account*>(node->data));
+}
 
-    return fullname;
+gchar *
+gnc_account_get_full_name(const Account *account)
+{
+    return g_strdup (gnc_account_peek_full_name (account));
 }
 
 const char *
@@ -3300,6 +3672,7 @@ gnc_numeric
 xaccAccountGetBalance (const Account *acc)
 {
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
+    qof_instance_record_read (acc);
     return GET_PRIVATE(acc)->balance;
 }
 
@@ -3307,6 +3680,7 @@ gnc_numeric
 xaccAccountGetClearedBalance (const Account *acc)
 {
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
+    qof_instance_record_read (acc);
     return GET_PRIVATE(acc)->cleared_balance;
 }
 
@@ -3314,6 +3688,7 @@ gnc_numeric
 xaccAccountGetReconciledBalance (const Account *acc)
 {
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
+    qof_instance_record_read (acc);
     return GET_PRIVATE(acc)->reconciled_balance;
 }
 
@@ -3328,6 +3703,7 @@ xaccAccountGetProjectedMinimumBalance (const Account *acc)
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
 
+    qof_instance_record_read (acc);
     priv = GET_PRIVATE(acc);
     today = gnc_time64_get_today_end();
     for (node = g_list_last(priv->splits); node; node = node->prev)
@@ -3368,6 +3744,7 @@ GetBalanceAsOfDate (Account *acc, time64 date, gboolean ignclosing)
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
 
+    qof_instance_record_read (acc);
     xaccAccountSortSplits (acc, TRUE); /* just in case, normally a noop */
     xaccAccountRecomputeBalance (acc); /* just in case, normally a noop */
 
@@ -3406,6 +3783,7 @@ xaccAccountGetReconciledBalanceAsOfDate (Account *acc, time64 date)
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), gnc_numeric_zero());
 
+    qof_instance_record_read (acc);
     for (GList *node = GET_PRIVATE(acc)->splits; node; node = node->next)
     {
         Split *split = (Split*) node->data;
@@ -3777,6 +4155,7 @@ SplitList *
 xaccAccountGetSplitList (const Account *acc)
 {
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), NULL);
+    qof_instance_record_read (acc);
     xaccAccountSortSplits((Account*)acc, FALSE);  // normally a noop
     return GET_PRIVATE(acc)->splits;
 }
@@ -3803,6 +4182,7 @@ LotList *
 xaccAccountGetLotList (const Account *acc)
 {
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), NULL);
+    qof_instance_record_read (acc);
     return g_list_copy(GET_PRIVATE(acc)->lots);
 }
 
@@ -3812,16 +4192,18 @@ xaccAccountFindOpenLots (const Account *acc,
                                  gpointer user_data),
                          gpointer user_data, GCompareFunc sort_func)
 {
-    AccountPrivate *priv;
-    GList *lot_list;
+    GList *lot_list, *node;
     GList *retval = NULL;
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), NULL);
 
-    priv = GET_PRIVATE(acc);
-    for (lot_list = priv->lots; lot_list; lot_list = lot_list->next)
+    qof_instance_record_read (acc);
+    /* Checking whether a lot is closed may drop it from the open lots,
+     * so walk a copy. */
+    lot_list = g_list_copy (GET_PRIVATE(acc)->open_lots);
+    for (node = lot_list; node; node = node->next)
     {
-        GNCLot *lot = static_cast<GNCLot*>(lot_list->data);
+        GNCLot *lot = static_cast<GNCLot*>(node->data);
 
         /* If this lot is closed, then ignore it */
         if (gnc_lot_is_closed (lot))
@@ -3831,11 +4213,14 @@ xaccAccountFindOpenLots (const Account *acc,
             continue;
 
         /* Ok, this is a valid lot.  Add it to our list of lots */
-        if (sort_func)
-            retval = g_list_insert_sorted (retval, lot, sort_func);
-        else
-            retval = g_list_prepend (retval, lot);
+        retval = g_list_prepend (retval, lot);
     }
+    g_list_free (lot_list);
+
+    /* g_list_sort is stable, so lots that compare equal come out in the
+     * same order as inserting each one with g_list_insert_sorted. */
+    if (sort_func)
+        retval = g_list_sort (retval, sort_func);
 
     return retval;
 }
@@ -3851,6 +4236,7 @@ xaccAccountForEachLot(const Account *acc,
     g_return_val_if_fail(GNC_IS_ACCOUNT(acc), NULL);
     g_return_val_if_fail(proc, NULL);
 
+    qof_instance_record_read (acc);
     priv = GET_PRIVATE(acc);
     for (node = priv->lots; node; node = node->next)
         if ((result = proc((GNCLot *)node->data, data)))
@@ -3859,6 +4245,30 @@ xaccAccountForEachLot(const Account *acc,
     return result;
 }
 
+gpointer
+xaccAccountForEachOpenLot (const Account *acc,
+                           gpointer (*proc)(GNCLot *lot, void *data), void *data)
+{
+    LotList *lot_list, *node;
+    gpointer result = NULL;
+
+    g_return_val_if_fail(GNC_IS_ACCOUNT(acc), NULL);
+    g_return_val_if_fail(proc, NULL);
+
+    lot_list = g_list_copy (GET_PRIVATE(acc)->open_lots);
+    for (node = lot_list; node; node = node->next)
+    {
+        GNCLot *lot = static_cast<GNCLot*>(node->data);
+        if (gnc_lot_is_closed (lot))
+            continue;
+        if ((result = proc(lot, data)))
+            break;
+    }
+    g_list_free (lot_list);
+
+    return result;
+}
+
 static void
 set_boolean_key (Account *acc, std::vector<std::string> const & path, gboolean option)
 {
@@ -5115,6 +5525,7 @@ xaccAccountForEachTransaction(const Account *acc, TransactionCallback proc,
                               void *data)
 {
     if (!acc || !proc) return 0;
+    qof_instance_record_read (acc);
     xaccAccountBeginStagedTransactionTraversals (acc);
     return xaccAccountStagedTransactionTraversal(acc, 42, proc, data);
 }
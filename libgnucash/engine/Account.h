@@ -430,6 +430,14 @@ void xaccAccountSortSplits (Account *acc, gboolean force);
  */
 gchar * gnc_account_get_full_name (const Account *account);
 
+/** Like gnc_account_get_full_name(), but returns a string kept by the
+ * account which must not be freed. The account builds it once and
+ * builds it again only after some account has been renamed, recoded,
+ * moved or freed or the separator has changed, so the string is only
+ * good until then; copy it if you need it for longer.
+ */
+const gchar * gnc_account_peek_full_name (const Account *account);
+
 /** Retrieve the gains account used by this account for the indicated
  * currency, creating and recording a new one if necessary.
  *
@@ -897,6 +905,11 @@ gboolean xaccAccountHasAncestor(const Account *acc, const Account *ancestor);
 /** @} */
 
 /** @name Lookup Accounts and Subaccounts by name or code
+
+ These look the account up in an index of its tree that the book
+ keeps, instead of walking the tree. The index is built the first time
+ it is used and kept up to date as accounts are renamed, recoded, moved
+ or freed.
  @{
 */
 /** The gnc_account_lookup_by_name() subroutine fetches the account by
@@ -913,6 +926,11 @@ Account *gnc_account_lookup_by_name (const Account *parent, const char *name);
 /** The gnc_account_lookup_full_name() subroutine works like
  *  gnc_account_lookup_by_name, but uses fully-qualified names using the
  *  given separator.
+ *
+ *  An account whose full name is unique is always found. The old tree
+ *  walk gave up when the first of several same-named siblings along
+ *  the path had no children, even if a later one had the account; it
+ *  is still used to choose between accounts sharing a full name.
  */
 Account *gnc_account_lookup_by_full_name (const Account *any_account,
         const gchar *name);
@@ -1101,6 +1119,14 @@ gpointer xaccAccountForEachLot(
     const Account *acc,
     gpointer (*proc)(GNCLot *lot, gpointer user_data), /*@ null @*/ gpointer user_data);
 
+/** The xaccAccountForEachOpenLot() method is like xaccAccountForEachLot()
+ *    but only visits the lots that are not closed. The account keeps
+ *    track of those, so closed lots cost nothing to skip.
+ */
+gpointer xaccAccountForEachOpenLot(
+    const Account *acc,
+    gpointer (*proc)(GNCLot *lot, gpointer user_data), /*@ null @*/ gpointer user_data);
+
 
 /** Find a list of open lots that match the match_func.  Sort according
  * to sort_func.  If match_func is NULL, then all open lots are returned.
@@ -63,6 +63,10 @@ typedef struct AccountPrivate
      * is displayed by the GUI as the account mnemonic.
      */
     char *accountName;
+    /* The accountName joined to those of its ancestors, built on
+     * demand by gnc_account_peek_full_name. */
+    char *full_name;
+    guint64 full_name_generation;
 
     /* The accountCode is an arbitrary string assigned by the user.
      * It is intended to be reporting code that is a synonym for the
@@ -120,6 +124,11 @@ typedef struct AccountPrivate
     gboolean sort_dirty;        /* sort order of splits is bad */
 
     LotList   *lots;		/* list of lot pointers */
+    /* The lots not known to be closed, and for each of them its node
+     * in open_lots. Maintained by the lot code so that looking for an
+     * open lot doesn't have to visit every closed one. */
+    LotList   *open_lots;
+    GHashTable *open_lot_nodes;
     GNCPolicy *policy;		/* Cached pointer to policy method */
 
     /* The "mark" flag can be used by the user to mark this account
@@ -141,6 +150,11 @@ void xaccAccountSetGUID (Account *account, const GncGUID *guid);
 /* Register Accounts with the engine */
 gboolean xaccAccountRegister (void);
 
+/* Called by the lot code when one of the account's lots becomes closed
+ * or may have been reopened. */
+void gnc_account_lot_closed_changed (Account *acc, GNCLot *lot,
+                                     gboolean is_closed);
+
 /* Structure for accessing static functions for testing */
 typedef struct
 {
@@ -47,9 +47,11 @@
 #include "Account.h"
 #include "AccountP.h"
 #include "Scrub.h"
+#include "Scrub3.h"
 #include "ScrubP.h"
 #include "Transaction.h"
 #include "TransactionP.h"
+#include "cap-gains.h"
 #include "gnc-commodity.h"
 #include "qofinstance-p.h"
 
@@ -121,7 +123,7 @@ xaccAccountScrubOrphans (Account *acc, QofPercentageFunc percentagefunc)
     {
         Split *split = node->data;
 
-        if (current_split % 100 == 0)
+        if (percentagefunc && current_split % 100 == 0)
         {
             char *progress_msg = g_strdup_printf (message, str, current_split, total_splits);
             (percentagefunc)(progress_msg, (100 * current_split) / total_splits);
@@ -132,7 +134,8 @@ xaccAccountScrubOrphans (Account *acc, QofPercentageFunc percentagefunc)
                                gnc_account_get_root (acc));
         current_split++;
     }
-    (percentagefunc)(NULL, -1.0);
+    if (percentagefunc)
+        (percentagefunc)(NULL, -1.0);
 }
 
 
@@ -320,7 +323,7 @@ xaccAccountScrubImbalance (Account *acc, QofPercentageFunc percentagefunc)
         PINFO("Start processing split %d of %d",
               curr_split_no + 1, split_count);
 
-        if (curr_split_no % 100 == 0)
+        if (percentagefunc && curr_split_no % 100 == 0)
         {
             char *progress_msg = g_strdup_printf (message, str, curr_split_no, split_count);
             (percentagefunc)(progress_msg, (100 * curr_split_no) / split_count);
@@ -329,7 +332,8 @@ xaccAccountScrubImbalance (Account *acc, QofPercentageFunc percentagefunc)
 
         TransScrubOrphansFast (xaccSplitGetParent (split),
                                gnc_account_get_root (acc));
-        (percentagefunc)(NULL, 0.0);
+        if (percentagefunc)
+            (percentagefunc)(NULL, 0.0);
 
         xaccTransScrubCurrency(trans);
 
@@ -339,7 +343,269 @@ xaccAccountScrubImbalance (Account *acc, QofPercentageFunc percentagefunc)
               curr_split_no + 1, split_count);
         curr_split_no++;
     }
-    (percentagefunc)(NULL, -1.0);
+    if (percentagefunc)
+        (percentagefunc)(NULL, -1.0);
+}
+
+/* ================================================================ */
+/* Checking a whole tree.
+ *
+ * The per-account scrubs above visit a transaction once for every
+ * split it has in the tree and run every repair on it whether it is
+ * needed or not.  xaccAccountTreeScrub() collects each transaction in
+ * the tree once and checks it with a read-only test, spread over a
+ * thread pool.  Only the transactions that fail the test are then
+ * repaired, one at a time in the calling thread.
+ */
+
+static gboolean abort_now = FALSE;
+
+void
+gnc_set_abort_scrub (gboolean abort)
+{
+    abort_now = abort;
+}
+
+gboolean
+gnc_get_abort_scrub (void)
+{
+    return abort_now;
+}
+
+#define SCRUB_CHUNK_SIZE 4096
+
+typedef struct
+{
+    GHashTable *seen;
+    GPtrArray *trans;            /* Each transaction in the tree once. */
+    guint8 *needs_repair;        /* One flag per entry of trans. */
+    GList *commodity_accounts;   /* Accounts without a commodity. */
+    GList *lot_accounts;         /* Accounts with trades. */
+    gboolean scrub_lots;
+    gboolean trading;
+} ScrubPlan;
+
+typedef struct
+{
+    guint start;
+    guint end;
+} ScrubChunk;
+
+/* TRUE if TransScrubOrphansFast, xaccTransScrubCurrency or
+ * xaccTransScrubImbalance might change the transaction.  It may say
+ * TRUE for a transaction that turns out to be fine, but never FALSE
+ * for one that is not.  It runs in the thread pool, so it must only
+ * read the transaction, its splits and their accounts. */
+static gboolean
+trans_needs_repair (const Transaction *trans, gboolean trading)
+{
+    gnc_commodity *currency = trans->common_currency;
+    gnc_numeric imbalance = gnc_numeric_zero ();
+    GList *node;
+
+    if (!currency || !gnc_commodity_is_currency (currency))
+        return TRUE;
+
+    for (node = trans->splits; node; node = node->next)
+    {
+        Split *split = node->data;
+        gnc_commodity *acc_commodity;
+
+        if (qof_instance_get_destroying (split))
+            continue;
+        if (!split->acc)
+            return TRUE;
+        if (gnc_numeric_check (split->value) ||
+            gnc_numeric_check (split->amount))
+            return TRUE;
+
+        acc_commodity = xaccAccountGetCommodity (split->acc);
+        if (!acc_commodity)
+            return TRUE;
+        if (gnc_commodity_equiv (acc_commodity, currency))
+        {
+            if (!gnc_numeric_equal (split->amount, split->value))
+                return TRUE;
+        }
+        /* With trading accounts every commodity has to balance on its
+         * own; leave that to xaccTransScrubImbalance. */
+        else if (trading)
+            return TRUE;
+        if (trading && xaccAccountGetType (split->acc) == ACCT_TYPE_TRADING)
+            return TRUE;
+
+        imbalance = gnc_numeric_add (imbalance, split->value,
+                                     GNC_DENOM_AUTO, GNC_HOW_DENOM_EXACT);
+    }
+    return !gnc_numeric_zero_p (imbalance);
+}
+
+static void
+scrub_check_chunk (gpointer data, gpointer user_data)
+{
+    ScrubChunk *chunk = data;
+    ScrubPlan *plan = user_data;
+    guint i;
+
+    for (i = chunk->start; i < chunk->end; i++)
+        plan->needs_repair[i] =
+            trans_needs_repair (g_ptr_array_index (plan->trans, i),
+                                plan->trading);
+}
+
+static void
+scrub_plan_add_account (Account *acc, gpointer data)
+{
+    ScrubPlan *plan = data;
+    GList *node;
+
+    if (!xaccAccountGetCommodity (acc) &&
+        xaccAccountGetType (acc) != ACCT_TYPE_ROOT)
+        plan->commodity_accounts = g_list_prepend (plan->commodity_accounts,
+                                                   acc);
+    if (plan->scrub_lots && xaccAccountHasTrades (acc))
+        plan->lot_accounts = g_list_prepend (plan->lot_accounts, acc);
+
+    for (node = xaccAccountGetSplitList (acc); node; node = node->next)
+    {
+        Transaction *trans = xaccSplitGetParent (node->data);
+
+        if (!trans || g_hash_table_lookup (plan->seen, trans))
+            continue;
+        g_hash_table_insert (plan->seen, trans, trans);
+        g_ptr_array_add (plan->trans, trans);
+    }
+}
+
+static void
+scrub_progress (QofPercentageFunc percentagefunc, const char *message,
+                guint current, guint total)
+{
+    char *progress_msg;
+
+    if (!percentagefunc || total == 0)
+        return;
+    progress_msg = g_strdup_printf (message, current, total);
+    (percentagefunc)(progress_msg, (100.0 * current) / total);
+    g_free (progress_msg);
+}
+
+/* Run trans_needs_repair over every transaction in the plan. Returns
+ * FALSE if the scrub was aborted. */
+static gboolean
+scrub_plan_check (ScrubPlan *plan, QofPercentageFunc percentagefunc)
+{
+    const char *message = _("Checking transactions: %u of %u");
+    guint n_trans = plan->trans->len;
+    guint n_chunks = (n_trans + SCRUB_CHUNK_SIZE - 1) / SCRUB_CHUNK_SIZE;
+    guint i;
+    ScrubChunk *chunks = g_new (ScrubChunk, n_chunks);
+    GThreadPool *pool;
+
+    plan->needs_repair = g_new0 (guint8, n_trans);
+    pool = g_thread_pool_new (scrub_check_chunk, plan,
+                              g_get_num_processors (), FALSE, NULL);
+    for (i = 0; i < n_chunks; i++)
+    {
+        chunks[i].start = i * SCRUB_CHUNK_SIZE;
+        chunks[i].end = MIN (n_trans, (i + 1) * SCRUB_CHUNK_SIZE);
+        g_thread_pool_push (pool, &chunks[i], NULL);
+    }
+
+    /* The progress callback runs the GUI's main loop, whose handlers
+     * could change the transactions the pool is reading. So nothing is
+     * reported, and the scrub can't be stopped, until every chunk has
+     * been checked. */
+    g_thread_pool_free (pool, FALSE, TRUE);
+    g_free (chunks);
+    scrub_progress (percentagefunc, message, n_trans, n_trans);
+    return !abort_now;
+}
+
+/* Repair the flagged transactions. The accounts they touch are kept
+ * open until the end, so their splits are sorted and their balances
+ * recomputed once instead of after every repaired transaction. */
+static void
+scrub_plan_repair (ScrubPlan *plan, Account *root,
+                   QofPercentageFunc percentagefunc)
+{
+    const char *message = _("Repairing transactions: %u of %u");
+    GHashTable *editing = g_hash_table_new (g_direct_hash, g_direct_equal);
+    GList *accounts = NULL, *node;
+    guint n_repair = 0, n_repaired = 0, i;
+
+    for (node = plan->commodity_accounts; node; node = node->next)
+        xaccAccountScrubCommodity (node->data);
+
+    for (i = 0; i < plan->trans->len; i++)
+        n_repair += plan->needs_repair[i];
+    PINFO ("%u of %u transactions need repair", n_repair, plan->trans->len);
+
+    for (i = 0; i < plan->trans->len && !abort_now; i++)
+    {
+        Transaction *trans = g_ptr_array_index (plan->trans, i);
+
+        if (!plan->needs_repair[i])
+            continue;
+        if (n_repaired % 100 == 0)
+            scrub_progress (percentagefunc, message, n_repaired, n_repair);
+
+        for (node = trans->splits; node; node = node->next)
+        {
+            Account *acc = ((Split*)node->data)->acc;
+
+            if (!acc || g_hash_table_lookup (editing, acc))
+                continue;
+            g_hash_table_insert (editing, acc, acc);
+            xaccAccountBeginEdit (acc);
+            accounts = g_list_prepend (accounts, acc);
+        }
+
+        TransScrubOrphansFast (trans, root);
+        xaccTransScrubCurrency (trans);
+        xaccTransScrubImbalance (trans, root, NULL);
+        n_repaired++;
+    }
+
+    for (node = accounts; node; node = node->next)
+        xaccAccountCommitEdit (node->data);
+    g_list_free (accounts);
+    g_hash_table_destroy (editing);
+
+    for (node = plan->lot_accounts; node && !abort_now; node = node->next)
+        xaccAccountScrubLots (node->data);
+}
+
+void
+xaccAccountTreeScrub (Account *acc, gboolean scrub_lots,
+                      QofPercentageFunc percentagefunc)
+{
+    ScrubPlan plan = { 0 };
+
+    if (!acc) return;
+    ENTER ("(acc=%s)", xaccAccountGetName (acc));
+
+    abort_now = FALSE;
+
+    plan.seen = g_hash_table_new (g_direct_hash, g_direct_equal);
+    plan.trans = g_ptr_array_new ();
+    plan.scrub_lots = scrub_lots;
+    plan.trading = qof_book_use_trading_accounts (gnc_account_get_book (acc));
+    scrub_plan_add_account (acc, &plan);
+    gnc_account_foreach_descendant (acc, scrub_plan_add_account, &plan);
+    g_hash_table_destroy (plan.seen);
+
+    if (scrub_plan_check (&plan, percentagefunc))
+        scrub_plan_repair (&plan, gnc_account_get_root (acc), percentagefunc);
+    if (percentagefunc)
+        (percentagefunc)(NULL, -1.0);
+
+    g_ptr_array_free (plan.trans, TRUE);
+    g_free (plan.needs_repair);
+    g_list_free (plan.commodity_accounts);
+    g_list_free (plan.lot_accounts);
+    LEAVE ("(acc=%s)%s", xaccAccountGetName (acc),
+           abort_now ? " aborted" : "");
 }
 
 static Split *
@@ -111,6 +111,27 @@ void xaccTransScrubImbalance (Transaction *trans, Account *root,
 void xaccAccountScrubImbalance (Account *acc, QofPercentageFunc percentagefunc);
 void xaccAccountTreeScrubImbalance (Account *acc, QofPercentageFunc percentagefunc);
 
+/** The xaccAccountTreeScrub() method checks and repairs the indicated
+ *    account and its children in one pass.  It does what
+ *    xaccAccountTreeScrubOrphans() followed by
+ *    xaccAccountTreeScrubImbalance() does, also fixes accounts without
+ *    a commodity and, if @a scrub_lots is TRUE, scrubs the lots of
+ *    accounts with trades.
+ *
+ *    Each transaction is checked once, by a read-only test that runs
+ *    in a pool of threads; only those that need it are then repaired.
+ *    Progress is reported through @a percentagefunc, which may be
+ *    NULL.  Calling gnc_set_abort_scrub(TRUE), typically from inside
+ *    @a percentagefunc, stops the scrub before the next transaction.
+ */
+void xaccAccountTreeScrub (Account *acc, gboolean scrub_lots,
+                           QofPercentageFunc percentagefunc);
+
+/** Ask a running xaccAccountTreeScrub() to stop.  It is reset when the
+ *    next one starts. */
+void gnc_set_abort_scrub (gboolean abort);
+gboolean gnc_get_abort_scrub (void);
+
 /** The xaccTransScrubCurrency method fixes transactions without a
  * common_currency by looking for the most commonly used currency
  * among all the splits in the transaction.  If this fails it falls
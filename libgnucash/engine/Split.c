@@ -1205,6 +1205,7 @@ qofSplitSetAmount (Split *split, gnc_numeric amt)
     {
         split->amount = amt;
     }
+    if (split->lot) gnc_lot_set_closed_unknown (split->lot);
 }
 
 /* The amount of the split in the _account's_ commodity. */
@@ -29,6 +29,12 @@
 #include <glib.h>
 #include <glib/gstdio.h>
 #include <string.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef G_OS_WIN32
+#include <io.h>
+#endif
 
 #include "Account.h"
 #include "Transaction.h"
@@ -89,6 +95,28 @@ static FILE * trans_log = NULL; /**< current log file handle */
 static char * trans_log_name = NULL; /**< current log file name */
 static char * log_base_name = NULL;
 
+/* Records are formatted on the committing thread and written by
+ * log_writer, which flushes the file when it has written
+ * log_flush_records records or the oldest unflushed one is
+ * log_flush_interval milliseconds old, so that bulk edits don't wait
+ * for the disk once per transaction. While the writer is running it
+ * is the only one touching trans_log. If it can't be started records
+ * are written and flushed directly, as they used to be.
+ */
+#define LOG_FLUSH_INTERVAL 500
+#define LOG_FLUSH_RECORDS 100
+
+static GThread *log_writer = NULL;
+static GAsyncQueue *log_queue = NULL;
+static gint log_flush_interval = LOG_FLUSH_INTERVAL;
+static gint log_flush_records = LOG_FLUSH_RECORDS;
+
+/* Queued in place of a record to make the writer sync the file or stop. */
+static char log_barrier, log_stop;
+static GMutex log_sync_mutex;
+static GCond log_sync_cond;
+static guint64 log_syncs_requested = 0, log_syncs_done = 0;
+
 /********************************************************************\
 \********************************************************************/
 
@@ -104,6 +132,131 @@ void xaccLogEnable  (void)
 /********************************************************************\
 \********************************************************************/
 
+void
+xaccLogSetFlushPolicy (guint interval, guint records)
+{
+    g_atomic_int_set (&log_flush_interval, MIN (interval, (guint)G_MAXINT));
+    g_atomic_int_set (&log_flush_records, CLAMP (records, 1, (guint)G_MAXINT));
+}
+
+static void
+log_sync_file (void)
+{
+    fflush (trans_log);
+#ifdef G_OS_WIN32
+    _commit (_fileno (trans_log));
+#elif defined HAVE_UNISTD_H
+    fsync (fileno (trans_log));
+#endif
+}
+
+static gpointer
+log_writer_thread (gpointer data)
+{
+    guint pending = 0;
+    gint64 deadline = 0;
+
+    while (TRUE)
+    {
+        gpointer record;
+        if (!pending)
+            record = g_async_queue_pop (log_queue);
+        else
+        {
+            gint64 timeout = deadline - g_get_monotonic_time ();
+            record = timeout > 0 ?
+                g_async_queue_timeout_pop (log_queue, timeout) : NULL;
+        }
+
+        if (!record)
+        {
+            fflush (trans_log);
+            pending = 0;
+        }
+        else if (record == &log_stop)
+        {
+            break;
+        }
+        else if (record == &log_barrier)
+        {
+            log_sync_file ();
+            pending = 0;
+            g_mutex_lock (&log_sync_mutex);
+            ++log_syncs_done;
+            g_cond_broadcast (&log_sync_cond);
+            g_mutex_unlock (&log_sync_mutex);
+        }
+        else
+        {
+            GString *str = record;
+            fwrite (str->str, 1, str->len, trans_log);
+            g_string_free (str, TRUE);
+            if (!pending++)
+                deadline = g_get_monotonic_time () +
+                    g_atomic_int_get (&log_flush_interval) * G_TIME_SPAN_MILLISECOND;
+            if (pending >= (guint)g_atomic_int_get (&log_flush_records))
+            {
+                fflush (trans_log);
+                pending = 0;
+            }
+        }
+    }
+    fflush (trans_log);
+    return NULL;
+}
+
+static void
+log_start_writer (void)
+{
+    GError *error = NULL;
+
+    log_queue = g_async_queue_new ();
+    log_writer = g_thread_try_new ("gnc-translog", log_writer_thread,
+                                   NULL, &error);
+    if (!log_writer)
+    {
+        PWARN ("Writing the transaction log synchronously: %s",
+               error->message);
+        g_error_free (error);
+        g_async_queue_unref (log_queue);
+        log_queue = NULL;
+    }
+}
+
+static void
+log_stop_writer (void)
+{
+    if (!log_writer) return;
+    g_async_queue_push (log_queue, &log_stop);
+    g_thread_join (log_writer);
+    log_writer = NULL;
+    g_async_queue_unref (log_queue);
+    log_queue = NULL;
+}
+
+void
+xaccLogSync (void)
+{
+    guint64 ticket;
+
+    if (!trans_log) return;
+    if (!log_writer)
+    {
+        log_sync_file ();
+        return;
+    }
+
+    ticket = ++log_syncs_requested;
+    g_async_queue_push (log_queue, &log_barrier);
+    g_mutex_lock (&log_sync_mutex);
+    while (log_syncs_done < ticket)
+        g_cond_wait (&log_sync_cond, &log_sync_mutex);
+    g_mutex_unlock (&log_sync_mutex);
+}
+
+/********************************************************************\
+\********************************************************************/
+
 void
 xaccReopenLog (void)
 {
@@ -202,6 +355,9 @@ xaccOpenLog (void)
              "notes\tmemo\taction\treconciled\t"
              "amount\tvalue\tdate_reconciled\n");
     fprintf (trans_log, "-----------------\n");
+    fflush (trans_log);
+
+    log_start_writer ();
 }
 
 /********************************************************************\
@@ -211,6 +367,7 @@ void
 xaccCloseLog (void)
 {
     if (!trans_log) return;
+    log_stop_writer ();
     fflush (trans_log);
     fclose (trans_log);
     trans_log = NULL;
@@ -227,6 +384,7 @@ xaccTransWriteLog (Transaction *trans, char flag)
     char split_guid_str[GUID_ENCODING_LENGTH + 1];
     const char *trans_notes;
     char dnow[100], dent[100], dpost[100], drecn[100];
+    GString *record;
 
     if (!gen_logs)
     {
@@ -240,7 +398,8 @@ xaccTransWriteLog (Transaction *trans, char flag)
     gnc_time64_to_iso8601_buff (trans->date_posted, dpost);
     guid_to_string_buff (xaccTransGetGUID(trans), trans_guid_str);
     trans_notes = xaccTransGetNotes(trans);
-    fprintf (trans_log, "===== START\n");
+    record = g_string_sized_new (256);
+    g_string_append (record, "===== START\n");
 
     for (node = trans->splits; node; node = node->next)
     {
@@ -268,36 +427,44 @@ xaccTransWriteLog (Transaction *trans, char flag)
         val = xaccSplitGetValue (split);
 
         /* use tab-separated fields */
-        fprintf (trans_log,
-                 "%c\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t"
-                 "%s\t%s\t%s\t%s\t%c\t%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT "\t%s\n",
-                 flag,
-                 trans_guid_str, split_guid_str,  /* trans+split make up unique id */
-                 /* Note that the next three strings always exist,
-                 		* so we don't need to test them. */
-                 dnow,
-                 dent,
-                 dpost,
-                 acc_guid_str,
-                 accname ? accname : "",
-                 trans->num ? trans->num : "",
-                 trans->description ? trans->description : "",
-                 trans_notes ? trans_notes : "",
-                 split->memo ? split->memo : "",
-                 split->action ? split->action : "",
-                 split->reconciled,
-                 gnc_numeric_num(amt),
-                 gnc_numeric_denom(amt),
-                 gnc_numeric_num(val),
-                 gnc_numeric_denom(val),
-                 /* The next string always exists. No need to test it. */
-                 drecn);
+        g_string_append_printf (record,
+                                "%c\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t"
+                                "%s\t%s\t%s\t%s\t%c\t%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT "\t%s\n",
+                                flag,
+                                trans_guid_str, split_guid_str,  /* trans+split make up unique id */
+                                /* Note that the next three strings always exist,
+                                		* so we don't need to test them. */
+                                dnow,
+                                dent,
+                                dpost,
+                                acc_guid_str,
+                                accname ? accname : "",
+                                trans->num ? trans->num : "",
+                                trans->description ? trans->description : "",
+                                trans_notes ? trans_notes : "",
+                                split->memo ? split->memo : "",
+                                split->action ? split->action : "",
+                                split->reconciled,
+                                gnc_numeric_num(amt),
+                                gnc_numeric_denom(amt),
+                                gnc_numeric_num(val),
+                                gnc_numeric_denom(val),
+                                /* The next string always exists. No need to test it. */
+                                drecn);
     }
 
-    fprintf (trans_log, "===== END\n");
+    g_string_append (record, "===== END\n");
+
+    if (log_writer)
+    {
+        g_async_queue_push (log_queue, record);
+        return;
+    }
 
     /* get data out to the disk */
+    fwrite (record->str, 1, record->len, trans_log);
     fflush (trans_log);
+    g_string_free (record, TRUE);
 }
 
 /************************ END OF ************************************\
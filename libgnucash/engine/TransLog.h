@@ -47,9 +47,28 @@
 #include "Transaction.h"
 
 void    xaccOpenLog (void);
+/** Close the log after writing out everything logged so far. */
 void    xaccCloseLog (void);
 void    xaccReopenLog (void);
 
+/** Block until everything logged so far is on the disk.
+ *
+ * Logged transactions are written by a background thread, which only
+ * flushes the file now and then (see xaccLogSetFlushPolicy()). Call
+ * this before anything that the log is supposed to be able to recover
+ * from, such as saving the book.
+ */
+void    xaccLogSync (void);
+
+/** Set how often the background writer flushes the log.
+ *
+ * @param interval The longest time in milliseconds a logged
+ * transaction waits to be flushed. 0 flushes after every transaction.
+ * @param records The number of logged transactions after which the
+ * log is flushed regardless of @a interval.
+ */
+void    xaccLogSetFlushPolicy (guint interval, guint records);
+
 /**
  * @param trans The transaction to write out to the log
  * @param flag The engine currently uses the log mechanism with flag char set as
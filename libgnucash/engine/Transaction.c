@@ -1642,6 +1642,8 @@ static void trans_cleanup_commit(Transaction *trans)
 void
 xaccTransCommitEdit (Transaction *trans)
 {
+    gint64 trace_start;
+
     if (!trans) return;
     ENTER ("(trans=%p)", trans);
 
@@ -1650,6 +1652,7 @@ xaccTransCommitEdit (Transaction *trans)
         LEAVE("editlevel non-zero");
         return;
     }
+    trace_start = qof_trace_begin ();
 
     /* We increment this for the duration of the call
      * so other functions don't result in a recursive
@@ -1700,6 +1703,7 @@ xaccTransCommitEdit (Transaction *trans)
                           trans_on_error,
                           (void (*) (QofInstance *)) trans_cleanup_commit,
                           (void (*) (QofInstance *)) do_destroy);
+    qof_trace_end (log_module, "xaccTransCommitEdit", trace_start);
     LEAVE ("(trans=%p)", trans);
 }
 
@@ -1777,6 +1781,8 @@ xaccTransRollbackEdit (Transaction *trans)
             s->amount = so->amount;
             s->value = so->value;
             s->lot = so->lot;
+            /* The lot's cached balance may include the discarded amount */
+            if (s->lot) gnc_lot_set_closed_unknown (s->lot);
             s->gains_split = so->gains_split;
             //SET_GAINS_A_VDIRTY(s);
             s->date_reconciled = so->date_reconciled;
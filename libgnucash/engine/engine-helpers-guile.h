@@ -53,4 +53,36 @@ gnc_commodity * gnc_scm_to_commodity(SCM scm);
 SCM gnc_commodity_to_scm (const gnc_commodity *commodity);
 SCM gnc_book_to_scm (const QofBook *book);
 
+/** Balances of several accounts at several dates, computed in one
+ * pass over each account's splits by gnc_balance_matrix_new().
+ *
+ * @param accounts A list of accounts.
+ * @param dates A list of time64, sorted ascending. Splits posted on or
+ * before a date count towards that date's balance.
+ * @param use_value Total split values in the transaction currency
+ * rather than split amounts in the account commodity.
+ * @param include_children Add in the balances of all descendants.
+ * @param exclude_closing Ignore closing transactions.
+ * @return A list with one element per account, each a list with one
+ * element per date, each an association list of (commodity . total).
+ */
+SCM gnc_accounts_get_balances_at_dates (SCM accounts, SCM dates,
+                                        gboolean use_value,
+                                        gboolean include_children,
+                                        gboolean exclude_closing);
+
+/** Sort splits by several keys at once with gnc_split_table_sort().
+ *
+ * @param splits A list of splits.
+ * @param keys A list of (column bucket ascending?) lists, the most
+ * significant first. column is one of date-posted, date-reconciled,
+ * reconcile, account-name, account-code, other-account-name,
+ * other-account-code, amount, value, description, num, action, memo or
+ * notes; any other value does not order the splits. bucket groups the
+ * date columns and is one of daily, weekly, monthly, quarterly or
+ * yearly; any other value compares exact dates.
+ * @return The splits in a new list, sorted stably.
+ */
+SCM gnc_splits_sort (SCM splits, SCM keys);
+
 #endif
@@ -33,8 +33,10 @@
 #include "engine-helpers-guile.h"
 #include "glib-helpers.h"
 #include "gnc-date.h"
+#include "gnc-balance-matrix.h"
 #include "gnc-engine.h"
 #include "gnc-session.h"
+#include "gnc-split-table.h"
 #include "guile-mappings.h"
 #include "gnc-guile-utils.h"
 #include <qof.h>
@@ -1988,3 +1990,201 @@ gnc_book_to_scm (const QofBook *book)
 {
     return gnc_generic_to_scm(book, "_p_QofBook");
 }
+
+SCM
+gnc_accounts_get_balances_at_dates (SCM accounts, SCM dates,
+                                    gboolean use_value,
+                                    gboolean include_children,
+                                    gboolean exclude_closing)
+{
+    GList *acct_list = NULL;
+    time64 *date_array;
+    int num_dates, num_accounts, acct, date;
+    GncBalanceFlags flags = GNC_BALANCE_AMOUNT;
+    GncBalanceMatrix *matrix;
+    SCM result = SCM_EOL;
+    SCM node;
+
+    for (node = accounts; scm_is_pair (node); node = SCM_CDR (node))
+    {
+        Account *acc = gnc_scm_to_generic (SCM_CAR (node), "_p_Account");
+        if (!acc)
+        {
+            g_list_free (acct_list);
+            scm_wrong_type_arg (FUNC_NAME, 1, SCM_CAR (node));
+        }
+        acct_list = g_list_prepend (acct_list, acc);
+    }
+    acct_list = g_list_reverse (acct_list);
+
+    num_dates = scm_ilength (dates);
+    if (num_dates < 0)
+    {
+        g_list_free (acct_list);
+        scm_wrong_type_arg (FUNC_NAME, 2, dates);
+    }
+    date_array = g_new (time64, num_dates ? num_dates : 1);
+    for (date = 0, node = dates; date < num_dates; ++date, node = SCM_CDR (node))
+        date_array[date] = scm_to_int64 (SCM_CAR (node));
+
+    if (use_value)
+        flags |= GNC_BALANCE_VALUE;
+    if (include_children)
+        flags |= GNC_BALANCE_INCLUDE_CHILDREN;
+    if (exclude_closing)
+        flags |= GNC_BALANCE_EXCLUDE_CLOSING;
+    matrix = gnc_balance_matrix_new (acct_list, date_array, num_dates, flags);
+    g_list_free (acct_list);
+    g_free (date_array);
+
+    /* Build the nested lists back to front so that each cons is final. */
+    num_accounts = gnc_balance_matrix_get_num_accounts (matrix);
+    for (acct = num_accounts - 1; acct >= 0; --acct)
+    {
+        SCM row = SCM_EOL;
+        for (date = num_dates - 1; date >= 0; --date)
+        {
+            SCM cell = SCM_EOL;
+            int n = gnc_balance_matrix_get_num_totals (matrix, acct, date);
+            while (n-- > 0)
+            {
+                gnc_commodity *comm =
+                    gnc_balance_matrix_get_commodity (matrix, acct, date, n);
+                gnc_numeric total =
+                    gnc_balance_matrix_get_total (matrix, acct, date, n);
+                cell = scm_cons (scm_cons (gnc_commodity_to_scm (comm),
+                                           gnc_numeric_to_scm (total)),
+                                 cell);
+            }
+            row = scm_cons (cell, row);
+        }
+        result = scm_cons (row, result);
+    }
+    gnc_balance_matrix_destroy (matrix);
+    return result;
+}
+
+static const struct
+{
+    const char *name;
+    GncSplitColumn column;
+} split_columns[] =
+{
+    { "date-posted", GNC_SPLIT_COLUMN_DATE_POSTED },
+    { "date-reconciled", GNC_SPLIT_COLUMN_DATE_RECONCILED },
+    { "reconcile", GNC_SPLIT_COLUMN_RECONCILE },
+    { "account-name", GNC_SPLIT_COLUMN_ACCOUNT_NAME },
+    { "account-code", GNC_SPLIT_COLUMN_ACCOUNT_CODE },
+    { "other-account-name", GNC_SPLIT_COLUMN_OTHER_ACCOUNT_NAME },
+    { "other-account-code", GNC_SPLIT_COLUMN_OTHER_ACCOUNT_CODE },
+    { "amount", GNC_SPLIT_COLUMN_AMOUNT },
+    { "value", GNC_SPLIT_COLUMN_VALUE },
+    { "description", GNC_SPLIT_COLUMN_DESCRIPTION },
+    { "num", GNC_SPLIT_COLUMN_NUM },
+    { "action", GNC_SPLIT_COLUMN_ACTION },
+    { "memo", GNC_SPLIT_COLUMN_MEMO },
+    { "notes", GNC_SPLIT_COLUMN_NOTES },
+};
+
+static const struct
+{
+    const char *name;
+    GncDateBucket bucket;
+} date_buckets[] =
+{
+    { "daily", GNC_DATE_BUCKET_DAY },
+    { "weekly", GNC_DATE_BUCKET_WEEK },
+    { "monthly", GNC_DATE_BUCKET_MONTH },
+    { "quarterly", GNC_DATE_BUCKET_QUARTER },
+    { "yearly", GNC_DATE_BUCKET_YEAR },
+};
+
+static GncSplitColumn
+gnc_scm2split_column (SCM column_scm)
+{
+    GncSplitColumn res = GNC_SPLIT_COLUMN_NONE;
+    gchar *column;
+    guint i;
+
+    if (!scm_is_symbol (column_scm))
+        return res;
+    column = gnc_scm_symbol_to_locale_string (column_scm);
+    for (i = 0; i < G_N_ELEMENTS (split_columns); ++i)
+        if (!g_strcmp0 (column, split_columns[i].name))
+            res = split_columns[i].column;
+    g_free (column);
+    return res;
+}
+
+static GncDateBucket
+gnc_scm2date_bucket (SCM bucket_scm)
+{
+    GncDateBucket res = GNC_DATE_BUCKET_EXACT;
+    gchar *bucket;
+    guint i;
+
+    if (!scm_is_symbol (bucket_scm))
+        return res;
+    bucket = gnc_scm_symbol_to_locale_string (bucket_scm);
+    for (i = 0; i < G_N_ELEMENTS (date_buckets); ++i)
+        if (!g_strcmp0 (bucket, date_buckets[i].name))
+            res = date_buckets[i].bucket;
+    g_free (bucket);
+    return res;
+}
+
+SCM
+gnc_splits_sort (SCM splits, SCM keys)
+{
+    GList *split_list = NULL, *sorted, *node;
+    GncSplitSortKey *key_array;
+    GncSplitTable *table;
+    int num_keys, n;
+    SCM result = SCM_EOL;
+    SCM scm;
+
+    for (scm = splits; scm_is_pair (scm); scm = SCM_CDR (scm))
+    {
+        Split *split = gnc_scm_to_generic (SCM_CAR (scm), "_p_Split");
+        if (!split)
+        {
+            g_list_free (split_list);
+            scm_wrong_type_arg (FUNC_NAME, 1, SCM_CAR (scm));
+        }
+        split_list = g_list_prepend (split_list, split);
+    }
+    split_list = g_list_reverse (split_list);
+
+    num_keys = scm_ilength (keys);
+    if (num_keys < 0)
+    {
+        g_list_free (split_list);
+        scm_wrong_type_arg (FUNC_NAME, 2, keys);
+    }
+    key_array = g_new0 (GncSplitSortKey, num_keys ? num_keys : 1);
+    for (n = 0, scm = keys; n < num_keys; ++n, scm = SCM_CDR (scm))
+    {
+        SCM key = SCM_CAR (scm);
+        if (scm_ilength (key) != 3)
+        {
+            g_list_free (split_list);
+            g_free (key_array);
+            scm_wrong_type_arg (FUNC_NAME, 2, keys);
+        }
+        key_array[n].column = gnc_scm2split_column (SCM_CAR (key));
+        key_array[n].bucket = gnc_scm2date_bucket (SCM_CADR (key));
+        key_array[n].ascending = scm_is_true (SCM_CADDR (key));
+    }
+
+    table = gnc_split_table_new (split_list);
+    gnc_split_table_sort (table, key_array, num_keys);
+    sorted = gnc_split_table_get_splits (table);
+    gnc_split_table_destroy (table);
+    g_list_free (split_list);
+    g_free (key_array);
+
+    for (node = g_list_last (sorted); node; node = node->prev)
+        result = scm_cons (gnc_generic_to_scm (node->data, "_p_Split"), result);
+    g_list_free (sorted);
+    return result;
+}
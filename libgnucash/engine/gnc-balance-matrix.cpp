@@ -0,0 +1,215 @@
+/********************************************************************\
+ * gnc-balance-matrix.cpp -- Account balances at many dates at once.*
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+
+extern "C"
+{
+#include <config.h>
+#include "Account.h"
+#include "Split.h"
+#include "Transaction.h"
+#include "gnc-commodity.h"
+#include "gnc-balance-matrix.h"
+}
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+static QofLogModule log_module = GNC_MOD_ENGINE;
+
+using GncCommodityTotal = std::pair<gnc_commodity*, gnc_numeric>;
+using GncCommodityTotals = std::vector<GncCommodityTotal>;
+using GncBalanceRow = std::vector<GncCommodityTotals>;
+
+struct GncBalanceMatrixImpl
+{
+    guint num_accounts;
+    guint num_dates;
+    /* Row-major, num_accounts * num_dates cells. */
+    std::vector<GncCommodityTotals> cells;
+};
+
+static void
+add_total (GncCommodityTotals& totals, gnc_commodity *commodity,
+           gnc_numeric amount)
+{
+    auto total = std::find_if (totals.begin (), totals.end (),
+                               [commodity](const GncCommodityTotal& t)
+                               {
+                                   return gnc_commodity_equiv (t.first,
+                                                               commodity);
+                               });
+    if (total == totals.end ())
+        totals.emplace_back (commodity, amount);
+    else
+        total->second = gnc_numeric_add (total->second, amount,
+                                         GNC_DENOM_AUTO, GNC_HOW_DENOM_LCD);
+}
+
+/* Walk the account's splits once, recording the running totals each
+ * time the posted date passes the next requested date. */
+static GncBalanceRow
+account_balances_at_dates (Account *acc, const time64 *dates,
+                           guint num_dates, GncBalanceFlags flags)
+{
+    auto use_value = (flags & GNC_BALANCE_VALUE) != 0;
+    auto exclude_closing = (flags & GNC_BALANCE_EXCLUDE_CLOSING) != 0;
+    auto commodity = xaccAccountGetCommodity (acc);
+    GncBalanceRow row;
+    GncCommodityTotals running;
+
+    row.reserve (num_dates);
+    if (!use_value)
+        running.emplace_back (commodity, gnc_numeric_zero ());
+
+    xaccAccountSortSplits (acc, TRUE); /* just in case, normally a noop */
+    for (auto node = xaccAccountGetSplitList (acc); node; node = node->next)
+    {
+        auto split = static_cast<Split*>(node->data);
+        auto trans = xaccSplitGetParent (split);
+        auto posted = xaccTransGetDate (trans);
+
+        while (row.size () < num_dates && posted > dates[row.size ()])
+            row.push_back (running);
+        if (row.size () == num_dates)
+            break;
+
+        if (exclude_closing && xaccTransGetIsClosingTxn (trans))
+            continue;
+        if (use_value)
+            add_total (running, xaccTransGetCurrency (trans),
+                       xaccSplitGetValue (split));
+        else
+            add_total (running, commodity, xaccSplitGetAmount (split));
+    }
+    row.resize (num_dates, running);
+    return row;
+}
+
+GncBalanceMatrix *
+gnc_balance_matrix_new (GList *accounts, const time64 *dates,
+                        guint num_dates, GncBalanceFlags flags)
+{
+    g_return_val_if_fail (dates || num_dates == 0, nullptr);
+    ENTER ("accounts=%u dates=%u flags=%d", g_list_length (accounts),
+           num_dates, flags);
+
+    auto matrix = new GncBalanceMatrixImpl;
+    matrix->num_accounts = g_list_length (accounts);
+    matrix->num_dates = num_dates;
+    matrix->cells.reserve (matrix->num_accounts * num_dates);
+
+    /* With children included the same subaccount may be asked for
+     * under several parents; compute each account's row only once. */
+    std::unordered_map<Account*, GncBalanceRow> rows;
+    auto row_for = [&](Account *acc) -> const GncBalanceRow&
+    {
+        auto row = rows.find (acc);
+        if (row == rows.end ())
+            row = rows.emplace (acc, account_balances_at_dates (acc, dates,
+                                                                num_dates,
+                                                                flags)).first;
+        return row->second;
+    };
+
+    for (auto node = accounts; node; node = node->next)
+    {
+        auto acc = static_cast<Account*>(node->data);
+        if (!(flags & GNC_BALANCE_INCLUDE_CHILDREN))
+        {
+            auto& row = row_for (acc);
+            matrix->cells.insert (matrix->cells.end (), row.begin (), row.end ());
+            continue;
+        }
+
+        GncBalanceRow sum (row_for (acc));
+        auto descendants = gnc_account_get_descendants (acc);
+        for (auto child = descendants; child; child = child->next)
+        {
+            auto& row = row_for (static_cast<Account*>(child->data));
+            for (guint date = 0; date < num_dates; ++date)
+                for (auto& total : row[date])
+                    add_total (sum[date], total.first, total.second);
+        }
+        g_list_free (descendants);
+        matrix->cells.insert (matrix->cells.end (), sum.begin (), sum.end ());
+    }
+
+    LEAVE ("");
+    return matrix;
+}
+
+void
+gnc_balance_matrix_destroy (GncBalanceMatrix *matrix)
+{
+    delete matrix;
+}
+
+guint
+gnc_balance_matrix_get_num_accounts (const GncBalanceMatrix *matrix)
+{
+    g_return_val_if_fail (matrix, 0);
+    return matrix->num_accounts;
+}
+
+guint
+gnc_balance_matrix_get_num_dates (const GncBalanceMatrix *matrix)
+{
+    g_return_val_if_fail (matrix, 0);
+    return matrix->num_dates;
+}
+
+static const GncCommodityTotals*
+matrix_cell (const GncBalanceMatrix *matrix, guint account, guint date)
+{
+    g_return_val_if_fail (matrix, nullptr);
+    g_return_val_if_fail (account < matrix->num_accounts, nullptr);
+    g_return_val_if_fail (date < matrix->num_dates, nullptr);
+    return &matrix->cells[account * matrix->num_dates + date];
+}
+
+guint
+gnc_balance_matrix_get_num_totals (const GncBalanceMatrix *matrix,
+                                   guint account, guint date)
+{
+    auto cell = matrix_cell (matrix, account, date);
+    return cell ? cell->size () : 0;
+}
+
+gnc_commodity *
+gnc_balance_matrix_get_commodity (const GncBalanceMatrix *matrix,
+                                  guint account, guint date, guint n)
+{
+    auto cell = matrix_cell (matrix, account, date);
+    g_return_val_if_fail (cell && n < cell->size (), nullptr);
+    return (*cell)[n].first;
+}
+
+gnc_numeric
+gnc_balance_matrix_get_total (const GncBalanceMatrix *matrix,
+                              guint account, guint date, guint n)
+{
+    auto cell = matrix_cell (matrix, account, date);
+    g_return_val_if_fail (cell && n < cell->size (), gnc_numeric_zero ());
+    return (*cell)[n].second;
+}
@@ -0,0 +1,109 @@
+/********************************************************************\
+ * gnc-balance-matrix.h -- Account balances at many dates at once.  *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+
+/** @addtogroup Engine
+    @{ */
+/** @file gnc-balance-matrix.h
+ *  @brief Balances of a set of accounts at a set of dates.
+ *
+ *  A balance matrix holds, for every requested account and every
+ *  requested date, the per-commodity totals of the account's splits
+ *  posted on or before that date. Each account's split list is walked
+ *  once no matter how many dates are requested, which is what trend
+ *  reports need; calling xaccAccountGetBalanceAsOfDate() for every
+ *  cell walks it once per date instead.
+ *
+ *  Amount totals are in each account's commodity; an account with
+ *  children therefore may have one total per distinct commodity in
+ *  its subtree. Value totals are in the transactions' currencies.
+ *
+ *  The Scheme report system reaches this through
+ *  gnc_accounts_get_balances_at_dates() in engine-helpers-guile.h.
+ */
+
+#ifndef GNC_BALANCE_MATRIX_H
+#define GNC_BALANCE_MATRIX_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <glib.h>
+#include "gnc-engine.h"
+#include "gnc-numeric.h"
+
+typedef enum
+{
+    GNC_BALANCE_AMOUNT           = 0,      /**< Sum split amounts. */
+    GNC_BALANCE_VALUE            = 1 << 0, /**< Sum split values instead. */
+    GNC_BALANCE_INCLUDE_CHILDREN = 1 << 1, /**< Add in all descendants. */
+    GNC_BALANCE_EXCLUDE_CLOSING  = 1 << 2, /**< Skip closing transactions. */
+} GncBalanceFlags;
+
+typedef struct GncBalanceMatrixImpl GncBalanceMatrix;
+
+/** Compute the balances of @a accounts at each of @a dates.
+ *
+ * @param accounts The accounts, one matrix row each in list order.
+ * @param dates The dates, one column each. Must be sorted ascending.
+ * @param num_dates The number of entries in @a dates.
+ * @param flags A combination of GncBalanceFlags.
+ * @return A new matrix; free it with gnc_balance_matrix_destroy().
+ */
+GncBalanceMatrix *gnc_balance_matrix_new (GList *accounts,
+                                          const time64 *dates,
+                                          guint num_dates,
+                                          GncBalanceFlags flags);
+
+void gnc_balance_matrix_destroy (GncBalanceMatrix *matrix);
+
+guint gnc_balance_matrix_get_num_accounts (const GncBalanceMatrix *matrix);
+guint gnc_balance_matrix_get_num_dates (const GncBalanceMatrix *matrix);
+
+/** The number of commodities with a total in the cell for the account
+ * in row @a account at the date in column @a date.
+ *
+ * In amount mode every account in the row's subtree contributes its
+ * commodity even when it has no splits, so such totals can be zero.
+ */
+guint gnc_balance_matrix_get_num_totals (const GncBalanceMatrix *matrix,
+                                         guint account, guint date);
+
+/** The commodity of the @a n th total of a cell. Totals are ordered by
+ * the first account (account before its descendants, in
+ * gnc_account_get_descendants() order) or split contributing them. */
+gnc_commodity *gnc_balance_matrix_get_commodity (const GncBalanceMatrix *matrix,
+                                                 guint account, guint date,
+                                                 guint n);
+
+/** The @a n th total of a cell. */
+gnc_numeric gnc_balance_matrix_get_total (const GncBalanceMatrix *matrix,
+                                          guint account, guint date,
+                                          guint n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNC_BALANCE_MATRIX_H */
+/** @} */
@@ -76,6 +76,7 @@ typedef struct gnc_commodityPrivate
     char    * cusip;          /* CUSIP or other identifying code */
     int       fraction;
     char    * unique_name;
+    guint32   key;            /* interned unique_name, see intern_key() */
 
     gboolean  quote_flag;	    /* user wants price quotes */
     gnc_quote_source * quote_source;   /* current/old source of quotes */
@@ -143,6 +144,25 @@ struct gnc_new_iso_code
 #define GNC_NEW_ISO_CODES \
         (sizeof(gnc_new_iso_codes) / sizeof(struct gnc_new_iso_code))
 
+/* Returns the current code for a retired ISO code, NULL if the code
+ * wasn't retired. */
+static const char *
+gnc_new_iso_code_lookup (const char *old_code)
+{
+    static GHashTable *new_codes = NULL;
+
+    if (g_once_init_enter (&new_codes))
+    {
+        GHashTable *codes = g_hash_table_new (g_str_hash, g_str_equal);
+        guint i;
+        for (i = 0; i < GNC_NEW_ISO_CODES; i++)
+            g_hash_table_insert (codes, (gpointer)gnc_new_iso_codes[i].old_code,
+                                 (gpointer)gnc_new_iso_codes[i].new_code);
+        g_once_init_leave (&new_codes, codes);
+    }
+    return old_code ? g_hash_table_lookup (new_codes, old_code) : NULL;
+}
+
 static char *fq_version = NULL;
 
 struct gnc_quote_source_s
@@ -637,6 +657,29 @@ reset_printname(gnc_commodityPrivate *priv)
                                       priv->fullname ? priv->fullname : "");
 }
 
+/* Map a unique name to a small integer, the same one for every
+ * commodity with that namespace and mnemonic in any book. The ids are
+ * never released; there are only ever a few hundred unique names. */
+static guint32
+intern_key(const char *unique_name)
+{
+    static GHashTable *keys = NULL;
+    static GMutex mutex;
+    gpointer key;
+
+    g_mutex_lock (&mutex);
+    if (!keys)
+        keys = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    key = g_hash_table_lookup (keys, unique_name);
+    if (!key)
+    {
+        key = GUINT_TO_POINTER(g_hash_table_size (keys) + 1);
+        g_hash_table_insert (keys, g_strdup (unique_name), key);
+    }
+    g_mutex_unlock (&mutex);
+    return GPOINTER_TO_UINT(key);
+}
+
 static void
 reset_unique_name(gnc_commodityPrivate *priv)
 {
@@ -647,6 +690,7 @@ reset_unique_name(gnc_commodityPrivate *priv)
     priv->unique_name = g_strdup_printf("%s::%s",
                                         ns ? ns->name : "",
                                         priv->mnemonic ? priv->mnemonic : "");
+    priv->key = intern_key(priv->unique_name);
 }
 
 /* GObject Initialization */
@@ -984,6 +1028,7 @@ gnc_commodity_copy(gnc_commodity * dest, const gnc_commodity *src)
     gnc_commodity_set_fullname (dest, src_priv->fullname);
     gnc_commodity_set_mnemonic (dest, src_priv->mnemonic);
     dest_priv->name_space = src_priv->name_space;
+    reset_unique_name (dest_priv);
     gnc_commodity_set_fraction (dest, src_priv->fraction);
     gnc_commodity_set_cusip (dest, src_priv->cusip);
     gnc_commodity_set_quote_flag (dest, src_priv->quote_flag);
@@ -1087,6 +1132,17 @@ gnc_commodity_get_unique_name(const gnc_commodity * cm)
     return GET_PRIVATE(cm)->unique_name;
 }
 
+/********************************************************************
+ * gnc_commodity_get_key
+ ********************************************************************/
+
+guint32
+gnc_commodity_get_key(const gnc_commodity * cm)
+{
+    if (!cm) return 0;
+    return GET_PRIVATE(cm)->key;
+}
+
 
 /********************************************************************
  * gnc_commodity_get_cusip
@@ -1610,8 +1666,7 @@ gnc_commodity_equiv(const gnc_commodity * a, const gnc_commodity * b)
     priv_a = GET_PRIVATE(a);
     priv_b = GET_PRIVATE(b);
     if (priv_a->name_space != priv_b->name_space) return FALSE;
-    if (g_strcmp0(priv_a->mnemonic, priv_b->mnemonic) != 0) return FALSE;
-    return TRUE;
+    return priv_a->key == priv_b->key;
 }
 
 gboolean
@@ -1619,7 +1674,6 @@ gnc_commodity_equal(const gnc_commodity * a, const gnc_commodity * b)
 {
     gnc_commodityPrivate* priv_a;
     gnc_commodityPrivate* priv_b;
-    gboolean same_book;
 
     if (a == b) return TRUE;
 
@@ -1631,21 +1685,13 @@ gnc_commodity_equal(const gnc_commodity * a, const gnc_commodity * b)
 
     priv_a = GET_PRIVATE(a);
     priv_b = GET_PRIVATE(b);
-    same_book = qof_instance_get_book(QOF_INSTANCE(a)) == qof_instance_get_book(QOF_INSTANCE(b));
-
-    if ((same_book && priv_a->name_space != priv_b->name_space)
-            || (!same_book && g_strcmp0( gnc_commodity_namespace_get_name(priv_a->name_space),
-                                           gnc_commodity_namespace_get_name(priv_b->name_space)) != 0))
-    {
-        DEBUG ("namespaces differ: %p(%s) vs %p(%s)",
-               priv_a->name_space, gnc_commodity_namespace_get_name(priv_a->name_space),
-               priv_b->name_space, gnc_commodity_namespace_get_name(priv_b->name_space));
-        return FALSE;
-    }
 
-    if (g_strcmp0(priv_a->mnemonic, priv_b->mnemonic) != 0)
+    /* The key stands for the namespace name and the mnemonic, so this
+     * works across books too. */
+    if (priv_a->key != priv_b->key)
     {
-        DEBUG ("mnemonics differ: %s vs %s", priv_a->mnemonic, priv_b->mnemonic);
+        DEBUG ("unique names differ: %s vs %s",
+               priv_a->unique_name, priv_b->unique_name);
         return FALSE;
     }
 
@@ -1822,7 +1868,6 @@ gnc_commodity_table_lookup(const gnc_commodity_table * table,
                            const char * name_space, const char * mnemonic)
 {
     gnc_commodity_namespace * nsp = NULL;
-    unsigned int i;
 
     if (!table || !name_space || !mnemonic) return NULL;
 
@@ -1836,14 +1881,9 @@ gnc_commodity_table_lookup(const gnc_commodity_table * table,
          */
         if (nsp->iso4217)
         {
-            for (i = 0; i < GNC_NEW_ISO_CODES; i++)
-            {
-                if (strcmp(mnemonic, gnc_new_iso_codes[i].old_code) == 0)
-                {
-                    mnemonic = gnc_new_iso_codes[i].new_code;
-                    break;
-                }
-            }
+            const char *new_code = gnc_new_iso_code_lookup (mnemonic);
+            if (new_code)
+                mnemonic = new_code;
         }
         return g_hash_table_lookup(nsp->cm_table, (gpointer)mnemonic);
     }
@@ -1959,16 +1999,13 @@ gnc_commodity_table_insert(gnc_commodity_table * table,
          * recently changed. */
         if (priv->name_space->iso4217)
         {
-            guint i;
-            for (i = 0; i < GNC_NEW_ISO_CODES; i++)
-            {
-                if (!priv->mnemonic
-                        || !strcmp(priv->mnemonic, gnc_new_iso_codes[i].old_code))
-                {
-                    gnc_commodity_set_mnemonic(comm, gnc_new_iso_codes[i].new_code);
-                    break;
-                }
-            }
+            /* A currency without a mnemonic gets the first current
+             * code, as it always has. */
+            const char *new_code = priv->mnemonic ?
+                gnc_new_iso_code_lookup (priv->mnemonic) :
+                gnc_new_iso_codes[0].new_code;
+            if (new_code)
+                gnc_commodity_set_mnemonic(comm, new_code);
         }
         gnc_commodity_copy (c, comm);
         gnc_commodity_destroy (comm);
@@ -421,6 +421,19 @@ const char * gnc_commodity_get_cusip(const gnc_commodity * cm);
  */
 const char * gnc_commodity_get_unique_name(const gnc_commodity * cm);
 
+/** Retrieve a small integer standing for the unique name of the
+ *  specified commodity.  Commodities with the same namespace and
+ *  mnemonic have the same key, even in different books, and the key
+ *  is never 0, so it can be used in place of the unique name for
+ *  comparisons and as a hash key.  Keys are only valid for the life
+ *  of the process and must not be stored.
+ *
+ *  @param cm A pointer to a commodity data structure.
+ *
+ *  @return The key for this commodity, or 0 if @a cm is NULL.
+ */
+guint32 gnc_commodity_get_key(const gnc_commodity * cm);
+
 /** Retrieve the fraction for the specified commodity.  This will be
  *  an integer value specifying the number of fractional units that
  *  one of these commodities can be divided into.  Should always be a
@@ -116,6 +116,8 @@ gnc_localtime (const time64 *secs)
 struct tm*
 gnc_localtime_r (const time64 *secs, struct tm* time)
 {
+    if (GncDateTime::local_tm (*secs, *time))
+        return time;
     try
     {
         *time = static_cast<struct tm>(GncDateTime(*secs));
@@ -413,6 +415,10 @@ time64
 time64CanonicalDayTime (time64 t)
 {
     struct tm tm;
+    time64 new_time;
+
+    if (GncDateTime::local_day_time (t, 12 * 3600, new_time))
+        return new_time;
     gnc_localtime_r(&t, &tm);
     gnc_tm_set_day_middle(&tm);
     return gnc_mktime (&tm);
@@ -551,6 +557,24 @@ const gchar *qof_date_text_format_get_string(QofDateFormat df)
     return GNC_D_FMT;
 }
 
+/* Registers, reports and exports print dates by the thousand, nearly
+ * always in the same format, so each thread keeps the compiled format
+ * for each QofDateFormat. The locale's format can change underneath
+ * us, so the format string is checked before the compiled one is used.
+ */
+static const GncDateFormatter&
+date_formatter (QofDateFormat df)
+{
+    static thread_local std::unique_ptr<GncDateFormatter>
+        formatters[QOF_DATE_FORMAT_UNSET + 1];
+    const char *format = qof_date_format_get_string (df);
+    auto& formatter = formatters[df <= QOF_DATE_FORMAT_UNSET ?
+                                 df : QOF_DATE_FORMAT_LOCALE];
+    if (!formatter || formatter->format () != format)
+        formatter.reset (new GncDateFormatter (format));
+    return *formatter;
+}
+
 size_t
 qof_print_date_dmy_buff (char * buff, const size_t len, int day, int month, int year)
 {
@@ -558,11 +582,7 @@ qof_print_date_dmy_buff (char * buff, const size_t len, int day, int month, int
 
     try
     {
-        GncDate date(year, month, day);
-        std::string str = date.format(qof_date_format_get_string(dateFormat));
-        strncpy(buff, str.c_str(), len);
-        if (str.length() >= len)
-            buff[len - 1] = '\0';
+        date_formatter (dateFormat).write (buff, len, year, month, day);
     }
     catch(std::logic_error& err)
     {
@@ -584,11 +604,7 @@ qof_print_date_buff (char * buff, const size_t len, time64 t)
 
     try
     {
-        GncDateTime gncdt(t);
-        std::string str = gncdt.format(qof_date_format_get_string(dateFormat));
-        strncpy(buff, str.c_str(), len);
-        if (str.length() >= len)
-            buff[len - 1] = '\0';
+        date_formatter (dateFormat).write (buff, len, t);
     }
     catch(std::logic_error& err)
     {
@@ -659,6 +675,45 @@ normalize_format (const std::string& format)
     return normalized;
 }
 
+/* The locale's date format, normalized. */
+static const std::string&
+normalized_locale_format (void)
+{
+    static thread_local std::string format, normalized;
+    const char *current = GNC_D_FMT;
+    if (format != current)
+    {
+        format = current;
+        normalized = normalize_format (format);
+    }
+    return normalized;
+}
+
+/* Today's date, for filling in what a scanned date leaves out.
+ * Importers scan a date per line, and converting the current time to
+ * local time for each of them is wasted when the answer only changes
+ * at midnight. */
+static void
+today_dmy (int *day, int *month, int *year)
+{
+    static thread_local time64 valid_until = INT64_MIN;
+    static thread_local int today[3];
+    time64 secs = gnc_time (NULL);
+
+    if (secs > valid_until)
+    {
+        struct tm *now = gnc_localtime (&secs);
+        today[0] = now->tm_mday;
+        today[1] = now->tm_mon + 1;
+        today[2] = now->tm_year + 1900;
+        gnc_tm_free (now);
+        valid_until = gnc_time64_get_day_end (secs);
+    }
+    *day = today[0];
+    *month = today[1];
+    *year = today[2];
+}
+
 /* Convert a string into  day, month and year integers
 
     Convert a string into  day / month / year integers according to
@@ -688,8 +743,7 @@ qof_scan_date_internal (const char *buff, int *day, int *month, int *year,
     char *dupe, *tmp, *first_field, *second_field, *third_field;
     int iday, imonth, iyear;
     int now_day, now_month, now_year;
-    struct tm *now, utc;
-    time64 secs;
+    struct tm utc;
 
     if (!buff) return(FALSE);
 
@@ -731,13 +785,7 @@ qof_scan_date_internal (const char *buff, int *day, int *month, int *year,
         }
     }
 
-    /* today's date */
-    gnc_time (&secs);
-    now = gnc_localtime (&secs);
-    now_day = now->tm_mday;
-    now_month = now->tm_mon + 1;
-    now_year = now->tm_year + 1900;
-    gnc_tm_free (now);
+    today_dmy (&now_day, &now_month, &now_year);
 
     /* set defaults: if day or month appear to be blank, use today's date */
     iday = now_day;
@@ -753,7 +801,7 @@ qof_scan_date_internal (const char *buff, int *day, int *month, int *year,
             struct tm thetime;
             /* Parse time string. */
             memset(&thetime, -1, sizeof(struct tm));
-            strptime (buff, normalize_format(GNC_D_FMT).c_str(), &thetime);
+            strptime (buff, normalized_locale_format().c_str(), &thetime);
 
             if (third_field)
             {
@@ -1293,6 +1341,8 @@ gnc_time64_get_day_start (time64 time_val)
     struct tm tm;
     time64 new_time;
 
+    if (GncDateTime::local_day_time (time_val, 0, new_time))
+        return new_time;
     gnc_tm_get_day_start(&tm, time_val);
     new_time = gnc_mktime(&tm);
     return new_time;
@@ -1304,6 +1354,8 @@ gnc_time64_get_day_neutral (time64 time_val)
     struct tm tm;
     time64 new_time;
 
+    if (GncDateTime::local_day_time (time_val, 10 * 3600 + 59 * 60, new_time))
+        return new_time;
     gnc_tm_get_day_neutral(&tm, time_val);
     new_time = gnc_mktime(&tm);
     return new_time;
@@ -1315,6 +1367,8 @@ gnc_time64_get_day_end (time64 time_val)
     struct tm tm;
     time64 new_time;
 
+    if (GncDateTime::local_day_time (time_val, 23 * 3600 + 59 * 60 + 59, new_time))
+        return new_time;
     gnc_tm_get_day_end(&tm, time_val);
     new_time = gnc_mktime(&tm);
     return new_time;
@@ -1337,19 +1391,13 @@ gnc_tm_get_today_end (struct tm *tm)
 time64
 gnc_time64_get_today_start (void)
 {
-    struct tm tm;
-
-    gnc_tm_get_day_start(&tm, time(NULL));
-    return gnc_mktime(&tm);
+    return gnc_time64_get_day_start (time(NULL));
 }
 
 time64
 gnc_time64_get_today_end (void)
 {
-    struct tm tm;
-
-    gnc_tm_get_day_end(&tm, time(NULL));
-    return gnc_mktime(&tm);
+    return gnc_time64_get_day_end (time(NULL));
 }
 
 void
@@ -34,6 +34,8 @@ extern "C"
 #include <boost/regex.hpp>
 #include <libintl.h>
 #include <locale.h>
+#include <algorithm>
+#include <cstring>
 #include <map>
 #include <memory>
 #include <iostream>
@@ -485,6 +487,32 @@ win_format_tz_posix (std::string format, TZ_Ptr tz)
 }
 
 #endif
+
+#ifndef __MINGW32__
+/* Imbuing a stream with a new locale costs far more than formatting
+ * the date, so each thread keeps one imbued stream per facet type and
+ * only changes the facet's format string between calls.
+ */
+template <typename Facet, typename T> static std::string
+format_with_facet(const char* format, const T& value)
+{
+    static thread_local Facet* facet = nullptr;
+    static thread_local std::unique_ptr<std::stringstream> ss;
+    if (!ss)
+    {
+        //The locale frees the facet, so it must be heap-allocated.
+        facet = new Facet;
+        ss.reset(new std::stringstream);
+        ss->imbue(std::locale(gnc_get_locale(), facet));
+    }
+    facet->format(normalize_format(format).c_str());
+    ss->str("");
+    ss->clear();
+    *ss << value;
+    return ss->str();
+}
+#endif
+
 std::string
 GncDateTimeImpl::format(const char* format) const
 {
@@ -497,11 +525,7 @@ GncDateTimeImpl::format(const char* format) const
     return win_date_format(sformat, tm);
 #else
     using Facet = boost::local_time::local_time_facet;
-    auto output_facet(new Facet(normalize_format(format).c_str()));
-    std::stringstream ss;
-    ss.imbue(std::locale(gnc_get_locale(), output_facet));
-    ss << m_time;
-    return ss.str();
+    return format_with_facet<Facet>(format, m_time);
 #endif
 }
 
@@ -519,11 +543,7 @@ GncDateTimeImpl::format_zulu(const char* format) const
     using Facet = boost::local_time::local_time_facet;
     auto offset = m_time.local_time() - m_time.utc_time();
     auto zulu_time = m_time - offset;
-    auto output_facet(new Facet(normalize_format(format).c_str()));
-    std::stringstream ss;
-    ss.imbue(std::locale(gnc_get_locale(), output_facet));
-    ss << zulu_time;
-    return ss.str();
+    return format_with_facet<Facet>(format, zulu_time);
 #endif
 }
 
@@ -553,7 +573,16 @@ GncDateImpl::GncDateImpl(const std::string str, const std::string fmt) :
     if (iter == GncDate::c_formats.cend())
         throw std::invalid_argument(N_("Unknown date format specifier passed as argument."));
 
-    boost::regex r(iter->m_re);
+    /* Compiling the regexes costs far more than matching them, and
+     * importers parse a date for each line, so compile them only once. */
+    static const auto format_regexes = []()
+    {
+        std::vector<boost::regex> regexes;
+        for (const auto& format : GncDate::c_formats)
+            regexes.emplace_back (format.m_re);
+        return regexes;
+    }();
+    const auto& r = format_regexes[iter - GncDate::c_formats.cbegin()];
     boost::smatch what;
     if(!boost::regex_search(str, what, r))  // regex didn't find a match
         throw std::invalid_argument (N_("Value can't be parsed into a date using the selected date format."));
@@ -597,12 +626,7 @@ GncDateImpl::format(const char* format) const
     return win_date_format(format, to_tm(m_greg));
 #else
     using Facet = boost::gregorian::date_facet;
-    std::stringstream ss;
-    //The stream destructor frees the facet, so it must be heap-allocated.
-    auto output_facet(new Facet(normalize_format(format).c_str()));
-    ss.imbue(std::locale(gnc_get_locale(), output_facet));
-    ss << m_greg;
-    return ss.str();
+    return format_with_facet<Facet>(format, m_greg);
 #endif
 }
 
@@ -732,3 +756,217 @@ bool operator==(const GncDate& a, const GncDate& b) { return *(a.m_impl) == *(b.
 bool operator<=(const GncDate& a, const GncDate& b) { return *(a.m_impl) <= *(b.m_impl); }
 bool operator>=(const GncDate& a, const GncDate& b) { return *(a.m_impl) >= *(b.m_impl); }
 bool operator!=(const GncDate& a, const GncDate& b) { return *(a.m_impl) != *(b.m_impl); }
+
+/* GncDateFormatter */
+
+static constexpr time64 secs_per_day = 86400;
+
+static time64
+floor_div(time64 a, time64 b)
+{
+    return a >= 0 ? a / b : -((-a - 1) / b) - 1;
+}
+
+/* Days since 1970-01-01 to a proleptic Gregorian date, after Howard
+ * Hinnant's civil_from_days. */
+static void
+civil_from_days(time64 days, int& year, int& month, int& day)
+{
+    days += 719468;
+    auto era = (days >= 0 ? days : days - 146096) / 146097;
+    auto doe = static_cast<unsigned>(days - era * 146097);
+    auto yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    auto doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    auto mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int>(yoe + era * 400) + (month <= 2);
+}
+
+/* The inverse of civil_from_days, after Howard Hinnant's
+ * days_from_civil. */
+static time64
+days_from_civil(int year, int month, int day)
+{
+    year -= month <= 2;
+    auto era = (year >= 0 ? year : year - 399) / 400;
+    auto yoe = static_cast<unsigned>(year - era * 400);
+    auto doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    auto doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return static_cast<time64>(era) * 146097 + doe - 719468;
+}
+
+bool
+GncDateTime::local_tm(time64 time, struct tm& tm) noexcept
+{
+    TZ_Span span;
+    if (!tzp->get_span(time, span))
+        return false;
+    auto local = time + span.offset;
+    auto days = floor_div(local, secs_per_day);
+    auto secs = local - days * secs_per_day;
+    int year, month, day;
+    civil_from_days(days, year, month, day);
+    memset(&tm, 0, sizeof(tm));
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = secs / 3600;
+    tm.tm_min = secs / 60 % 60;
+    tm.tm_sec = secs % 60;
+    tm.tm_wday = (days % 7 + 11) % 7; // 1970-01-01 was a Thursday.
+    tm.tm_yday = days - days_from_civil(year, 1, 1);
+    tm.tm_isdst = span.is_dst;
+#if HAVE_STRUCT_TM_GMTOFF
+    tm.tm_gmtoff = span.offset;
+#endif
+    return true;
+}
+
+bool
+GncDateTime::local_day_time(time64 time, int secs_of_day,
+                            time64& result) noexcept
+{
+    TZ_Span span;
+    if (!tzp->get_span(time, span))
+        return false;
+    auto days = floor_div(time + span.offset, secs_per_day);
+    int year, month, day;
+    civil_from_days(days, year, month, day);
+    /* Converting a struct tm takes the zone for the local year, the
+     * offset table the one for the UTC year. They differ only around
+     * the new year. */
+    if ((month == 1 && day == 1) || (month == 12 && day == 31))
+        return false;
+    /* Times of day close to an offset change can be skipped or
+     * repeated, and struct tm conversion resolves those its own way. */
+    auto day_start = days * secs_per_day - span.offset;
+    if (day_start - secs_per_day < span.start ||
+        day_start + 2 * secs_per_day > span.end)
+        return false;
+    result = day_start + secs_of_day;
+    return true;
+}
+
+static size_t
+copy_to_buffer(char* buf, size_t len, const std::string& str)
+{
+    if (!len)
+        return 0;
+    auto count = str.copy(buf, len - 1);
+    buf[count] = '\0';
+    return strlen(buf);
+}
+
+static inline void
+put_digits(char* out, int value, int width)
+{
+    for (auto pos = width - 1; pos >= 0; --pos, value /= 10)
+        out[pos] = '0' + value % 10;
+}
+
+GncDateFormatter::GncDateFormatter(const std::string& format) :
+    m_format(format), m_direct(true), m_has_time(false)
+{
+    auto normalized = normalize_format(format);
+    std::string literal;
+    for (auto c = normalized.cbegin(); c != normalized.cend(); ++c)
+    {
+        if (*c != '%')
+        {
+            literal += *c;
+            continue;
+        }
+        if (++c == normalized.cend() || !strchr("dmyYHMS", *c))
+        {
+            m_direct = false;
+            break;
+        }
+        if (!literal.empty())
+            m_parts.push_back({0, std::move(literal)});
+        literal.clear();
+        m_parts.push_back({*c, std::string()});
+        m_has_time = m_has_time || strchr("HMS", *c);
+    }
+    if (!literal.empty())
+        m_parts.push_back({0, std::move(literal)});
+}
+
+size_t
+GncDateFormatter::write_parts(char* buf, size_t len, int year, int month,
+                              int day, int secs_of_day) const
+{
+    char digits[4];
+    size_t pos = 0;
+
+    if (!len)
+        return 0;
+    for (const auto& part : m_parts)
+    {
+        const char* text = digits;
+        size_t count = 2;
+        switch (part.conversion)
+        {
+        case 0:
+            text = part.text.data();
+            count = part.text.size();
+            break;
+        case 'd':
+            put_digits(digits, day, 2);
+            break;
+        case 'm':
+            put_digits(digits, month, 2);
+            break;
+        case 'y':
+            put_digits(digits, year % 100, 2);
+            break;
+        case 'Y':
+            put_digits(digits, year, 4);
+            count = 4;
+            break;
+        case 'H':
+            put_digits(digits, secs_of_day / 3600, 2);
+            break;
+        case 'M':
+            put_digits(digits, secs_of_day / 60 % 60, 2);
+            break;
+        case 'S':
+            put_digits(digits, secs_of_day % 60, 2);
+            break;
+        }
+        count = std::min(count, len - 1 - pos);
+        memcpy(buf + pos, text, count);
+        pos += count;
+    }
+    buf[pos] = '\0';
+    return pos;
+}
+
+size_t
+GncDateFormatter::write(char* buf, size_t len, time64 time) const
+{
+    if (!m_direct || time < MINTIME + secs_per_day ||
+        time > MAXTIME - secs_per_day)
+        return copy_to_buffer(buf, len,
+                              GncDateTime(time).format(m_format.c_str()));
+
+    auto local = time + tzp->get_utc_offset(time);
+    auto days = floor_div(local, secs_per_day);
+    int year, month, day;
+    civil_from_days(days, year, month, day);
+    return write_parts(buf, len, year, month, day,
+                       local - days * secs_per_day);
+}
+
+size_t
+GncDateFormatter::write(char* buf, size_t len, int year, int month,
+                        int day) const
+{
+    using Calendar = boost::gregorian::gregorian_calendar;
+    if (!m_direct || m_has_time || year < 1400 || year > 9999 ||
+        month < 1 || month > 12 || day < 1 ||
+        day > Calendar::end_of_month_day(year, month))
+        return copy_to_buffer(buf, len,
+                              GncDate(year, month, day).format(m_format.c_str()));
+    return write_parts(buf, len, year, month, day, 0);
+}
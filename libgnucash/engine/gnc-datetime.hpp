@@ -156,7 +156,28 @@ public:
  *  @return a std::string in the format YYYYMMDDHHMMSS.
  */
     static std::string timestamp();
-    
+/** Fill a struct tm with the local time of @a time as
+ *  static_cast<struct tm>(GncDateTime(time)) would, but from the time
+ *  zone's offset table instead of the zone rules.
+ *  @param time Seconds from the POSIX epoch.
+ *  @param tm The struct tm to fill.
+ *  @return false, leaving @a tm alone, if @a time is outside the years
+ *  the offset table covers.
+ */
+    static bool local_tm(time64 time, struct tm& tm) noexcept;
+/** Find the time @a secs_of_day seconds after local midnight on the
+ *  local day of @a time, as converting a struct tm with that time of
+ *  day would, with integer arithmetic.
+ *  @param time Seconds from the POSIX epoch.
+ *  @param secs_of_day Seconds after midnight, less than a day.
+ *  @param result Set to the time found.
+ *  @return false, leaving @a result alone, if the UTC offset changes
+ *  on or next to that day, on new year's eve and day, or outside the
+ *  years the offset table covers. Use a struct tm then.
+ */
+    static bool local_day_time(time64 time, int secs_of_day,
+                               time64& result) noexcept;
+
 private:
     std::unique_ptr<GncDateTimeImpl> m_impl;
 };
@@ -311,4 +332,66 @@ bool operator>=(const GncDate& a, const GncDate& b);
 bool operator!=(const GncDate& a, const GncDate& b);
 /**@}*/
 
+/** A date format string compiled once for printing many dates.
+ *
+ * Printing a GncDateTime or GncDate goes through a boost::date_time
+ * facet and a stream and looks up the time zone rules for each date,
+ * which dominates the time taken to fill a register or a report. A
+ * GncDateFormatter splits its format into literal text and conversions
+ * once, and writes the numeric conversions (d, m, y, Y, H, M and S)
+ * straight into the caller's buffer, taking the UTC offset of local
+ * times from the time zone's offset table.
+ *
+ * Formats with any other conversion, such as month names, and dates
+ * outside the supported range are passed to GncDateTime::format() or
+ * GncDate::format(), so the output and the exceptions are always the
+ * same as theirs.
+ */
+class GncDateFormatter
+{
+public:
+/** Compile a format.
+ *  @param format A strftime-style format as accepted by
+ *  GncDateTime::format().
+ */
+    explicit GncDateFormatter(const std::string& format);
+/** The format as passed to the constructor. */
+    const std::string& format() const { return m_format; }
+/** Print a time in the local time zone.
+ *
+ *  Like strncpy() the output is cut to fit in @a len bytes, but it is
+ *  always nul-terminated.
+ *  @param buf The buffer to print into.
+ *  @param len The size of @a buf.
+ *  @param time Seconds from the POSIX epoch.
+ *  @return The length of the string in @a buf.
+ *  @exception std::invalid_argument if the year is outside the constraints.
+ */
+    size_t write(char* buf, size_t len, time64 time) const;
+/** Print a date.
+ *  @param buf The buffer to print into.
+ *  @param len The size of @a buf.
+ *  @param year The year, 1400 to 9999.
+ *  @param month The month, 1 to 12.
+ *  @param day The day of the month.
+ *  @return The length of the string in @a buf.
+ *  @exception std::out_of_range if the date is not valid.
+ */
+    size_t write(char* buf, size_t len, int year, int month, int day) const;
+
+private:
+    struct Part
+    {
+        char conversion; // 0 for literal text
+        std::string text;
+    };
+    size_t write_parts(char* buf, size_t len, int year, int month, int day,
+                       int secs_of_day) const;
+
+    std::string m_format;
+    std::vector<Part> m_parts;
+    bool m_direct;      // Every conversion is a numeric one
+    bool m_has_time;    // Uses %H, %M or %S
+};
+
 #endif // __GNC_DATETIME_HPP__
@@ -33,6 +33,7 @@
 #include "TransactionP.h"
 #include "gnc-commodity.h"
 #include "gnc-pricedb-p.h"
+#include "TransLog.h"
 
 /** gnc file backend library name */
 #define GNC_LIB_NAME "gncmod-backend-xml"
@@ -140,6 +141,8 @@ gnc_engine_init_static(int argc, char ** argv)
 void
 gnc_engine_shutdown (void)
 {
+    /* The log is written in the background; don't lose the tail. */
+    xaccCloseLog();
     qof_log_shutdown();
     qof_close();
     engine_is_initialized = 0;
@@ -37,7 +37,17 @@ extern "C"
 /* All algorithms from Donald E. Knuth, "The Art of Computer
  * Programming, Volume 2: Seminumerical Algorithms", 3rd Ed.,
  * Addison-Wesley, 1998.
+ *
+ * Where the compiler provides a native unsigned 128-bit type (GCC and
+ * Clang on 64-bit targets) multiplication, division and gcd use it
+ * instead of the limb arithmetic. The representation and the overflow
+ * and NaN rules are the same either way. Define GNC_INT128_PORTABLE to
+ * use the limb arithmetic everywhere; the tests are built both ways.
  */
+#if defined(__SIZEOF_INT128__) && !defined(GNC_INT128_PORTABLE) && \
+    ((defined(__GNUC__) && __GNUC__ >= 5) || defined(__clang__))
+#define GNC_INT128_NATIVE 1
+#endif
 
 namespace {
     static const unsigned int upper_num_bits = 61;
@@ -62,6 +72,51 @@ namespace {
     {
         return leg & nummask;
     }
+/* leg must not be 0. */
+    static inline unsigned int trailing_zeros(uint64_t leg)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(leg);
+#else
+        unsigned int zeros {};
+        for (; !(leg & 1); leg >>= 1)
+            ++zeros;
+        return zeros;
+#endif
+    }
+#ifdef GNC_INT128_NATIVE
+    __extension__ typedef unsigned __int128 uint128_t;
+
+    static inline uint128_t to_native(uint64_t hi, uint64_t lo)
+    {
+        return (static_cast<uint128_t>(hi) << GncInt128::legbits) | lo;
+    }
+    static inline uint64_t native_hi(uint128_t val)
+    {
+        return static_cast<uint64_t>(val >> GncInt128::legbits);
+    }
+    static inline unsigned int trailing_zeros(uint128_t val)
+    {
+        auto lo = static_cast<uint64_t>(val);
+        return lo ? trailing_zeros(lo) :
+            GncInt128::legbits + trailing_zeros(native_hi(val));
+    }
+#endif
+/* Stein's binary gcd on unsigned magnitudes, neither of which may be 0. */
+    template <typename T> static T binary_gcd(T u, T v)
+    {
+        auto shift = trailing_zeros(u | v);
+        u >>= trailing_zeros(u);
+        do
+        {
+            v >>= trailing_zeros(v);
+            if (u > v)
+                std::swap(u, v);
+            v -= u;
+        }
+        while (v);
+        return u << shift;
+    }
 }
 
 GncInt128::GncInt128 () : m_hi {0}, m_lo {0}{}
@@ -194,6 +249,14 @@ GncInt128::gcd(GncInt128 b) const noexcept
     if (isOverflow() || isNan())
         return *this;
 
+    auto hi = get_num(m_hi);
+    auto bhi = get_num(b.m_hi);
+    if (!hi && !bhi)
+        return GncInt128(binary_gcd(m_lo, b.m_lo));
+#ifdef GNC_INT128_NATIVE
+    auto common = binary_gcd(to_native(hi, m_lo), to_native(bhi, b.m_lo));
+    return GncInt128(native_hi(common), static_cast<uint64_t>(common));
+#else
     GncInt128 a (isNeg() ? -(*this) : *this);
     if (b.isNeg()) b = -b;
 
@@ -216,6 +279,7 @@ GncInt128::gcd(GncInt128 b) const noexcept
         t = a - b;  //B6
     }
     return a << k;
+#endif
 }
 
 /* Since u * v = gcd(u, v) * lcm(u, v), we find lcm by u / gcd * v. */
@@ -505,6 +569,19 @@ GncInt128::operator*= (const GncInt128& b) noexcept
         return *this;
     }
 
+#ifdef GNC_INT128_NATIVE
+    uint128_t product;
+    if (__builtin_mul_overflow(to_native(hi, m_lo), to_native(bhi, b.m_lo),
+                               &product) || native_hi(product) & flagmask)
+    {
+        flags |= overflow;
+        m_hi = set_flags(m_hi, flags);
+        return *this;
+    }
+    m_lo = static_cast<uint64_t>(product);
+    m_hi = set_flags(native_hi(product), flags);
+    return *this;
+#else
     unsigned int abits {bits()}, bbits {b.bits()};
     /* If the product of the high bytes < 7fff then the result will have abits +
      * bbits -1 bits and won't actually overflow. It's not worth the effort to
@@ -543,43 +620,29 @@ GncInt128::operator*= (const GncInt128& b) noexcept
     uint64_t bv[sublegs] {(b.m_lo & sublegmask), (b.m_lo >> sublegbits),
             (bhi & sublegmask), (bhi >> sublegbits)};
     uint64_t rv[sublegs] {};
-    uint64_t carry {}, scratch {};
-
-    rv[0] = av[0] * bv[0];
-
-    rv[1] = av[1] * bv [0];
-    scratch = rv[1] + av[0] * bv[1];
-    carry = rv[1] > scratch ? 1 : 0;
-    rv[1] = scratch;
-
-    rv[2] = av[2] * bv[0] + carry; //0xffff^2 + 1 < 0xffffffff, can't overflow
-    scratch = rv[2] + av[1] * bv[1];
-    carry = rv[2] > scratch ? 1 : 0;
-    rv[2] = scratch + av[0] * bv[2];
-    carry += scratch > rv[2] ? 1 : 0;
-
-    rv[3] = av[3] * bv[0] + carry;
-    scratch = rv[3] + av[2] * bv[1];
-    carry = rv[3] > scratch ? 1 : 0;
-    rv[3] = scratch + av[1] * bv[2];
-    carry += scratch > rv[3] ? 1 : 0;
-    scratch = rv[3] + av[0] * bv[3];
-    carry += rv[3] > scratch ? 1 : 0;
-    rv[3] = scratch;
-
-    if (carry) //Shouldn't happen because of the checks above
+    bool overflowed {false};
+
+    /* Each partial product plus the digit and carry fits in 64 bits:
+     * (2^32 - 1)^2 + 2 * (2^32 - 1) = 2^64 - 1. */
+    for (unsigned int i = 0; i < sublegs; ++i)
     {
-        flags |= overflow;
-        m_hi = set_flags(m_hi, flags);
-        return *this;
+        uint64_t carry {};
+        for (unsigned int j = 0; i + j < sublegs; ++j)
+        {
+            auto digit = av[i] * bv[j] + rv[i + j] + carry;
+            rv[i + j] = digit & sublegmask;
+            carry = digit >> sublegbits;
+        }
+        if (carry)
+            overflowed = true;
+        for (unsigned int j = sublegs - i; j < sublegs; ++j)
+            if (av[i] && bv[j])
+                overflowed = true;
     }
 
     m_lo = rv[0] + (rv[1] << sublegbits);
-    carry = rv[1] >> sublegbits;
-    carry += (rv[1] << sublegbits) > m_lo || rv[0] > m_lo ? 1 : 0;
-    hi = rv[2] + (rv[3] << sublegbits) + carry;
-    if ((rv[3] << sublegbits) > hi || rv[2] > hi || (rv[3] >> sublegbits) ||
-        hi & flagmask)
+    hi = rv[2] + (rv[3] << sublegbits);
+    if (overflowed || hi & flagmask)
     {
         flags |= overflow;
         m_hi = set_flags(hi, flags);
@@ -587,8 +650,10 @@ GncInt128::operator*= (const GncInt128& b) noexcept
     }
     m_hi = set_flags(hi, flags);
     return *this;
+#endif
 }
 
+#ifndef GNC_INT128_NATIVE
 namespace {
 /* Algorithm from Knuth (full citation at operator*=) p272ff.  Again, there
  * are faster algorithms out there, but they require much larger numbers to
@@ -632,7 +697,7 @@ div_multi_leg (uint64_t* u, size_t m, uint64_t* v, size_t n,
         }
         else
             carry = UINT64_C(0);
-        assert (v[i] < sublegmask);
+        assert (v[i] <= sublegmask);
     }
     assert (carry == UINT64_C(0));
     for (int j = m - n; j >= 0; j--) //D3
@@ -648,49 +713,46 @@ div_multi_leg (uint64_t* u, size_t m, uint64_t* v, size_t n,
             --qhat;
             rhat += v[n - 1];
         }
+        /* D4: multiply and subtract, propagating the borrow through
+         * every leg including the top one. */
         carry = UINT64_C(0);
         uint64_t borrow {};
-        for (size_t k = 0; k < n; ++k) //D4
+        for (size_t k = 0; k < n; ++k)
         {
             auto subend = qhat * v[k] + carry;
             carry = subend >> sublegbits;
-            subend &= sublegmask;
-            if (u[j + k] >= subend)
-            {
-                u[j + k] = u[j + k] - subend;
-                borrow = UINT64_C(0);
-            }
-            else
-            {
-                if (u[j + k + 1] > 0)
-                    --u[j + k + 1];
-                else
-                    ++borrow;
-                u[j + k] = u[j + k] + sublegmask + 1 - subend;
-                u[j + k] &= sublegmask;
-            }
+            subend = (subend & sublegmask) + borrow;
+            borrow = u[j + k] < subend ? 1 : 0;
+            u[j + k] = (u[j + k] + (borrow << sublegbits) - subend) & sublegmask;
         }
-        u[j + n] -= carry;
+        auto subend = carry + borrow;
+        borrow = u[j + n] < subend ? 1 : 0;
+        u[j + n] = (u[j + n] + (borrow << sublegbits) - subend) & sublegmask;
         qv[j] = qhat;
         if (borrow) //D5
-        { //D6
+        { //D6: qhat was one too big, add the divisor back.
             --qv[j];
             carry = UINT64_C(0);
             for (size_t k = 0; k < n; ++k)
             {
                 u[j + k] += v[k] + carry;
-                if (u[j + k] > sublegmask)
-                {
-                    carry = u[j + k] >> sublegbits;
-                    u[j + k] &= sublegmask;
-                }
+                carry = u[j + k] >> sublegbits;
+                u[j + k] &= sublegmask;
             }
-            u[j + n] += carry;
+            u[j + n] = (u[j + n] + carry) & sublegmask;
         }
     }//D7
+    /* D8: Unnormalize the remainder before building it, the normalized
+     * one may not fit in a GncInt128. */
+    carry = UINT64_C(0);
+    for (int i = n - 1; i >= 0; --i)
+    {
+        auto part = (carry << sublegbits) + u[i];
+        u[i] = part / d;
+        carry = part % d;
+    }
     q = GncInt128 ((qv[3] << sublegbits) + qv[2], (qv[1] << sublegbits) + qv[0]);
     r = GncInt128 ((u[3] << sublegbits) + u[2], (u[1] << sublegbits) + u[0]);
-    r /= d;
     if (negative) q = -q;
     if (rnegative) r = -r;
 }
@@ -722,6 +784,7 @@ div_single_leg (uint64_t* u, size_t m, uint64_t v,
 }
 
 }// namespace
+#endif
 
 void
 GncInt128::div (const GncInt128& b, GncInt128& q, GncInt128& r) const noexcept
@@ -793,6 +856,15 @@ GncInt128::div (const GncInt128& b, GncInt128& q, GncInt128& r) const noexcept
         return;
     }
 
+#ifdef GNC_INT128_NATIVE
+    auto dividend = to_native(hi, m_lo), divisor = to_native(bhi, b.m_lo);
+    auto quot = dividend / divisor, rem = dividend % divisor;
+    q.m_lo = static_cast<uint64_t>(quot);
+    q.m_hi = set_flags(native_hi(quot), qflags);
+    r.m_lo = static_cast<uint64_t>(rem);
+    r.m_hi = set_flags(native_hi(rem), rflags);
+#else
+
     uint64_t u[sublegs + 2] {(m_lo & sublegmask), (m_lo >> sublegbits),
             (hi & sublegmask), (hi >> sublegbits), 0, 0};
     uint64_t v[sublegs] {(b.m_lo & sublegmask), (b.m_lo >> sublegbits),
@@ -805,6 +877,7 @@ GncInt128::div (const GncInt128& b, GncInt128& q, GncInt128& r) const noexcept
         return div_single_leg (u, m, v[0], q, r);
 
     return div_multi_leg (u, m, v, n, q, r);
+#endif
 }
 
 GncInt128&
@@ -90,6 +90,11 @@ typedef struct GNCLotPrivate
     signed char is_closed;
 #define LOT_CLOSED_UNKNOWN (-1)
 
+    /* Cached sum of the split amounts, kept current as splits join and
+     * leave the lot. Only valid if balance_valid is set. */
+    gnc_numeric balance;
+    gboolean balance_valid;
+
     /* traversal marker, handy for preventing recursion */
     unsigned char marker;
 } GNCLotPrivate;
@@ -113,9 +118,37 @@ gnc_lot_init(GNCLot* lot)
     priv->account = NULL;
     priv->splits = NULL;
     priv->is_closed = LOT_CLOSED_UNKNOWN;
+    priv->balance = gnc_numeric_zero ();
+    priv->balance_valid = FALSE;
     priv->marker = 0;
 }
 
+/* Set the cached closed state, telling the lot's account when the lot
+ * stops or starts counting as closed so that it can keep its list of
+ * open lots current. */
+static void
+gnc_lot_set_closed_state (GNCLot *lot, signed char is_closed)
+{
+    GNCLotPrivate* priv = GET_PRIVATE(lot);
+    gboolean was_closed = (priv->is_closed == TRUE);
+
+    priv->is_closed = is_closed;
+    if (priv->account && was_closed != (is_closed == TRUE))
+        gnc_account_lot_closed_changed (priv->account, lot, is_closed == TRUE);
+}
+
+/* Add @a amount to the cached balance, or drop the cache if the sum
+ * can't be kept exactly. */
+static void
+gnc_lot_adjust_balance (GNCLotPrivate *priv, gnc_numeric amount)
+{
+    if (!priv->balance_valid)
+        return;
+    priv->balance = gnc_numeric_add_fixed (priv->balance, amount);
+    if (gnc_numeric_check (priv->balance) != GNC_ERROR_OK)
+        priv->balance_valid = FALSE;
+}
+
 static void
 gnc_lot_dispose(GObject *lotp)
 {
@@ -182,7 +215,7 @@ gnc_lot_set_property (GObject* object,
     switch (prop_id)
     {
     case PROP_IS_CLOSED:
-        priv->is_closed = g_value_get_int(value);
+        gnc_lot_set_closed_state (lot, g_value_get_int(value));
         break;
     case PROP_MARKER:
         priv->marker = g_value_get_int(value);
@@ -396,7 +429,8 @@ gnc_lot_set_closed_unknown(GNCLot* lot)
     if (lot != NULL)
     {
         priv = GET_PRIVATE(lot);
-        priv->is_closed = LOT_CLOSED_UNKNOWN;
+        priv->balance_valid = FALSE;
+        gnc_lot_set_closed_state (lot, LOT_CLOSED_UNKNOWN);
     }
 }
 
@@ -482,31 +516,33 @@ gnc_lot_get_balance (GNCLot *lot)
     priv = GET_PRIVATE(lot);
     if (!priv->splits)
     {
-        priv->is_closed = FALSE;
+        gnc_lot_set_closed_state (lot, FALSE);
         return zero;
     }
 
-    /* Sum over splits; because they all belong to same account
-     * they will have same denominator.
-     */
-    for (node = priv->splits; node; node = node->next)
+    if (priv->balance_valid)
     {
-        Split *s = node->data;
-        gnc_numeric amt = xaccSplitGetAmount (s);
-        baln = gnc_numeric_add_fixed (baln, amt);
-        g_assert (gnc_numeric_check (baln) == GNC_ERROR_OK);
-    }
-
-    /* cache a zero balance as a closed lot */
-    if (gnc_numeric_equal (baln, zero))
-    {
-        priv->is_closed = TRUE;
+        baln = priv->balance;
     }
     else
     {
-        priv->is_closed = FALSE;
+        /* Sum over splits; because they all belong to same account
+         * they will have same denominator.
+         */
+        for (node = priv->splits; node; node = node->next)
+        {
+            Split *s = node->data;
+            gnc_numeric amt = xaccSplitGetAmount (s);
+            baln = gnc_numeric_add_fixed (baln, amt);
+            g_assert (gnc_numeric_check (baln) == GNC_ERROR_OK);
+        }
+        priv->balance = baln;
+        priv->balance_valid = TRUE;
     }
 
+    /* cache a zero balance as a closed lot */
+    gnc_lot_set_closed_state (lot, gnc_numeric_equal (baln, zero));
+
     return baln;
 }
 
@@ -605,9 +641,10 @@ gnc_lot_add_split (GNCLot *lot, Split *split)
     xaccSplitSetLot(split, lot);
 
     priv->splits = g_list_append (priv->splits, split);
+    gnc_lot_adjust_balance (priv, split->amount);
 
     /* for recomputation of is-closed */
-    priv->is_closed = LOT_CLOSED_UNKNOWN;
+    gnc_lot_set_closed_state (lot, LOT_CLOSED_UNKNOWN);
     gnc_lot_commit_edit(lot);
 
     qof_event_gen (QOF_INSTANCE(lot), QOF_EVENT_MODIFY, NULL);
@@ -626,7 +663,9 @@ gnc_lot_remove_split (GNCLot *lot, Split *split)
     qof_instance_set_dirty(QOF_INSTANCE(lot));
     priv->splits = g_list_remove (priv->splits, split);
     xaccSplitSetLot(split, NULL);
-    priv->is_closed = LOT_CLOSED_UNKNOWN;   /* force an is-closed computation */
+    gnc_lot_adjust_balance (priv, gnc_numeric_neg (split->amount));
+    /* force an is-closed computation */
+    gnc_lot_set_closed_state (lot, LOT_CLOSED_UNKNOWN);
 
     if (NULL == priv->splits)
     {
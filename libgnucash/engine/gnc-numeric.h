@@ -423,6 +423,13 @@ gnc_numeric gnc_numeric_neg(gnc_numeric a);
  * returned value is "|a/b|". */
 gnc_numeric gnc_numeric_abs(gnc_numeric a);
 
+/* Adding two amounts in the same commodity needs neither a common
+ * denominator nor rounding, so the _fixed shortcuts do it inline and
+ * only call out when the denominators differ or the sum overflows. */
+#if (defined(__GNUC__) && __GNUC__ >= 5) || defined(__clang__)
+#define GNC_NUMERIC_HAVE_OVERFLOW_BUILTINS 1
+#endif
+
 /**
  * Shortcut for common case: gnc_numeric_add(a, b, GNC_DENOM_AUTO,
  *                        GNC_HOW_DENOM_FIXED | GNC_HOW_RND_NEVER);
@@ -430,6 +437,12 @@ gnc_numeric gnc_numeric_abs(gnc_numeric a);
 static inline
 gnc_numeric gnc_numeric_add_fixed(gnc_numeric a, gnc_numeric b)
 {
+#ifdef GNC_NUMERIC_HAVE_OVERFLOW_BUILTINS
+    gint64 sum;
+    if (a.denom == b.denom && a.denom > 0 &&
+        !__builtin_add_overflow(a.num, b.num, &sum))
+        return gnc_numeric_create(sum, a.denom);
+#endif
     return gnc_numeric_add(a, b, GNC_DENOM_AUTO,
                            GNC_HOW_DENOM_FIXED | GNC_HOW_RND_NEVER);
 }
@@ -441,9 +454,31 @@ gnc_numeric gnc_numeric_add_fixed(gnc_numeric a, gnc_numeric b)
 static inline
 gnc_numeric gnc_numeric_sub_fixed(gnc_numeric a, gnc_numeric b)
 {
+#ifdef GNC_NUMERIC_HAVE_OVERFLOW_BUILTINS
+    gint64 diff;
+    if (a.denom == b.denom && a.denom > 0 &&
+        !__builtin_sub_overflow(a.num, b.num, &diff))
+        return gnc_numeric_create(diff, a.denom);
+#endif
     return gnc_numeric_sub(a, b, GNC_DENOM_AUTO,
                            GNC_HOW_DENOM_FIXED | GNC_HOW_RND_NEVER);
 }
+
+/** Returns the sum of the @a n values in @a values.
+ *
+ * The result has the same value as adding the values one at a time
+ * with gnc_numeric_add_fixed(), starting from zero, but values with
+ * the same denominator are summed in 128 bits and converted once at
+ * the end, so the sum is exact even when a running total would
+ * overflow on the way. Runs of values sharing a denominator, as the
+ * amounts of one account do, are summed without any per-value checks.
+ *
+ * @param values An array of values.
+ * @param n The number of values in @a values.
+ * @return The sum, zero if @a n is 0, or an error value if any of the
+ * values is one.
+ */
+gnc_numeric gnc_numeric_sum(const gnc_numeric *values, gsize n);
 /** @} */
 
 
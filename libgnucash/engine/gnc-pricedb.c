@@ -1747,6 +1747,8 @@ pricedb_get_prices_internal(GNCPriceDB *db, const gnc_commodity *commodity,
     PriceList *forward_list = NULL, *reverse_list = NULL;
     g_return_val_if_fail (db != NULL, NULL);
     g_return_val_if_fail (commodity != NULL, NULL);
+    qof_instance_record_read (commodity);
+    qof_instance_record_read (currency);
     forward_hash = g_hash_table_lookup(db->commodity_hash, commodity);
     if (currency && bidi)
         reverse_hash = g_hash_table_lookup(db->commodity_hash, currency);
@@ -2039,6 +2041,7 @@ gnc_pricedb_lookup_nearest_in_time_any_currency_t64(GNCPriceDB *db,
     if (!db || !commodity) return NULL;
     ENTER ("db=%p commodity=%p", db, commodity);
 
+    qof_instance_record_read (commodity);
     pricedb_pricelist_traversal(db, price_list_scan_any_currency, &helper);
     prices = g_list_sort(prices, compare_prices_by_date);
     result = nearest_to(prices, commodity, t);
@@ -2059,6 +2062,7 @@ gnc_pricedb_lookup_latest_before_any_currency_t64(GNCPriceDB *db,
     if (!db || !commodity) return NULL;
     ENTER ("db=%p commodity=%p", db, commodity);
 
+    qof_instance_record_read (commodity);
     pricedb_pricelist_traversal(db, price_list_scan_any_currency,
                                        &helper);
     prices = g_list_sort(prices, compare_prices_by_date);
@@ -2083,6 +2087,8 @@ gnc_pricedb_has_prices(GNCPriceDB *db,
 
     if (!db || !commodity) return FALSE;
     ENTER ("db=%p commodity=%p currency=%p", db, commodity, currency);
+    qof_instance_record_read (commodity);
+    qof_instance_record_read (currency);
     currency_hash = g_hash_table_lookup(db->commodity_hash, commodity);
     if (!currency_hash)
     {
@@ -0,0 +1,350 @@
+/********************************************************************\
+ * gnc-split-table.cpp -- Sort and group a list of splits natively. *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+
+extern "C"
+{
+#include <config.h>
+#include "Account.h"
+#include "Split.h"
+#include "Transaction.h"
+#include "gnc-date.h"
+#include "gnc-split-table.h"
+}
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+static QofLogModule log_module = GNC_MOD_ENGINE;
+
+/* One materialized column. Only one of the vectors is filled, indexed
+ * by the split's position in the list the table was made from. */
+struct GncSplitTableColumn
+{
+    enum { NONE, INT, STRING, NUMERIC } type = NONE;
+    std::vector<int64_t> ints;
+    std::vector<std::string> strings;
+    std::vector<gnc_numeric> numerics;
+
+    int compare (guint a, guint b) const
+    {
+        switch (type)
+        {
+        case INT:
+            return ints[a] < ints[b] ? -1 : ints[a] > ints[b] ? 1 : 0;
+        case STRING:
+            return strings[a].compare (strings[b]);
+        case NUMERIC:
+            return gnc_numeric_compare (numerics[a], numerics[b]);
+        default:
+            return 0;
+        }
+    }
+};
+
+using GncSplitColumnId = std::pair<GncSplitColumn, GncDateBucket>;
+
+struct GncSplitTableImpl
+{
+    std::vector<Split*> splits;
+    /* Row number -> index into splits and the columns. */
+    std::vector<guint> order;
+    std::map<GncSplitColumnId, GncSplitTableColumn> columns;
+    /* Level-major, one group number per row. */
+    std::vector<std::vector<guint>> groups;
+};
+
+static int64_t
+date_bucket (time64 date, GncDateBucket bucket)
+{
+    struct tm tm;
+
+    if (bucket == GNC_DATE_BUCKET_EXACT)
+        return date;
+    if (bucket == GNC_DATE_BUCKET_WEEK)
+    {
+        /* Numbered like gnc:date-to-week in date-utilities.scm. */
+        static const int64_t secs_per_day = 86400;
+        auto weekstart = gnc_start_of_week ();
+        auto offset = gnc_time64_get_day_start (date) -
+            secs_per_day * (1 + (weekstart ? weekstart : 1));
+        auto week = offset / (7 * secs_per_day);
+        return offset % (7 * secs_per_day) < 0 ? week - 1 : week;
+    }
+    if (!gnc_localtime_r (&date, &tm))
+        return 0;
+
+    int64_t year = tm.tm_year + 1900;
+    switch (bucket)
+    {
+    case GNC_DATE_BUCKET_DAY:
+        return year * 500 + tm.tm_yday;
+    case GNC_DATE_BUCKET_MONTH:
+        return year * 100 + tm.tm_mon;
+    case GNC_DATE_BUCKET_QUARTER:
+        return year * 10 + tm.tm_mon / 3;
+    default:
+        return year;
+    }
+}
+
+static int64_t
+reconcile_rank (char reconciled)
+{
+    static const char order[] = { VREC, FREC, YREC, CREC, NREC };
+    auto rank = std::find (std::begin (order), std::end (order), reconciled);
+    return rank - std::begin (order);
+}
+
+static std::string
+take_string (char *str)
+{
+    std::string retval{str ? str : ""};
+    g_free (str);
+    return retval;
+}
+
+static void
+fill_strings (GncSplitTableColumn& col, const std::vector<Split*>& splits,
+              const char *(*getter)(const Split*))
+{
+    col.type = GncSplitTableColumn::STRING;
+    col.strings.reserve (splits.size ());
+    for (auto split : splits)
+    {
+        auto str = getter (split);
+        col.strings.emplace_back (str ? str : "");
+    }
+}
+
+static void
+fill_column (GncSplitTableColumn& col, const std::vector<Split*>& splits,
+             GncSplitColumn column, GncDateBucket bucket)
+{
+    switch (column)
+    {
+    case GNC_SPLIT_COLUMN_DATE_POSTED:
+    case GNC_SPLIT_COLUMN_DATE_RECONCILED:
+        col.type = GncSplitTableColumn::INT;
+        col.ints.reserve (splits.size ());
+        for (auto split : splits)
+        {
+            auto date = column == GNC_SPLIT_COLUMN_DATE_POSTED ?
+                xaccTransGetDate (xaccSplitGetParent (split)) :
+                xaccSplitGetDateReconciled (split);
+            col.ints.push_back (date_bucket (date, bucket));
+        }
+        break;
+    case GNC_SPLIT_COLUMN_RECONCILE:
+        col.type = GncSplitTableColumn::INT;
+        col.ints.reserve (splits.size ());
+        for (auto split : splits)
+            col.ints.push_back (reconcile_rank (xaccSplitGetReconcile (split)));
+        break;
+    case GNC_SPLIT_COLUMN_ACCOUNT_NAME:
+    {
+        /* Many splits share an account; build each full name once. */
+        std::unordered_map<Account*, std::string> names;
+        col.type = GncSplitTableColumn::STRING;
+        col.strings.reserve (splits.size ());
+        for (auto split : splits)
+        {
+            auto acc = xaccSplitGetAccount (split);
+            auto name = names.find (acc);
+            if (name == names.end ())
+            {
+                auto full_name = gnc_account_get_full_name (acc);
+                name = names.emplace (acc, take_string (full_name)).first;
+            }
+            col.strings.push_back (name->second);
+        }
+        break;
+    }
+    case GNC_SPLIT_COLUMN_ACCOUNT_CODE:
+        fill_strings (col, splits, [](const Split *s) {
+                return xaccAccountGetCode (xaccSplitGetAccount (s)); });
+        break;
+    case GNC_SPLIT_COLUMN_OTHER_ACCOUNT_NAME:
+        col.type = GncSplitTableColumn::STRING;
+        col.strings.reserve (splits.size ());
+        for (auto split : splits)
+        {
+            auto name = xaccSplitGetCorrAccountFullName (split);
+            col.strings.push_back (take_string (name));
+        }
+        break;
+    case GNC_SPLIT_COLUMN_OTHER_ACCOUNT_CODE:
+        fill_strings (col, splits, xaccSplitGetCorrAccountCode);
+        break;
+    case GNC_SPLIT_COLUMN_AMOUNT:
+    case GNC_SPLIT_COLUMN_VALUE:
+        col.type = GncSplitTableColumn::NUMERIC;
+        col.numerics.reserve (splits.size ());
+        for (auto split : splits)
+            col.numerics.push_back (column == GNC_SPLIT_COLUMN_AMOUNT ?
+                                    xaccSplitGetAmount (split) :
+                                    xaccSplitGetValue (split));
+        break;
+    case GNC_SPLIT_COLUMN_DESCRIPTION:
+        fill_strings (col, splits, [](const Split *s) {
+                return xaccTransGetDescription (xaccSplitGetParent (s)); });
+        break;
+    case GNC_SPLIT_COLUMN_NUM:
+        fill_strings (col, splits, [](const Split *s) {
+                return xaccTransGetNum (xaccSplitGetParent (s)); });
+        break;
+    case GNC_SPLIT_COLUMN_ACTION:
+        fill_strings (col, splits, xaccSplitGetAction);
+        break;
+    case GNC_SPLIT_COLUMN_MEMO:
+        fill_strings (col, splits, xaccSplitGetMemo);
+        break;
+    case GNC_SPLIT_COLUMN_NOTES:
+        fill_strings (col, splits, [](const Split *s) {
+                return xaccTransGetNotes (xaccSplitGetParent (s)); });
+        break;
+    default:
+        break;
+    }
+}
+
+static const GncSplitTableColumn*
+table_column (GncSplitTable *table, const GncSplitSortKey& key)
+{
+    auto is_date = key.column == GNC_SPLIT_COLUMN_DATE_POSTED ||
+        key.column == GNC_SPLIT_COLUMN_DATE_RECONCILED;
+    GncSplitColumnId id{key.column, is_date ? key.bucket : GNC_DATE_BUCKET_EXACT};
+    auto col = table->columns.find (id);
+    if (col == table->columns.end ())
+    {
+        col = table->columns.emplace (id, GncSplitTableColumn ()).first;
+        fill_column (col->second, table->splits, id.first, id.second);
+    }
+    return &col->second;
+}
+
+GncSplitTable *
+gnc_split_table_new (GList *splits)
+{
+    auto table = new GncSplitTableImpl;
+    for (auto node = splits; node; node = node->next)
+        table->splits.push_back (static_cast<Split*>(node->data));
+    table->order.resize (table->splits.size ());
+    for (guint row = 0; row < table->order.size (); ++row)
+        table->order[row] = row;
+    return table;
+}
+
+void
+gnc_split_table_destroy (GncSplitTable *table)
+{
+    delete table;
+}
+
+guint
+gnc_split_table_get_num_rows (const GncSplitTable *table)
+{
+    g_return_val_if_fail (table, 0);
+    return table->order.size ();
+}
+
+Split *
+gnc_split_table_get_split (const GncSplitTable *table, guint row)
+{
+    g_return_val_if_fail (table && row < table->order.size (), nullptr);
+    return table->splits[table->order[row]];
+}
+
+GList *
+gnc_split_table_get_splits (const GncSplitTable *table)
+{
+    GList *retval = nullptr;
+    g_return_val_if_fail (table, nullptr);
+    for (auto row = table->order.rbegin (); row != table->order.rend (); ++row)
+        retval = g_list_prepend (retval, table->splits[*row]);
+    return retval;
+}
+
+void
+gnc_split_table_sort (GncSplitTable *table, const GncSplitSortKey *keys,
+                      guint num_keys)
+{
+    g_return_if_fail (table && (keys || num_keys == 0));
+    ENTER ("rows=%zu keys=%u", table->order.size (), num_keys);
+
+    std::vector<std::pair<const GncSplitTableColumn*, bool>> sort_keys;
+    for (guint n = 0; n < num_keys; ++n)
+        sort_keys.emplace_back (table_column (table, keys[n]),
+                                keys[n].ascending);
+
+    std::stable_sort (table->order.begin (), table->order.end (),
+                      [&sort_keys](guint a, guint b)
+                      {
+                          for (auto& key : sort_keys)
+                          {
+                              auto cmp = key.first->compare (a, b);
+                              if (cmp)
+                                  return key.second ? cmp < 0 : cmp > 0;
+                          }
+                          return false;
+                      });
+
+    /* A new group starts at a level whenever that key or a more
+     * significant one changes. */
+    table->groups.assign (num_keys, std::vector<guint> (table->order.size ()));
+    for (guint row = 1; row < table->order.size (); ++row)
+    {
+        auto prev = table->order[row - 1], cur = table->order[row];
+        auto changed = false;
+        for (guint level = 0; level < num_keys; ++level)
+        {
+            changed = changed ||
+                sort_keys[level].first->compare (prev, cur) != 0;
+            table->groups[level][row] =
+                table->groups[level][row - 1] + (changed ? 1 : 0);
+        }
+    }
+    LEAVE ("");
+}
+
+guint
+gnc_split_table_get_group (const GncSplitTable *table, guint row, guint level)
+{
+    g_return_val_if_fail (table && level < table->groups.size (), 0);
+    g_return_val_if_fail (row < table->order.size (), 0);
+    return table->groups[level][row];
+}
+
+gnc_numeric
+gnc_split_table_get_total (GncSplitTable *table, GncSplitColumn column)
+{
+    g_return_val_if_fail (table, gnc_numeric_zero ());
+    g_return_val_if_fail (column == GNC_SPLIT_COLUMN_AMOUNT ||
+                          column == GNC_SPLIT_COLUMN_VALUE, gnc_numeric_zero ());
+    /* The column is contiguous, so it can be summed in one go. */
+    GncSplitSortKey key{column, GNC_DATE_BUCKET_EXACT, TRUE};
+    auto col = table_column (table, key);
+    return gnc_numeric_sum (col->numerics.data (), col->numerics.size ());
+}
@@ -0,0 +1,145 @@
+/********************************************************************\
+ * gnc-split-table.h -- Sort and group a list of splits natively.   *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+
+/** @addtogroup Engine
+    @{ */
+/** @file gnc-split-table.h
+ *  @brief A snapshot of a list of splits with typed columns.
+ *
+ *  A split table takes the splits returned by a query and fetches the
+ *  fields used for sorting and grouping into typed columns, once per
+ *  split and only for the columns actually asked for. Sorting then
+ *  compares column values instead of calling the accessors again for
+ *  every comparison, which is what the transaction report did when it
+ *  sorted in Scheme.
+ *
+ *  Rows can be sorted by several keys at once; after sorting each row
+ *  has a group number per key level so that callers can tell where
+ *  subtotals go without comparing neighbouring rows themselves.
+ *
+ *  The Scheme report system reaches this through gnc_splits_sort() in
+ *  engine-helpers-guile.h.
+ */
+
+#ifndef GNC_SPLIT_TABLE_H
+#define GNC_SPLIT_TABLE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <glib.h>
+#include "gnc-engine.h"
+
+typedef enum
+{
+    GNC_SPLIT_COLUMN_NONE,              /**< Does not order rows. */
+    GNC_SPLIT_COLUMN_DATE_POSTED,
+    GNC_SPLIT_COLUMN_DATE_RECONCILED,
+    /** Unreconciled first, then cleared, reconciled, frozen, voided. */
+    GNC_SPLIT_COLUMN_RECONCILE,
+    GNC_SPLIT_COLUMN_ACCOUNT_NAME,      /**< Full name of the account. */
+    GNC_SPLIT_COLUMN_ACCOUNT_CODE,
+    /** As xaccSplitGetCorrAccountFullName(). */
+    GNC_SPLIT_COLUMN_OTHER_ACCOUNT_NAME,
+    GNC_SPLIT_COLUMN_OTHER_ACCOUNT_CODE,
+    GNC_SPLIT_COLUMN_AMOUNT,
+    GNC_SPLIT_COLUMN_VALUE,
+    GNC_SPLIT_COLUMN_DESCRIPTION,
+    GNC_SPLIT_COLUMN_NUM,               /**< The transaction's number. */
+    GNC_SPLIT_COLUMN_ACTION,
+    GNC_SPLIT_COLUMN_MEMO,
+    GNC_SPLIT_COLUMN_NOTES,
+} GncSplitColumn;
+
+/** How date columns are compared. Dates in the same period compare
+ * equal; periods are in local time and weeks start on the locale's
+ * first day of the week. */
+typedef enum
+{
+    GNC_DATE_BUCKET_EXACT,
+    GNC_DATE_BUCKET_DAY,
+    GNC_DATE_BUCKET_WEEK,
+    GNC_DATE_BUCKET_MONTH,
+    GNC_DATE_BUCKET_QUARTER,
+    GNC_DATE_BUCKET_YEAR,
+} GncDateBucket;
+
+typedef struct
+{
+    GncSplitColumn column;
+    GncDateBucket bucket;   /**< Only used for the date columns. */
+    gboolean ascending;
+} GncSplitSortKey;
+
+typedef struct GncSplitTableImpl GncSplitTable;
+
+/** Make a table with one row per split, in list order. The splits are
+ * not copied, so the table must not outlive them. */
+GncSplitTable *gnc_split_table_new (GList *splits);
+
+void gnc_split_table_destroy (GncSplitTable *table);
+
+guint gnc_split_table_get_num_rows (const GncSplitTable *table);
+
+/** The split in row @a row in the current order. */
+Split *gnc_split_table_get_split (const GncSplitTable *table, guint row);
+
+/** The splits in the current order. Free the list with g_list_free(). */
+GList *gnc_split_table_get_splits (const GncSplitTable *table);
+
+/** Sort the rows by @a keys, the first key being the most significant.
+ * The sort is stable: rows equal in every key keep their order. The
+ * keys are remembered for gnc_split_table_get_group().
+ *
+ * @param table The table.
+ * @param keys The sort keys.
+ * @param num_keys The number of entries in @a keys.
+ */
+void gnc_split_table_sort (GncSplitTable *table, const GncSplitSortKey *keys,
+                           guint num_keys);
+
+/** The group of row @a row at key level @a level of the last sort.
+ *
+ * Rows belong to the same group at a level when they compare equal in
+ * that key and in all more significant ones. Groups are numbered from
+ * 0 in row order, so a subtotal for @a level is due after every row
+ * whose successor has a different group number.
+ */
+guint gnc_split_table_get_group (const GncSplitTable *table, guint row,
+                                 guint level);
+
+/** The sum of @a column over all rows, which doesn't depend on the
+ * order. Only GNC_SPLIT_COLUMN_AMOUNT and GNC_SPLIT_COLUMN_VALUE can be
+ * totalled; the caller has to make sure that the splits are in the
+ * same commodity or currency.
+ */
+gnc_numeric gnc_split_table_get_total (GncSplitTable *table,
+                                       GncSplitColumn column);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNC_SPLIT_TABLE_H */
+/** @} */
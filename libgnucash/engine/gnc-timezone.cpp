@@ -47,6 +47,8 @@ using PTZ = boost::local_time::posix_time_zone;
 
 const unsigned int TimeZoneProvider::min_year = 1400;
 const unsigned int TimeZoneProvider::max_year = 9999;
+const int TimeZoneProvider::offset_table_first_year = 1900;
+const int TimeZoneProvider::offset_table_last_year = 2199;
 
 template<typename T>
 T*
@@ -739,12 +741,144 @@ TimeZoneProvider::get(int year) const noexcept
     if (m_zone_vector.empty())
         return TZ_Ptr(new PTZ("UTC0"));
     auto iter = find_if(m_zone_vector.rbegin(), m_zone_vector.rend(),
-			[=](TZ_Entry e) { return e.first <= year; });
+			[=](const TZ_Entry& e) { return e.first <= year; });
     if (iter == m_zone_vector.rend())
             return m_zone_vector.front().second;
     return iter->second;
 }
 
+static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+
+static int64_t
+epoch_seconds(const boost::posix_time::ptime& time)
+{
+    return (time - epoch).total_seconds();
+}
+
+/* The offset at @a time the way GncDateTime works it out: with the zone
+ * for the UTC year, whose DST rules are applied to the local standard
+ * time. Only the offset and is_dst are filled in. */
+TZ_Span
+TimeZoneProvider::span_at(int64_t time) const
+{
+    using boost::posix_time::hours;
+    using boost::posix_time::seconds;
+    try
+    {
+//Can't use boost::posix_date::from_time_t() constructor because it
+//silently casts the time_t to an int32_t.
+        boost::posix_time::ptime utc(epoch.date(), hours(time / 3600) +
+                                     seconds(time % 3600));
+        boost::local_time::local_date_time ldt(utc, get(utc.date().year()));
+        return {time, time, (ldt.local_time() - utc).total_seconds(),
+                ldt.is_dst()};
+    }
+    catch(boost::gregorian::bad_year&)
+    {
+        throw(std::invalid_argument("Time value is outside the supported year range."));
+    }
+}
+
+/* Within a UTC year the zone is fixed, so the offset can only change
+ * where local standard time crosses the start or the end of DST or a
+ * new year, which moves DST to another year's dates. Those instants
+ * are collected for the years around each UTC year and the offset
+ * found at each of them; wherever it changes a new span starts.
+ */
+void
+TimeZoneProvider::build_offset_table() const
+{
+    using boost::gregorian::date;
+    using boost::posix_time::ptime;
+    std::vector<TZ_Span> offsets;
+    try
+    {
+        for (auto year = offset_table_first_year;
+             year <= offset_table_last_year; ++year)
+        {
+            auto start = epoch_seconds(ptime(date(year, 1, 1)));
+            auto end = epoch_seconds(ptime(date(year + 1, 1, 1)));
+            auto zone = get(year);
+            auto base = zone->base_utc_offset().total_seconds();
+            std::vector<int64_t> changes{start};
+            for (auto rule_year = year - 1; rule_year <= year + 1; ++rule_year)
+            {
+                changes.push_back(epoch_seconds(ptime(date(rule_year, 1, 1))) - base);
+                if (!zone->has_dst())
+                    continue;
+                auto dst = zone->dst_offset().total_seconds();
+                auto dst_start = zone->dst_local_start_time(rule_year);
+                auto dst_end = zone->dst_local_end_time(rule_year);
+                changes.push_back(epoch_seconds(dst_start) - base);
+                changes.push_back(epoch_seconds(dst_end) - base - dst);
+                /* Boost only looks at the time of day on the days DST
+                 * starts and ends, so rules whose times fall outside
+                 * those days switch at midnight instead, and it
+                 * compares the times and the DST length in whole
+                 * minutes. */
+                auto minutes = [](const duration& d)
+                    { return d.hours() * 60 + d.minutes(); };
+                auto length = minutes(zone->dst_offset());
+                auto start_day = epoch_seconds(ptime(dst_start.date())) - base;
+                auto end_day = epoch_seconds(ptime(dst_end.date())) - base;
+                auto start_minutes = minutes(dst_start.time_of_day());
+                auto end_minutes = minutes(dst_end.time_of_day());
+                for (auto change : {start_day, start_day + 86400,
+                                    end_day, end_day + 86400,
+                                    start_day + (start_minutes + length) * 60,
+                                    end_day + (end_minutes - length) * 60})
+                    changes.push_back(change);
+            }
+            std::sort(changes.begin(), changes.end());
+            changes.erase(std::unique(changes.begin(), changes.end()),
+                          changes.end());
+            for (auto change : changes)
+            {
+                if (change < start || change >= end)
+                    continue;
+                auto span = span_at(change);
+                if (!offsets.empty() && offsets.back().offset == span.offset &&
+                    offsets.back().is_dst == span.is_dst)
+                    continue;
+                if (!offsets.empty())
+                    offsets.back().end = change;
+                offsets.push_back(span);
+            }
+        }
+        offsets.back().end =
+            epoch_seconds(ptime(date(offset_table_last_year + 1, 1, 1)));
+    }
+    catch(std::exception& err)
+    {
+        PWARN("Offset table not built, using the zone rules: %s", err.what());
+        return;
+    }
+    m_offsets = std::move(offsets);
+}
+
+bool
+TimeZoneProvider::get_span(int64_t time, TZ_Span& span) const noexcept
+{
+    std::call_once(m_offsets_built, [this]() { build_offset_table(); });
+    if (m_offsets.empty() || time < m_offsets.front().start ||
+        time >= m_offsets.back().end)
+        return false;
+    auto iter = std::upper_bound(m_offsets.begin(), m_offsets.end(), time,
+                                 [](int64_t t, const TZ_Span& s)
+                                 { return t < s.start; });
+    span = *(iter - 1);
+    return true;
+}
+
+long
+TimeZoneProvider::get_utc_offset(int64_t time) const
+{
+    TZ_Span span;
+    if (get_span(time, span))
+        return span.offset;
+    return span_at(time).offset;
+}
+
 void
 TimeZoneProvider::dump() const noexcept
 {
@@ -32,6 +32,8 @@ extern "C"
 
 #define BOOST_ERROR_CODE_HEADER_ONLY
 #include <boost/date_time/local_time/local_time.hpp>
+#include <mutex>
+#include <vector>
 
 namespace gnc
 {
@@ -44,6 +46,16 @@ using TZ_Entry = std::pair<int, TZ_Ptr>;
 using TZ_Vector = std::vector<TZ_Entry>;
 using time_zone_names = boost::local_time::time_zone_names;
 
+/* A stretch of time over which a zone's offset from UTC doesn't change,
+ * in seconds since the epoch. */
+struct TZ_Span
+{
+    int64_t start;      // first second of the span
+    int64_t end;        // first second after it
+    long offset;        // seconds east of UTC
+    bool is_dst;
+};
+
 class TimeZoneProvider
 {
 public:
@@ -55,13 +67,30 @@ public:
     TimeZoneProvider operator=(const TimeZoneProvider&) = delete;
     TimeZoneProvider operator=(const TimeZoneProvider&&) = delete;
     TZ_Ptr get (int year) const noexcept;
+    /* The offset from UTC in seconds of local time at @a time, seconds
+     * since the epoch. Times in the years of the offset table are found
+     * by a binary search, others go through the zone for their year.
+     * Throws std::invalid_argument outside min_year to max_year. */
+    long get_utc_offset (int64_t time) const;
+    /* The span of the offset table containing @a time. Returns false if
+     * @a time is outside the years the table covers. */
+    bool get_span (int64_t time, TZ_Span& span) const noexcept;
     void dump() const noexcept;
     static const unsigned int min_year; //1400
     static const unsigned int max_year; //9999
+    static const int offset_table_first_year; //1900
+    static const int offset_table_last_year; //2199
 private:
     void parse_file(const std::string& tzname);
     bool construct(const std::string& tzname);
+    TZ_Span span_at(int64_t time) const;
+    void build_offset_table() const;
     TZ_Vector m_zone_vector;
+    /* The offset and DST flag from each transition until the next one,
+     * built from m_zone_vector on first use. The last span ends at the
+     * start of the year after offset_table_last_year. */
+    mutable std::vector<TZ_Span> m_offsets;
+    mutable std::once_flag m_offsets_built;
 #if PLATFORM(WINDOWS)
     void load_windows_dynamic_tz(HKEY, time_zone_names);
     void load_windows_classic_tz(HKEY, time_zone_names);
@@ -89,6 +89,97 @@ GList * gncBusinessGetOwnerList (QofBook *book, const char *type_name,
     return data.result;
 }
 
+/* The ID index: per book, a table by type name of tables from ID to a
+ * GList of the objects with that ID. */
+#define GNC_BUSINESS_ID_INDEX "gnc-business-id-index"
+
+static void
+id_table_free (gpointer data)
+{
+    GHashTable *table = data;
+    GHashTableIter iter;
+    gpointer list;
+
+    g_hash_table_iter_init (&iter, table);
+    while (g_hash_table_iter_next (&iter, NULL, &list))
+        g_list_free (list);
+    g_hash_table_destroy (table);
+}
+
+static void
+id_index_free (QofBook *book, gpointer key, gpointer user_data)
+{
+    g_hash_table_destroy (user_data);
+}
+
+static GHashTable *
+id_index_get_table (QofBook *book, QofIdTypeConst type_name, gboolean create)
+{
+    GHashTable *index = qof_book_get_data (book, GNC_BUSINESS_ID_INDEX);
+    GHashTable *table;
+
+    if (!index)
+    {
+        if (!create)
+            return NULL;
+        index = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                       g_free, id_table_free);
+        qof_book_set_data_fin (book, GNC_BUSINESS_ID_INDEX, index,
+                               id_index_free);
+    }
+
+    table = g_hash_table_lookup (index, type_name);
+    if (!table && create)
+    {
+        table = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+        g_hash_table_insert (index, g_strdup (type_name), table);
+    }
+    return table;
+}
+
+void gncBusinessUpdateIDIndex (QofInstance *inst, const char *old_id,
+                               const char *new_id)
+{
+    QofBook *book;
+    GHashTable *table;
+    GList *list;
+
+    g_return_if_fail (QOF_IS_INSTANCE (inst));
+    if (!g_strcmp0 (old_id, new_id))
+        return;
+    book = qof_instance_get_book (inst);
+    if (!book || qof_book_shutting_down (book))
+        return;
+    table = id_index_get_table (book, inst->e_type, TRUE);
+
+    if (old_id && *old_id)
+    {
+        list = g_list_remove (g_hash_table_lookup (table, old_id), inst);
+        if (list)
+            g_hash_table_insert (table, g_strdup (old_id), list);
+        else
+            g_hash_table_remove (table, old_id);
+    }
+    if (new_id && *new_id)
+    {
+        list = g_list_append (g_hash_table_lookup (table, new_id), inst);
+        g_hash_table_insert (table, g_strdup (new_id), list);
+    }
+}
+
+GList * gncBusinessGetByID (QofBook *book, QofIdTypeConst type_name,
+                            const char *id)
+{
+    GHashTable *table;
+
+    g_return_val_if_fail (book && type_name && id, NULL);
+
+    table = id_index_get_table (book, type_name, FALSE);
+    if (!table)
+        return NULL;
+    return g_list_copy (g_hash_table_lookup (table, id));
+}
+
 gboolean gncBusinessIsPaymentAcctType (GNCAccountType type)
 {
     if (xaccAccountIsAssetLiabType(type) ||
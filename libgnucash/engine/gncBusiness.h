@@ -87,6 +87,23 @@ typedef GList OwnerList;
 OwnerList * gncBusinessGetOwnerList (QofBook *book, QofIdTypeConst type_name,
                                      gboolean all_including_inactive);
 
+/** Returns a GList of the objects of the given type_name in the given
+ * book whose ID is @a id, oldest first. IDs are normally unique per
+ * type, but nothing enforces that; invoices and bills share one type.
+ *
+ * The lookup goes through an index kept per book, so it costs the same
+ * no matter how many objects the book holds. Objects with an empty ID
+ * are not indexed. Free the list with g_list_free().
+ */
+GList * gncBusinessGetByID (QofBook *book, QofIdTypeConst type_name,
+                            const char *id);
+
+/** Tells the ID index that the ID of a customer, employee, invoice, job
+ * or vendor changes from @a old_id to @a new_id. Either may be NULL, for
+ * a new or a destroyed object. Only the objects' own code calls this. */
+void gncBusinessUpdateIDIndex (QofInstance *inst, const char *old_id,
+                               const char *new_id);
+
 /** Returns whether the given account type is a valid type to use in
  * business payments. Currently payments are allowed to/from assets,
  * liabilities and equity accounts. */
@@ -346,6 +346,7 @@ static void gncCustomerFree (GncCustomer *cust)
 
     qof_event_gen (&cust->inst, QOF_EVENT_DESTROY, NULL);
 
+    gncBusinessUpdateIDIndex (&cust->inst, cust->id, NULL);
     CACHE_REMOVE (cust->id);
     CACHE_REMOVE (cust->name);
     CACHE_REMOVE (cust->notes);
@@ -384,6 +385,7 @@ void gncCustomerSetID (GncCustomer *cust, const char *id)
 {
     if (!cust) return;
     if (!id) return;
+    gncBusinessUpdateIDIndex (&cust->inst, cust->id, id);
     SET_STR(cust, cust->id, id);
     mark_customer (cust);
     gncCustomerCommitEdit (cust);
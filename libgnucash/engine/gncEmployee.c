@@ -465,6 +465,7 @@ static void gncEmployeeFree (GncEmployee *employee)
 
     qof_event_gen (&employee->inst, QOF_EVENT_DESTROY, NULL);
 
+    gncBusinessUpdateIDIndex (&employee->inst, employee->id, NULL);
     CACHE_REMOVE (employee->id);
     CACHE_REMOVE (employee->username);
     CACHE_REMOVE (employee->language);
@@ -494,6 +495,7 @@ void gncEmployeeSetID (GncEmployee *employee, const char *id)
 {
     if (!employee) return;
     if (!id) return;
+    gncBusinessUpdateIDIndex (&employee->inst, employee->id, id);
     SET_STR(employee, employee->id, id);
     mark_employee (employee);
     gncEmployeeCommitEdit (employee);
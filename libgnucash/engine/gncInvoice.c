@@ -353,6 +353,7 @@ GncInvoice *gncInvoiceCopy (const GncInvoice *from)
     gncInvoiceBeginEdit(invoice);
 
     invoice->id = CACHE_INSERT (from->id);
+    gncBusinessUpdateIDIndex (&invoice->inst, NULL, invoice->id);
     invoice->notes = CACHE_INSERT (from->notes);
     invoice->billing_id = CACHE_INSERT (from->billing_id);
     invoice->active = from->active;
@@ -419,6 +420,7 @@ static void gncInvoiceFree (GncInvoice *invoice)
 
     qof_event_gen (&invoice->inst, QOF_EVENT_DESTROY, NULL);
 
+    gncBusinessUpdateIDIndex (&invoice->inst, invoice->id, NULL);
     CACHE_REMOVE (invoice->id);
     CACHE_REMOVE (invoice->notes);
     CACHE_REMOVE (invoice->billing_id);
@@ -440,6 +442,7 @@ static void gncInvoiceFree (GncInvoice *invoice)
 void gncInvoiceSetID (GncInvoice *invoice, const char *id)
 {
     if (!invoice || !id) return;
+    gncBusinessUpdateIDIndex (&invoice->inst, invoice->id, id);
     SET_STR (invoice, invoice->id, id);
     mark_invoice (invoice);
     gncInvoiceCommitEdit (invoice);
@@ -244,6 +244,7 @@ static void gncJobFree (GncJob *job)
 
     qof_event_gen (&job->inst, QOF_EVENT_DESTROY, NULL);
 
+    gncBusinessUpdateIDIndex (&job->inst, job->id, NULL);
     CACHE_REMOVE (job->id);
     CACHE_REMOVE (job->name);
     CACHE_REMOVE (job->desc);
@@ -282,6 +283,7 @@ void gncJobSetID (GncJob *job, const char *id)
 {
     if (!job) return;
     if (!id) return;
+    gncBusinessUpdateIDIndex (&job->inst, job->id, id);
     SET_STR(job, job->id, id);
     mark_job (job);
     gncJobCommitEdit (job);
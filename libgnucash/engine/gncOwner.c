@@ -632,6 +632,9 @@ void gncOwnerAttachToLot (const GncOwner *owner, GNCLot *lot)
 		      GNC_OWNER_GUID, gncOwnerGetGUID (owner),
 		      NULL);
     gnc_lot_commit_edit (lot);
+    /* Committing a lot doesn't announce it, but the owner's open lot
+     * index and others need to know who the lot belongs to now. */
+    qof_event_gen (QOF_INSTANCE (lot), QOF_EVENT_MODIFY, NULL);
 }
 
 gboolean gncOwnerGetOwnerFromLot (GNCLot *lot, GncOwner *owner)
@@ -1426,8 +1429,7 @@ gncOwnerApplyPaymentSecs (const GncOwner *owner, Transaction **preset_txn,
     if (lots)
         selected_lots = lots;
     else if (auto_pay)
-        selected_lots = xaccAccountFindOpenLots (posted_acc, gncOwnerLotMatchOwnerFunc,
-                        (gpointer)owner, NULL);
+        selected_lots = gncOwnerGetOpenLots (owner, posted_acc);
 
     /* And link the selected lots and the payment lot together as well as possible.
      * If the payment was bigger than the selected documents/overpayments, only
@@ -1466,6 +1468,262 @@ gncOwnerGetCommoditiesList (const GncOwner *owner)
     return (g_list_prepend (NULL, gncOwnerGetCurrency(owner)));
 }
 
+/*********************************************************************/
+/* Open lot index                                                    */
+
+/* Per book, the open lots in A/R and A/P accounts keyed by the GUID of
+ * the end owner they belong to. The index is built by a single pass
+ * over the book's lots the first time it is needed and is kept current
+ * from lot and invoice events afterwards, so finding an owner's open
+ * lots no longer requires matching every lot in every business account.
+ * A job's lots belong to the job's owner, and nothing tells which lots
+ * those are, so any change to a job has the index rebuilt.
+ */
+#define GNC_OWNER_LOT_INDEX "gnc-owner-lot-index"
+
+typedef struct
+{
+    GncGUID owner_guid;
+    /* Order in which the lot entered the index, to hand out lots in
+     * the same order xaccAccountFindOpenLots does. */
+    guint64 seq;
+} OwnerLotEntry;
+
+typedef struct
+{
+    /* end owner GncGUID* -> set of GNCLot* */
+    GHashTable *owner_lots;
+    /* GNCLot* -> OwnerLotEntry* */
+    GHashTable *lots;
+    guint64 next_seq;
+    gboolean stale;
+} OwnerLotIndex;
+
+static gint owner_lot_index_handler_id = 0;
+
+static gboolean
+owner_lot_get_end_guid (GNCLot *lot, GncGUID *guid)
+{
+    GncOwner lot_owner;
+    const GncOwner *end_owner;
+    GncInvoice *invoice = gncInvoiceGetInvoiceFromLot (lot);
+
+    /* Same rules as gncOwnerLotMatchOwnerFunc */
+    if (invoice)
+        end_owner = gncOwnerGetEndOwner (gncInvoiceGetOwner (invoice));
+    else if (gncOwnerGetOwnerFromLot (lot, &lot_owner))
+        end_owner = gncOwnerGetEndOwner (&lot_owner);
+    else
+        return FALSE;
+
+    if (!gncOwnerGetGUID (end_owner))
+        return FALSE;
+    *guid = *gncOwnerGetGUID (end_owner);
+    return TRUE;
+}
+
+static void
+owner_lot_index_remove (OwnerLotIndex *index, GNCLot *lot)
+{
+    OwnerLotEntry *entry = g_hash_table_lookup (index->lots, lot);
+    GHashTable *owner_lots;
+
+    if (!entry) return;
+
+    owner_lots = g_hash_table_lookup (index->owner_lots, &entry->owner_guid);
+    if (owner_lots)
+    {
+        g_hash_table_remove (owner_lots, lot);
+        if (g_hash_table_size (owner_lots) == 0)
+            g_hash_table_remove (index->owner_lots, &entry->owner_guid);
+    }
+    g_hash_table_remove (index->lots, lot);
+}
+
+static void
+owner_lot_index_update (OwnerLotIndex *index, GNCLot *lot)
+{
+    Account *account = gnc_lot_get_account (lot);
+    OwnerLotEntry *entry;
+    GHashTable *owner_lots;
+    GncGUID guid;
+    guint64 seq;
+
+    if (!account || !xaccAccountIsAPARType (xaccAccountGetType (account)) ||
+            qof_instance_get_destroying (lot) || gnc_lot_is_closed (lot) ||
+            !owner_lot_get_end_guid (lot, &guid))
+    {
+        owner_lot_index_remove (index, lot);
+        return;
+    }
+
+    entry = g_hash_table_lookup (index->lots, lot);
+    if (entry && guid_equal (&entry->owner_guid, &guid))
+        return;
+
+    seq = entry ? entry->seq : index->next_seq++;
+    owner_lot_index_remove (index, lot);
+
+    entry = g_new (OwnerLotEntry, 1);
+    entry->owner_guid = guid;
+    entry->seq = seq;
+    g_hash_table_insert (index->lots, lot, entry);
+
+    owner_lots = g_hash_table_lookup (index->owner_lots, &guid);
+    if (!owner_lots)
+    {
+        owner_lots = g_hash_table_new (g_direct_hash, g_direct_equal);
+        g_hash_table_insert (index->owner_lots, guid_copy (&guid), owner_lots);
+    }
+    g_hash_table_insert (owner_lots, lot, lot);
+}
+
+static void
+owner_lot_index_handle_event (QofInstance *entity, QofEventId event_type,
+                              gpointer user_data, gpointer event_data)
+{
+    OwnerLotIndex *index;
+    QofBook *book;
+    GNCLot *lot;
+
+    if (GNC_IS_LOT (entity))
+        lot = GNC_LOT (entity);
+    else if (GNC_IS_INVOICE (entity) && (event_type & QOF_EVENT_MODIFY))
+        lot = gncInvoiceGetPostedLot (GNC_INVOICE (entity));
+    else if (GNC_IS_JOB (entity) && (event_type & QOF_EVENT_MODIFY))
+        lot = NULL;
+    else
+        return;
+
+    book = qof_instance_get_book (entity);
+    if (!book || qof_book_shutting_down (book))
+        return;
+    index = qof_book_get_data (book, GNC_OWNER_LOT_INDEX);
+    if (!index)
+        return;
+
+    if (GNC_IS_JOB (entity))
+    {
+        index->stale = TRUE;
+        return;
+    }
+    if (!lot || index->stale)
+        return;
+
+    if (GNC_IS_LOT (entity) && (event_type & QOF_EVENT_DESTROY))
+        owner_lot_index_remove (index, lot);
+    else
+        owner_lot_index_update (index, lot);
+}
+
+static void
+owner_lot_index_free (QofBook *book, gpointer key, gpointer user_data)
+{
+    OwnerLotIndex *index = user_data;
+
+    g_hash_table_destroy (index->owner_lots);
+    g_hash_table_destroy (index->lots);
+    g_free (index);
+}
+
+static void
+owner_lot_index_fill (OwnerLotIndex *index, QofBook *book)
+{
+    GList *acct_list, *acct_node;
+
+    acct_list = gnc_account_get_descendants (gnc_book_get_root_account (book));
+    for (acct_node = acct_list; acct_node; acct_node = acct_node->next)
+    {
+        Account *account = acct_node->data;
+        GList *lot_list, *lot_node;
+
+        if (!xaccAccountIsAPARType (xaccAccountGetType (account)))
+            continue;
+
+        /* The account keeps its newest lot first */
+        lot_list = g_list_reverse (xaccAccountGetLotList (account));
+        for (lot_node = lot_list; lot_node; lot_node = lot_node->next)
+            owner_lot_index_update (index, lot_node->data);
+        g_list_free (lot_list);
+    }
+    g_list_free (acct_list);
+}
+
+static OwnerLotIndex *
+owner_lot_index_get (QofBook *book)
+{
+    OwnerLotIndex *index = qof_book_get_data (book, GNC_OWNER_LOT_INDEX);
+
+    if (index && index->stale)
+    {
+        g_hash_table_remove_all (index->owner_lots);
+        g_hash_table_remove_all (index->lots);
+        index->next_seq = 0;
+        index->stale = FALSE;
+        owner_lot_index_fill (index, book);
+    }
+    if (index)
+        return index;
+
+    index = g_new0 (OwnerLotIndex, 1);
+    index->owner_lots = g_hash_table_new_full (guid_hash_to_guint,
+                                               guid_g_hash_table_equal,
+                                               (GDestroyNotify)guid_free,
+                                               (GDestroyNotify)g_hash_table_destroy);
+    index->lots = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                         NULL, g_free);
+    qof_book_set_data_fin (book, GNC_OWNER_LOT_INDEX, index,
+                           owner_lot_index_free);
+    if (owner_lot_index_handler_id == 0)
+        owner_lot_index_handler_id =
+            qof_event_register_handler (owner_lot_index_handle_event, NULL);
+
+    owner_lot_index_fill (index, book);
+    return index;
+}
+
+static gint
+owner_lot_index_seq_cmp (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+    OwnerLotIndex *index = user_data;
+    const OwnerLotEntry *ea = g_hash_table_lookup (index->lots, a);
+    const OwnerLotEntry *eb = g_hash_table_lookup (index->lots, b);
+
+    return ea->seq < eb->seq ? -1 : ea->seq > eb->seq ? 1 : 0;
+}
+
+GList *
+gncOwnerGetOpenLots (const GncOwner *owner, const Account *account)
+{
+    OwnerLotIndex *index;
+    GHashTable *owner_lots;
+    GHashTableIter iter;
+    gpointer lot;
+    GList *retval = NULL;
+    QofBook *book;
+
+    g_return_val_if_fail (owner, NULL);
+    if (!gncOwnerGetGUID (owner))
+        return NULL;
+
+    book = qof_instance_get_book (qofOwnerGetOwner (owner));
+    if (!book)
+        return NULL;
+    index = owner_lot_index_get (book);
+    owner_lots = g_hash_table_lookup (index->owner_lots, gncOwnerGetGUID (owner));
+    if (!owner_lots)
+        return NULL;
+
+    g_hash_table_iter_init (&iter, owner_lots);
+    while (g_hash_table_iter_next (&iter, &lot, NULL))
+    {
+        if (account && gnc_lot_get_account (lot) != account)
+            continue;
+        retval = g_list_prepend (retval, lot);
+    }
+    return g_list_sort_with_data (retval, owner_lot_index_seq_cmp, index);
+}
+
 /*********************************************************************/
 /* Owner balance calculation routines                                */
 
@@ -1494,41 +1752,30 @@ gncOwnerGetBalanceInCurrency (const GncOwner *owner,
     else
     {
         /* No valid cache value found for balance. Let's recalculate */
-        GList *acct_list  = gnc_account_get_descendants (gnc_book_get_root_account (book));
+        GList *lot_list   = gncOwnerGetOpenLots (owner, NULL);
         GList *acct_types = gncOwnerGetAccountTypesList (owner);
-        GList *acct_node;
+        GList *lot_node;
 
-        /* For each account */
-        for (acct_node = acct_list; acct_node; acct_node = acct_node->next)
+        /* For each open lot of this owner */
+        for (lot_node = lot_list; lot_node; lot_node = lot_node->next)
         {
-            Account *account = acct_node->data;
-            GList *lot_list = NULL, *lot_node;
+            GNCLot *lot = lot_node->data;
+            Account *account = gnc_lot_get_account (lot);
 
             /* Check if this account can have lots for the owner, otherwise skip to next */
             if (g_list_index (acct_types, (gpointer)xaccAccountGetType (account))
                     == -1)
                 continue;
 
-
             if (!gnc_commodity_equal (owner_currency, xaccAccountGetCommodity (account)))
                 continue;
 
-            /* Get a list of open lots for this owner and account */
-            lot_list = xaccAccountFindOpenLots (account, gncOwnerLotMatchOwnerFunc,
-                                                (gpointer)owner, NULL);
-            /* For each lot */
-            for (lot_node = lot_list; lot_node; lot_node = lot_node->next)
-            {
-                GNCLot *lot = lot_node->data;
-                gnc_numeric lot_balance = gnc_lot_get_balance (lot);
-                GncInvoice *invoice = gncInvoiceGetInvoiceFromLot(lot);
-                if (invoice)
-                balance = gnc_numeric_add (balance, lot_balance,
-                                            gnc_commodity_get_fraction (owner_currency), GNC_HOW_RND_ROUND_HALF_UP);
-            }
-            g_list_free (lot_list);
+            if (gncInvoiceGetInvoiceFromLot (lot))
+                balance = gnc_numeric_add (balance, gnc_lot_get_balance (lot),
+                                           gnc_commodity_get_fraction (owner_currency),
+                                           GNC_HOW_RND_ROUND_HALF_UP);
         }
-        g_list_free (acct_list);
+        g_list_free (lot_list);
         g_list_free (acct_types);
 
         gncOwnerSetCachedBalance (owner, &balance);
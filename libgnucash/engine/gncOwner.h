@@ -186,6 +186,17 @@ void gncOwnerAttachToLot (const GncOwner *owner, GNCLot *lot);
  */
 gboolean gncOwnerLotMatchOwnerFunc (GNCLot *lot, gpointer user_data);
 
+/** Returns the open lots in @a account that gncOwnerLotMatchOwnerFunc
+ *  would match for @a owner, in the order xaccAccountFindOpenLots
+ *  returns them. If @a account is NULL the open lots of all A/R and A/P
+ *  accounts are returned.
+ *
+ *  The lots come from an index kept per book, so the cost depends on
+ *  the number of open lots of the owner rather than on the number of
+ *  lots in the book. The caller must free the list with g_list_free.
+ */
+GList * gncOwnerGetOpenLots (const GncOwner *owner, const Account *account);
+
 /** Helper function used to sort lots by date. If the lot is
  * linked to an invoice, use the invoice posted date, otherwise
  * use the lot's opened date.
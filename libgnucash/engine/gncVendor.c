@@ -491,6 +491,7 @@ static void gncVendorFree (GncVendor *vendor)
 
     qof_event_gen (&vendor->inst, QOF_EVENT_DESTROY, NULL);
 
+    gncBusinessUpdateIDIndex (&vendor->inst, vendor->id, NULL);
     CACHE_REMOVE (vendor->id);
     CACHE_REMOVE (vendor->name);
     CACHE_REMOVE (vendor->notes);
@@ -525,6 +526,7 @@ void gncVendorSetID (GncVendor *vendor, const char *id)
 {
     if (!vendor) return;
     if (!id) return;
+    gncBusinessUpdateIDIndex (&vendor->inst, vendor->id, id);
     SET_STR(vendor, vendor->id, id);
     mark_vendor (vendor);
     gncVendorCommitEdit (vendor);
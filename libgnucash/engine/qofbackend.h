@@ -104,6 +104,9 @@ typedef enum
                                     for internal use by GnuCash */
     ERR_FILEIO_FILE_UPGRADE,   /**< file will be upgraded and not be able to be
                                     read by prior versions - warn users*/
+    ERR_FILEIO_JOURNAL_CORRUPT, /**< the changes saved after the file was last
+                                     written in full couldn't all be read
+                                     back - warn users */
 
     /* network errors */
     ERR_NETIO_SHORT_READ = 2000,  /**< not enough bytes received */
@@ -36,6 +36,7 @@ static guint   suspend_counter   = 0;
 static gint    next_handler_id   = 1;
 static guint   handler_run_level = 0;
 static guint   pending_deletes   = 0;
+static guint   suppressed_count  = 0;
 static GList   *handlers  =   NULL;
 
 /* This static indicates the debugging module that this .o belongs to.  */
@@ -167,6 +168,12 @@ qof_event_resume (void)
     suspend_counter--;
 }
 
+guint
+qof_event_get_suppressed_count (void)
+{
+    return suppressed_count;
+}
+
 static void
 qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
                              gpointer event_data)
@@ -237,7 +244,10 @@ qof_event_gen (QofInstance *entity, QofEventId event_id, gpointer event_data)
         return;
 
     if (suspend_counter)
+    {
+        suppressed_count++;
         return;
+    }
 
     qof_event_generate_internal (entity, event_id, event_data);
 }
@@ -139,6 +139,12 @@ void qof_event_suspend (void);
 /** Resume engine event generation. */
 void qof_event_resume (void);
 
+/** The number of events qof_event_gen() has dropped so far because
+ *  events were suspended. Handlers that keep their own record of what
+ *  changed can compare it between calls to notice changes they never
+ *  heard about. */
+guint qof_event_get_suppressed_count (void);
+
 #ifdef __cplusplus
 }
 #endif
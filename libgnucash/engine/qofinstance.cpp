@@ -531,6 +531,23 @@ qof_instance_set_collection (gconstpointer ptr, QofCollection *col)
     GET_PRIVATE(ptr)->collection = col;
 }
 
+static QofInstanceReadFunc read_func = NULL;
+static gpointer read_func_data = NULL;
+
+void
+qof_instance_set_read_func (QofInstanceReadFunc func, gpointer user_data)
+{
+    read_func = func;
+    read_func_data = user_data;
+}
+
+void
+qof_instance_record_read (gconstpointer inst)
+{
+    if (read_func && inst)
+        read_func (QOF_INSTANCE(inst), read_func_data);
+}
+
 QofBook *
 qof_instance_get_book (gconstpointer inst)
 {
@@ -1017,7 +1034,10 @@ qof_commit_edit_part2(QofInstance *inst,
         }
         while (errcode != ERR_BACKEND_NO_ERR);
 
-        be->commit(inst);
+        {
+            QOF_TRACE_SPAN ("QofBackend::commit");
+            be->commit(inst);
+        }
         errcode = be->get_error();
         if (errcode != ERR_BACKEND_NO_ERR)
         {
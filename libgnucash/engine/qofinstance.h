@@ -206,6 +206,19 @@ GList* qof_instance_get_typed_referring_object_list(const QofInstance* inst, con
  */
 GList* qof_instance_get_referring_object_list_from_collection(const QofCollection* coll, const QofInstance* ref);
 
+/** Called with each instance read while it is set. */
+typedef void (*QofInstanceReadFunc) (QofInstance *inst, gpointer user_data);
+
+/** Set the function qof_instance_record_read() passes instances to, or
+ *  NULL to stop recording. This tells a caller what a computation
+ *  depended on. Only bulk reads are recorded: the splits and balances
+ *  of an account, the instances a query is restricted to (the book, if
+ *  it isn't restricted), and the commodities prices are looked up for. */
+void qof_instance_set_read_func (QofInstanceReadFunc func, gpointer user_data);
+
+/** Pass @a inst to the read function, if one is set. */
+void qof_instance_record_read (gconstpointer inst);
+
 /* @} */
 /* @} */
 #endif /* QOF_INSTANCE_H */
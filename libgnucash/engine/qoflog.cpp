@@ -55,6 +55,13 @@ extern "C"
 #include "qof.h"
 #include "qoflog.h"
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #define QOF_LOG_MAX_CHARS 50
 #define QOF_LOG_MAX_CHARS_WITH_ALLOWANCE 100
 #define QOF_LOG_INDENT_WIDTH 4
@@ -67,6 +74,8 @@ static GHashTable *log_table = NULL;
 static GLogFunc previous_handler = NULL;
 static gchar* qof_logger_format = NULL;
 
+static void qof_trace_shutdown (void);
+
 void
 qof_log_indent(void)
 {
@@ -198,6 +207,13 @@ qof_log_init_filename(const gchar* log_filename)
     if (previous_handler == NULL)
         previous_handler = g_log_set_default_handler(log4glib_handler, log_table);
 
+    if (!qof_trace_is_enabled())
+    {
+        const char *trace_file = g_getenv("GNC_TRACE");
+        if (trace_file && *trace_file)
+            qof_trace_set_file(trace_file);
+    }
+
     if (warn_about_missing_permission)
     {
         g_critical("Cannot open log output file \"%s\", using stderr.", log_filename);
@@ -207,6 +223,8 @@ qof_log_init_filename(const gchar* log_filename)
 void
 qof_log_shutdown (void)
 {
+    qof_trace_shutdown();
+
     if (fout && fout != stderr && fout != stdout)
     {
         fclose(fout);
@@ -478,3 +496,251 @@ qof_log_level_from_string(const gchar *str)
     if (g_ascii_strncasecmp("debug", str, 5) == 0) return QOF_LOG_DEBUG;
     return QOF_LOG_DEBUG;
 }
+
+/* ************************ Tracing ************************ */
+
+#define QOF_TRACE_BUFFER_SIZE 65536
+
+struct QofTraceEvent
+{
+    QofLogModule module;
+    const char *name;
+    gint64 start;
+    gint64 duration;
+};
+
+/* The spans of one thread. Only the owning thread records into it, and
+ * it takes busy for that with a single exchange, never waiting: if
+ * qof_trace_dump() or qof_trace_clear() holds busy the span is dropped.
+ * The events are allocated with the first span after tracing is turned
+ * on and freed when it is turned off. */
+struct QofTraceBuffer
+{
+    explicit QofTraceBuffer (guint id) : thread_id{id} {}
+    guint thread_id;
+    std::atomic<bool> busy{false};
+    std::atomic<bool> exited{false};
+    std::vector<QofTraceEvent> events;
+    size_t next = 0;
+    bool wrapped = false;
+};
+
+/* Marks the thread's buffer as no longer in use when the thread ends. */
+struct QofTraceThread
+{
+    ~QofTraceThread ()
+    {
+        if (buffer)
+            buffer->exited.store(true, std::memory_order_release);
+    }
+    QofTraceBuffer *buffer = nullptr;
+};
+
+static std::atomic<bool> trace_enabled{false};
+static gchar *trace_filename = NULL;
+/* Buffers outlive their threads so that a dump at shutdown still sees
+ * the spans of worker threads that have already exited; those are
+ * deleted when the spans are discarded. The mutex guards the list, not
+ * the buffers. */
+static std::mutex trace_buffers_mutex;
+static std::vector<std::unique_ptr<QofTraceBuffer>> trace_buffers;
+static guint trace_last_thread_id = 0;
+
+static QofTraceBuffer*
+qof_trace_thread_buffer (void)
+{
+    static thread_local QofTraceThread thread;
+    if (!thread.buffer)
+    {
+        std::lock_guard<std::mutex> lock{trace_buffers_mutex};
+        trace_buffers.emplace_back(new QofTraceBuffer(++trace_last_thread_id));
+        thread.buffer = trace_buffers.back().get();
+    }
+    return thread.buffer;
+}
+
+/* For readers of another thread's buffer. The owner holds busy only
+ * while storing one event, so this doesn't spin for long. */
+static void
+qof_trace_buffer_lock (QofTraceBuffer *buffer)
+{
+    while (buffer->busy.exchange(true, std::memory_order_acquire))
+        std::this_thread::yield();
+}
+
+static void
+qof_trace_buffer_unlock (QofTraceBuffer *buffer)
+{
+    buffer->busy.store(false, std::memory_order_release);
+}
+
+/* Discard every recorded span and free the events. */
+static void
+qof_trace_release_buffers (void)
+{
+    std::lock_guard<std::mutex> lock{trace_buffers_mutex};
+    for (auto iter = trace_buffers.begin(); iter != trace_buffers.end();)
+    {
+        auto buffer = iter->get();
+        if (buffer->exited.load(std::memory_order_acquire))
+        {
+            iter = trace_buffers.erase(iter);
+            continue;
+        }
+        qof_trace_buffer_lock(buffer);
+        std::vector<QofTraceEvent>().swap(buffer->events);
+        buffer->next = 0;
+        buffer->wrapped = false;
+        qof_trace_buffer_unlock(buffer);
+        ++iter;
+    }
+}
+
+static gint64
+qof_trace_now (void)
+{
+    using namespace std::chrono;
+    auto now = steady_clock::now().time_since_epoch();
+    return duration_cast<nanoseconds>(now).count();
+}
+
+void
+qof_trace_enable (gboolean enable)
+{
+    trace_enabled.store(enable, std::memory_order_relaxed);
+    if (!enable)
+        qof_trace_release_buffers();
+}
+
+gboolean
+qof_trace_is_enabled (void)
+{
+    return trace_enabled.load(std::memory_order_relaxed);
+}
+
+void
+qof_trace_set_file (const gchar *filename)
+{
+    g_free(trace_filename);
+    trace_filename = g_strdup(filename);
+    qof_trace_enable(filename != NULL);
+}
+
+gint64
+qof_trace_begin (void)
+{
+    if (G_LIKELY(!trace_enabled.load(std::memory_order_relaxed)))
+        return 0;
+    /* 0 means "not traced", so never hand it out as a start time. */
+    return MAX(qof_trace_now(), 1);
+}
+
+void
+qof_trace_end (QofLogModule log_module, const char *name, gint64 start)
+{
+    if (start == 0)
+        return;
+    auto end = qof_trace_now();
+    auto buffer = qof_trace_thread_buffer();
+    if (buffer->busy.exchange(true, std::memory_order_acquire))
+        return;
+    /* Checked again now that busy is held, so that a span finishing
+     * just after tracing was turned off doesn't allocate the events
+     * again. */
+    if (trace_enabled.load(std::memory_order_relaxed))
+    {
+        if (buffer->events.empty())
+            buffer->events.resize(QOF_TRACE_BUFFER_SIZE);
+        buffer->events[buffer->next] = {log_module, name, start, end - start};
+        if (++buffer->next == buffer->events.size())
+        {
+            buffer->next = 0;
+            buffer->wrapped = true;
+        }
+    }
+    qof_trace_buffer_unlock(buffer);
+}
+
+void
+qof_trace_clear (void)
+{
+    qof_trace_release_buffers();
+}
+
+static void
+qof_trace_write_string (FILE *out, const char *str)
+{
+    fputc('"', out);
+    for (const char *c = str ? str : ""; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+            fprintf(out, "\\%c", *c);
+        else if (static_cast<unsigned char>(*c) < 0x20)
+            fprintf(out, "\\u%04x", *c);
+        else
+            fputc(*c, out);
+    }
+    fputc('"', out);
+}
+
+static void
+qof_trace_write_event (FILE *out, const QofTraceEvent& event, long pid,
+                       guint tid)
+{
+    fputs(",\n{\"name\":", out);
+    qof_trace_write_string(out, event.name);
+    fputs(",\"cat\":", out);
+    qof_trace_write_string(out, event.module);
+    /* Chrome wants microseconds. */
+    fprintf(out, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%ld,\"tid\":%u}",
+            event.start / 1000.0, event.duration / 1000.0, pid, tid);
+}
+
+gboolean
+qof_trace_dump (const gchar *filename)
+{
+    g_return_val_if_fail(filename, FALSE);
+    FILE *out = g_fopen(filename, "w");
+    if (!out)
+    {
+        g_warning("Cannot open trace file \"%s\".", filename);
+        return FALSE;
+    }
+#if PLATFORM(WINDOWS)
+    long pid = GetCurrentProcessId();
+#else
+    long pid = getpid();
+#endif
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+            "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%ld,"
+            "\"args\":{\"name\":\"%s\"}}", pid, PROJECT_NAME);
+
+    std::lock_guard<std::mutex> lock{trace_buffers_mutex};
+    for (auto& buffer : trace_buffers)
+    {
+        qof_trace_buffer_lock(buffer.get());
+        auto tid = buffer->thread_id;
+        fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,"
+                "\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}", pid, tid, tid);
+        /* Oldest first: after wrapping that's the slot about to be
+         * overwritten. */
+        if (buffer->wrapped)
+            for (auto i = buffer->next; i < buffer->events.size(); ++i)
+                qof_trace_write_event(out, buffer->events[i], pid, tid);
+        for (size_t i = 0; i < buffer->next; ++i)
+            qof_trace_write_event(out, buffer->events[i], pid, tid);
+        qof_trace_buffer_unlock(buffer.get());
+    }
+    fputs("\n]}\n", out);
+    return fclose(out) == 0;
+}
+
+static void
+qof_trace_shutdown (void)
+{
+    if (trace_filename)
+        qof_trace_dump(trace_filename);
+    qof_trace_enable(FALSE);
+    g_free(trace_filename);
+    trace_filename = NULL;
+}
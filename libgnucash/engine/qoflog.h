@@ -171,6 +171,58 @@ gboolean qof_log_check(QofLogModule log_module, QofLogLevel log_level);
 /** Set the default level for QOF-related log paths. **/
 void qof_log_set_default(QofLogLevel log_level);
 
+/** @name Tracing
+ *
+ * Tracing records timed spans rather than messages. Each span carries
+ * the log module it was recorded in, a name, a monotonic start time, a
+ * duration and the recording thread. Spans go into a fixed-size ring
+ * buffer belonging to the recording thread, so only the most recent
+ * spans of each thread are kept, and are written out as Chrome
+ * trace-event JSON (load it in chrome://tracing or
+ * https://ui.perfetto.dev) by qof_trace_dump() or, if a trace file
+ * was set, by qof_log_shutdown().
+ *
+ * Tracing is off by default; while it is off qof_trace_begin() and
+ * qof_trace_end() do nothing but test a flag. Set the environment
+ * variable GNC_TRACE to a file name, or call qof_trace_set_file(), to
+ * turn it on. A thread's buffer is allocated when it first records a
+ * span and freed, along with the spans in it, when tracing is turned
+ * off again. Recording a span never blocks; spans that finish while
+ * qof_trace_dump() is writing out their thread's buffer are dropped.
+ *
+ * Span names and modules are not copied and must be string literals
+ * or otherwise outlive the trace.
+ * @{
+ */
+
+/** Turn tracing on or off without changing the trace file. Turning it
+ * off discards the recorded spans, so dump them first. */
+void qof_trace_enable (gboolean enable);
+
+/** TRUE if spans are currently being recorded. */
+gboolean qof_trace_is_enabled (void);
+
+/** Turn tracing on and write the trace to @a filename at
+ * qof_log_shutdown(). A NULL @a filename turns tracing off. */
+void qof_trace_set_file (const gchar *filename);
+
+/** Start a span. Returns the start time to pass to qof_trace_end(),
+ * or 0 if tracing is off. */
+gint64 qof_trace_begin (void);
+
+/** Finish the span started at @a start and record it as @a name in
+ * @a log_module. Does nothing if @a start is 0. */
+void qof_trace_end (QofLogModule log_module, const char *name, gint64 start);
+
+/** Write all recorded spans to @a filename as Chrome trace-event JSON.
+ * @return TRUE on success. */
+gboolean qof_trace_dump (const gchar *filename);
+
+/** Discard all recorded spans and free the buffers holding them. */
+void qof_trace_clear (void);
+
+/** @} */
+
 #define PRETTY_FUNC_NAME qof_log_prettify(G_STRFUNC)
 
 #ifdef _MSC_VER
@@ -301,6 +353,24 @@ void qof_log_set_default(QofLogLevel log_level);
 
 #ifdef __cplusplus
 }
+
+/** Records a span covering its own lifetime. */
+class QofTraceSpan
+{
+public:
+    QofTraceSpan (QofLogModule log_module, const char *name) :
+        m_module{log_module}, m_name{name}, m_start{qof_trace_begin ()} {}
+    ~QofTraceSpan () { qof_trace_end (m_module, m_name, m_start); }
+    QofTraceSpan (const QofTraceSpan&) = delete;
+    QofTraceSpan& operator= (const QofTraceSpan&) = delete;
+private:
+    QofLogModule m_module;
+    const char *m_name;
+    gint64 m_start;
+};
+
+/** Trace the rest of the enclosing scope as @a name in log_module. */
+#define QOF_TRACE_SPAN(name) QofTraceSpan qof_trace_span_ (log_module, name)
 #endif
 
 #endif /* _QOF_LOG_H */
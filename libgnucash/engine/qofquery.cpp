@@ -845,8 +845,69 @@ static void qof_query_run_cb(QofQueryCB* qcb, gpointer cb_arg)
     }
 }
 
+/* The type of the instances whose GUIDs a term on @a params compares,
+ * or NULL if the path doesn't end in QOF_PARAM_GUID. */
+static QofIdTypeConst
+query_term_guid_type (QofIdTypeConst type, QofQueryParamList *params)
+{
+    for (; params; params = params->next)
+    {
+        auto name = static_cast<const char*>(params->data);
+        if (!g_strcmp0 (name, QOF_PARAM_GUID))
+            return params->next ? NULL : type;
+        auto param = qof_class_get_parameter (type, name);
+        if (!param)
+            return NULL;
+        type = param->param_type;
+    }
+    return NULL;
+}
+
+/* Record what the result of the query depends on: the instances each
+ * or-term is restricted to by a GUID match, or the books if some
+ * or-term could match anything in them. */
+static void
+qof_query_record_reads (const QofQuery *q)
+{
+    for (auto or_ptr = q->terms; or_ptr; or_ptr = or_ptr->next)
+    {
+        auto restricted = FALSE;
+        for (auto and_ptr = static_cast<GList*>(or_ptr->data); and_ptr;
+             and_ptr = and_ptr->next)
+        {
+            auto qt = static_cast<QofQueryTerm*>(and_ptr->data);
+            if (qt->invert || g_strcmp0 (qt->pdata->type_name, QOF_TYPE_GUID))
+                continue;
+            auto pdata = reinterpret_cast<query_guid_t>(qt->pdata);
+            if (pdata->options != QOF_GUID_MATCH_ANY &&
+                pdata->options != QOF_GUID_MATCH_ALL)
+                continue;
+            auto type = query_term_guid_type (q->search_for, qt->param_list);
+            if (!type)
+                continue;
+            restricted = TRUE;
+            for (auto book = q->books; book; book = book->next)
+            {
+                auto col = qof_book_get_collection (static_cast<QofBook*>(book->data),
+                                                    type);
+                for (auto node = pdata->guids; node; node = node->next)
+                    qof_instance_record_read (qof_collection_lookup_entity (
+                        col, static_cast<GncGUID*>(node->data)));
+            }
+        }
+        if (!restricted)
+            break;
+        if (!or_ptr->next)
+            return;
+    }
+    g_list_foreach (q->books, (GFunc)qof_instance_record_read, NULL);
+}
+
 GList * qof_query_run (QofQuery *q)
 {
+    QOF_TRACE_SPAN ("qof_query_run");
+    if (q)
+        qof_query_record_reads (q);
     /* Just a wrapper */
     return qof_query_run_internal(q, qof_query_run_cb, NULL);
 }
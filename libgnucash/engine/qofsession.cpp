@@ -205,6 +205,7 @@ QofSessionImpl::load (QofPercentageFunc percentage_func) noexcept
     
     if (!m_book_id.size ()) return;
     ENTER ("sess=%p book_id=%s", this, m_book_id.c_str ());
+    QOF_TRACE_SPAN ("QofSession::load");
 
     /* At this point, we should are supposed to have a valid book
     * id and a lock on the file. */
@@ -222,6 +223,7 @@ QofSessionImpl::load (QofPercentageFunc percentage_func) noexcept
             (err != ERR_FILEIO_FILE_TOO_OLD) &&
             (err != ERR_FILEIO_NO_ENCODING) &&
             (err != ERR_FILEIO_FILE_UPGRADE) &&
+            (err != ERR_FILEIO_JOURNAL_CORRUPT) &&
             (err != ERR_SQL_DB_TOO_OLD) &&
             (err != ERR_SQL_DB_TOO_NEW))
     {
@@ -429,6 +431,7 @@ QofSessionImpl::save (QofPercentageFunc percentage_func) noexcept
         return;
     m_saving = true;
     ENTER ("sess=%p book_id=%s", this, m_book_id.c_str ());
+    QOF_TRACE_SPAN ("QofSession::save");
 
     /* If there is a backend, the book is dirty, and the backend is reachable
      * (i.e. we can communicate with it), then synchronize with the backend.  If
@@ -467,6 +470,7 @@ QofSessionImpl::safe_save (QofPercentageFunc percentage_func) noexcept
 {
     auto backend = qof_book_get_backend (m_book);
     if (!backend) return;
+    QOF_TRACE_SPAN ("QofSession::safe_save");
     backend->set_percentage(percentage_func);
     backend->safe_sync(get_book ());
     auto err = backend->get_error();
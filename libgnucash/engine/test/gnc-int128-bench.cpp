@@ -0,0 +1,159 @@
+/********************************************************************
+ * gnc-int128-bench.cpp: Timing harness for GncInt128 arithmetic.   *
+ * Copyright 2026 GnuCash team                                      *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+/* Times the GncInt128 operations that GncRational leans on when the
+ * denominators differ: share amount times price, dividing the product
+ * back down to the commodity's fraction, and the gcd/lcm of the
+ * denominators. It is built twice, as gnc-int128-bench with the native
+ * 128-bit backend where the compiler has one and as
+ * gnc-int128-bench-portable with the limb arithmetic, so that the two
+ * can be compared:
+ *
+ *   gnc-int128-bench [COUNT]
+ *
+ * Neither is part of the test suite; build them with
+ * "make gnc-int128-bench gnc-int128-bench-portable".
+ */
+
+#include "../gnc-int128.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/* Results are folded into this so that the loops aren't optimized
+ * away. */
+static volatile bool int128_sink;
+
+template <typename F> static void
+bench_time (const char *name, F&& func)
+{
+    auto start = std::chrono::steady_clock::now ();
+    func ();
+    auto end = std::chrono::steady_clock::now ();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    printf ("%-28s %10.2f ms\n", name, elapsed.count ());
+}
+
+int
+main (int argc, char **argv)
+{
+    size_t count = argc > 1 ? strtoul (argv[1], nullptr, 10) : 1000000;
+    if (count == 0)
+        count = 1000000;
+
+    /* Amounts up to a hundred million units in hundredths, prices with
+     * up to nine places and the denominators they come with. */
+    static const int64_t denoms[] = { 1, 100, 1000, 10000, 100000, 1000000,
+                                      100000000, 1000000000, 3, 7, 360 };
+    std::mt19937_64 rng (42);
+    std::uniform_int_distribution<int64_t> amount_dist (-10000000000, 10000000000);
+    std::uniform_int_distribution<int64_t> price_dist (1, 1000000000000);
+    std::uniform_int_distribution<size_t> denom_dist (0, sizeof (denoms) / sizeof (denoms[0]) - 1);
+
+    std::vector<GncInt128> amounts, prices, products, amount_denoms, price_denoms;
+    amounts.reserve (count);
+    prices.reserve (count);
+    amount_denoms.reserve (count);
+    price_denoms.reserve (count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        amounts.emplace_back (amount_dist (rng));
+        prices.emplace_back (price_dist (rng));
+        amount_denoms.emplace_back (denoms[denom_dist (rng)]);
+        price_denoms.emplace_back (denoms[denom_dist (rng)]);
+    }
+    products.reserve (count);
+    for (size_t i = 0; i < count; ++i)
+        products.push_back (amounts[i] * prices[i]);
+
+    printf ("%s backend, %zu operations each\n",
+#if defined(__SIZEOF_INT128__) && !defined(GNC_INT128_PORTABLE) && \
+    ((defined(__GNUC__) && __GNUC__ >= 5) || defined(__clang__))
+            "native",
+#else
+            "portable",
+#endif
+            count);
+
+    bench_time ("int128_mul", [&]()
+    {
+        GncInt128 acc;
+        for (size_t i = 0; i < count; ++i)
+            acc ^= amounts[i] * prices[i];
+        int128_sink = static_cast<bool>(acc);
+    });
+    bench_time ("int128_div", [&]()
+    {
+        GncInt128 acc;
+        GncInt128 q, r;
+        for (size_t i = 0; i < count; ++i)
+        {
+            products[i].div (price_denoms[i], q, r);
+            acc ^= q ^ r;
+        }
+        int128_sink = static_cast<bool>(acc);
+    });
+    bench_time ("int128_div_wide", [&]()
+    {
+        /* Both operands over 64 bits, as when reducing a product of
+         * two products. */
+        GncInt128 acc;
+        GncInt128 q, r;
+        for (size_t i = 1; i < count; ++i)
+        {
+            auto num = products[i] * GncInt128 (100000);
+            auto den = products[i - 1].abs () + GncInt128 (1);
+            num.div (den, q, r);
+            acc ^= q;
+        }
+        int128_sink = static_cast<bool>(acc);
+    });
+    bench_time ("int128_gcd", [&]()
+    {
+        GncInt128 acc;
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto den = amount_denoms[i] * price_denoms[i];
+            acc ^= products[i].gcd (den);
+        }
+        int128_sink = static_cast<bool>(acc);
+    });
+    bench_time ("int128_gcd_wide", [&]()
+    {
+        GncInt128 acc;
+        for (size_t i = 1; i < count; ++i)
+            acc ^= products[i].gcd (products[i - 1]);
+        int128_sink = static_cast<bool>(acc);
+    });
+    bench_time ("int128_lcm", [&]()
+    {
+        GncInt128 acc;
+        for (size_t i = 0; i < count; ++i)
+            acc ^= amount_denoms[i].lcm (price_denoms[i]);
+        int128_sink = static_cast<bool>(acc);
+    });
+    return 0;
+}
@@ -0,0 +1,749 @@
+/********************************************************************
+ * gnucash-bench.cpp: Timing harness for the engine hot paths.      *
+ * Copyright 2026 GnuCash team                                      *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ ********************************************************************/
+
+/* gnucash-bench builds a synthetic book with the test-engine-stuff
+ * generators, runs the engine's hot paths against it and prints the
+ * timings as JSON so that runs can be compared across releases:
+ *
+ *   gnucash-bench --accounts 200 --transactions 20000 --prices 2000 \
+ *                 --seed 42 --output bench.json
+ *
+ * It is not part of the test suite; build it with
+ * "make gnucash-bench" and run it from the build directory.
+ */
+
+extern "C"
+{
+#include <config.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef G_OS_WIN32
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#include "qof.h"
+#include "cashobjects.h"
+#include "gnc-engine.h"
+#include "Account.h"
+#include "Transaction.h"
+#include "Split.h"
+#include "Query.h"
+#include "Scrub.h"
+#include "Scrub3.h"
+#include "gnc-pricedb.h"
+#include "TransLog.h"
+#include "test-engine-stuff.h"
+#include "test-stuff.h"
+}
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include "../gnc-datetime.hpp"
+
+struct BenchResult
+{
+    std::string name;
+    double msecs;
+    unsigned long ops;
+};
+
+struct BenchMemory
+{
+    std::string name;
+    long rss_kb;
+};
+
+struct BenchRun
+{
+    std::vector<BenchResult> results;
+    std::vector<BenchMemory> memory;
+};
+
+static gint num_accounts = 100;
+static gint num_transactions = 5000;
+static gint num_prices = 1000;
+static gint num_lookups = 1000;
+static gint seed = 1;
+static gboolean skip_sql = FALSE;
+static gchar *output_file = NULL;
+
+static GOptionEntry bench_options[] =
+{
+    { "accounts", 'a', 0, G_OPTION_ARG_INT, &num_accounts,
+      "Number of accounts in the generated book", "N" },
+    { "transactions", 't', 0, G_OPTION_ARG_INT, &num_transactions,
+      "Number of transactions in the generated book", "M" },
+    { "prices", 'p', 0, G_OPTION_ARG_INT, &num_prices,
+      "Number of prices in the generated price database", "P" },
+    { "lookups", 'l', 0, G_OPTION_ARG_INT, &num_lookups,
+      "Number of queries, price and import-map lookups to time", "K" },
+    { "seed", 's', 0, G_OPTION_ARG_INT, &seed,
+      "Random seed; identical seeds generate identical books", "SEED" },
+    { "skip-sql", 0, 0, G_OPTION_ARG_NONE, &skip_sql,
+      "Don't time the SQLite backend", NULL },
+    { "output", 'o', 0, G_OPTION_ARG_FILENAME, &output_file,
+      "Write the JSON results to FILE instead of stdout", "FILE" },
+    { NULL }
+};
+
+/* Resident set size of the process in kB, or -1 if the platform
+ * doesn't tell us. */
+static long
+current_rss_kb (void)
+{
+    long rss = -1;
+#ifdef __linux__
+    FILE *statm = fopen ("/proc/self/statm", "r");
+    if (statm)
+    {
+        long size, resident;
+        if (fscanf (statm, "%ld %ld", &size, &resident) == 2)
+            rss = resident * (sysconf (_SC_PAGESIZE) / 1024);
+        fclose (statm);
+    }
+#endif
+    return rss;
+}
+
+static long
+peak_rss_kb (void)
+{
+#ifndef G_OS_WIN32
+    struct rusage usage;
+    if (getrusage (RUSAGE_SELF, &usage) == 0)
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024;
+#else
+        return usage.ru_maxrss;
+#endif
+#endif
+    return -1;
+}
+
+template <typename F> static void
+bench_time (BenchRun& run, const char *name, unsigned long ops, F&& func)
+{
+    auto start = std::chrono::steady_clock::now ();
+    func ();
+    auto end = std::chrono::steady_clock::now ();
+    std::chrono::duration<double, std::milli> elapsed = end - start;
+    run.results.push_back ({name, elapsed.count (), ops});
+    g_printerr ("%-28s %10.2f ms\n", name, elapsed.count ());
+}
+
+static void
+bench_memory (BenchRun& run, const char *name)
+{
+    run.memory.push_back ({name, current_rss_kb ()});
+}
+
+/********************************************************************\
+ * Book generation
+\********************************************************************/
+
+static std::vector<Account*>
+generate_accounts (QofBook *book, gint count)
+{
+    std::vector<Account*> accounts;
+    accounts.reserve (count);
+    /* get_random_account appends to the root; move about a third of
+     * them under an earlier account to get some depth in the tree. */
+    for (gint i = 0; i < count; ++i)
+    {
+        Account *acc = get_random_account (book);
+        if (i > 0 && get_random_int_in_range (0, 2) == 0)
+        {
+            Account *parent = accounts[get_random_int_in_range (0, i - 1)];
+            gnc_account_append_child (parent, acc);
+        }
+        accounts.push_back (acc);
+    }
+    return accounts;
+}
+
+static void
+generate_prices (QofBook *book, gint count)
+{
+    GNCPriceDB *db = gnc_pricedb_get_db (book);
+    gint attempts = count * 2;
+    while (count > 0 && attempts-- > 0)
+    {
+        GNCPrice *p = get_random_price (book);
+        if (!p)
+            break;
+        /* Prices with the same commodity, currency and date are
+         * rejected, just try again. */
+        if (gnc_pricedb_add_price (db, p))
+            --count;
+        gnc_price_unref (p);
+    }
+}
+
+static gboolean
+collect_price (GNCPrice *p, gpointer data)
+{
+    static_cast<std::vector<GNCPrice*>*>(data)->push_back (p);
+    return TRUE;
+}
+
+/********************************************************************\
+ * Engine benchmarks
+\********************************************************************/
+
+static void
+bench_recompute_balances (BenchRun& run, const std::vector<Account*>& accounts)
+{
+    bench_time (run, "recompute_balance", accounts.size (), [&accounts]()
+    {
+        for (auto acc : accounts)
+        {
+            xaccAccountRecomputeBalance (acc);
+        }
+    });
+}
+
+/* Running balances over every split amount in the book, as
+ * xaccAccountRecomputeBalance and the register do. The amounts are
+ * summed several times over so that the loops take measurable time. */
+static const int numeric_passes = 100;
+static volatile gint64 numeric_sink;
+
+static void
+bench_numeric (BenchRun& run, const std::vector<Account*>& accounts)
+{
+    std::vector<gnc_numeric> amounts;
+    for (auto acc : accounts)
+        for (auto node = xaccAccountGetSplitList (acc); node; node = node->next)
+            amounts.push_back (xaccSplitGetAmount (GNC_SPLIT (node->data)));
+    if (amounts.empty ())
+        return;
+
+    auto ops = amounts.size () * numeric_passes;
+    bench_time (run, "numeric_add_fixed", ops, [&amounts]()
+    {
+        for (int pass = 0; pass < numeric_passes; ++pass)
+        {
+            auto balance = gnc_numeric_zero ();
+            for (auto amount : amounts)
+                balance = gnc_numeric_add_fixed (balance, amount);
+            numeric_sink = balance.num;
+        }
+    });
+    bench_time (run, "numeric_add_lcd", ops, [&amounts]()
+    {
+        for (int pass = 0; pass < numeric_passes; ++pass)
+        {
+            auto balance = gnc_numeric_zero ();
+            for (auto amount : amounts)
+                balance = gnc_numeric_add (balance, amount, GNC_DENOM_AUTO,
+                                           GNC_HOW_DENOM_LCD);
+            numeric_sink = balance.num;
+        }
+    });
+    bench_time (run, "numeric_sum", ops, [&amounts]()
+    {
+        for (int pass = 0; pass < numeric_passes; ++pass)
+            numeric_sink = gnc_numeric_sum (amounts.data (), amounts.size ()).num;
+    });
+    bench_time (run, "numeric_compare", ops, [&amounts]()
+    {
+        for (int pass = 0; pass < numeric_passes; ++pass)
+        {
+            auto balance = gnc_numeric_zero ();
+            gint64 crossings = 0;
+            for (auto amount : amounts)
+            {
+                auto next = gnc_numeric_sub_fixed (balance, amount);
+                if (gnc_numeric_compare (next, balance) > 0)
+                    ++crossings;
+                balance = next;
+            }
+            numeric_sink = crossings;
+        }
+    });
+
+    /* Reduced amounts have all sorts of denominators, which the fast
+     * path can't handle. */
+    std::vector<gnc_numeric> mixed;
+    mixed.reserve (amounts.size ());
+    for (auto amount : amounts)
+        mixed.push_back (gnc_numeric_reduce (amount));
+    bench_time (run, "numeric_add_mixed", ops, [&mixed]()
+    {
+        for (int pass = 0; pass < numeric_passes; ++pass)
+        {
+            auto balance = gnc_numeric_zero ();
+            for (auto amount : mixed)
+                balance = gnc_numeric_add_fixed (balance, amount);
+            numeric_sink = balance.num;
+        }
+    });
+}
+
+static void
+bench_split_queries (BenchRun& run, QofBook *book,
+                     const std::vector<Account*>& accounts)
+{
+    unsigned long matches = 0;
+    bench_time (run, "query_splits", num_lookups, [&]()
+    {
+        for (gint i = 0; i < num_lookups; ++i)
+        {
+            Account *acc = accounts[get_random_int_in_range (0, accounts.size () - 1)];
+            time64 t1 = get_random_time (), t2 = get_random_time ();
+            QofQuery *q = qof_query_create_for (GNC_ID_SPLIT);
+            qof_query_set_book (q, book);
+            xaccQueryAddSingleAccountMatch (q, acc, QOF_QUERY_AND);
+            xaccQueryAddDateMatchTT (q, TRUE, MIN (t1, t2), TRUE, MAX (t1, t2),
+                                     QOF_QUERY_AND);
+            matches += g_list_length (qof_query_run (q));
+            qof_query_destroy (q);
+        }
+    });
+    g_printerr ("%-28s %10lu splits\n", "  matched", matches);
+}
+
+static void
+bench_price_lookups (BenchRun& run, QofBook *book)
+{
+    GNCPriceDB *db = gnc_pricedb_get_db (book);
+    std::vector<GNCPrice*> prices;
+    gnc_pricedb_foreach_price (db, collect_price, &prices, FALSE);
+    if (prices.empty ())
+        return;
+
+    bench_time (run, "pricedb_lookup_nearest", num_lookups, [&]()
+    {
+        for (gint i = 0; i < num_lookups; ++i)
+        {
+            GNCPrice *p = prices[get_random_int_in_range (0, prices.size () - 1)];
+            GNCPrice *found =
+                gnc_pricedb_lookup_nearest_in_time64 (db, gnc_price_get_commodity (p),
+                                                      gnc_price_get_currency (p),
+                                                      get_random_time ());
+            gnc_price_unref (found);
+        }
+    });
+    bench_time (run, "pricedb_lookup_latest", num_lookups, [&]()
+    {
+        for (gint i = 0; i < num_lookups; ++i)
+        {
+            GNCPrice *p = prices[get_random_int_in_range (0, prices.size () - 1)];
+            GNCPrice *found =
+                gnc_pricedb_lookup_latest (db, gnc_price_get_commodity (p),
+                                           gnc_price_get_currency (p));
+            gnc_price_unref (found);
+        }
+    });
+}
+
+static GList*
+description_tokens (Transaction *trans)
+{
+    GList *tokens = NULL;
+    const char *desc = xaccTransGetDescription (trans);
+    gchar **words = g_strsplit (desc ? desc : "", " ", -1);
+    for (gchar **word = words; *word; ++word)
+    {
+        if (**word)
+            tokens = g_list_prepend (tokens, g_strdup (*word));
+    }
+    g_strfreev (words);
+    return tokens;
+}
+
+static void
+bench_import_matching (BenchRun& run, const std::vector<Account*>& accounts)
+{
+    std::vector<Split*> splits;
+    for (auto acc : accounts)
+    {
+        for (GList *node = xaccAccountGetSplitList (acc); node; node = node->next)
+            splits.push_back (static_cast<Split*>(node->data));
+    }
+    if (splits.empty ())
+        return;
+
+    GncImportMatchMap *imap = gnc_account_imap_create_imap (accounts.front ());
+    gint training = MIN ((size_t)num_lookups, splits.size ());
+    bench_time (run, "bayes_add", training, [&]()
+    {
+        for (gint i = 0; i < training; ++i)
+        {
+            Split *split = splits[get_random_int_in_range (0, splits.size () - 1)];
+            GList *tokens = description_tokens (xaccSplitGetParent (split));
+            gnc_account_imap_add_account_bayes (imap, tokens,
+                                                xaccSplitGetAccount (split));
+            g_list_free_full (tokens, g_free);
+        }
+    });
+    bench_time (run, "bayes_find", num_lookups, [&]()
+    {
+        for (gint i = 0; i < num_lookups; ++i)
+        {
+            Split *split = splits[get_random_int_in_range (0, splits.size () - 1)];
+            GList *tokens = description_tokens (xaccSplitGetParent (split));
+            gnc_account_imap_find_account_bayes (imap, tokens);
+            g_list_free_full (tokens, g_free);
+        }
+    });
+    g_free (imap);
+}
+
+/* The tree scrubbers report progress unconditionally. */
+static void
+bench_no_progress (const char *message, double percent)
+{
+}
+
+static void
+bench_scrub (BenchRun& run, QofBook *book)
+{
+    Account *root = gnc_book_get_root_account (book);
+    bench_time (run, "scrub_orphans", 1, [root]()
+    {
+        xaccAccountTreeScrubOrphans (root, bench_no_progress);
+    });
+    bench_time (run, "scrub_imbalance", 1, [root]()
+    {
+        xaccAccountTreeScrubImbalance (root, bench_no_progress);
+    });
+    bench_time (run, "scrub_commodities", 1, [root]()
+    {
+        xaccAccountTreeScrubCommodities (root);
+    });
+    bench_time (run, "scrub_lots", 1, [root]()
+    {
+        xaccAccountTreeScrubLots (root);
+    });
+
+    /* The scrubs above have already repaired the book, so give the
+     * combined scrub an unrepaired one: the same accounts and
+     * transactions, generated again from the same seed. */
+    QofSession *fresh_session = qof_session_new ();
+    QofBook *fresh_book = qof_session_get_book (fresh_session);
+    srand (seed);
+    generate_accounts (fresh_book, num_accounts);
+    add_random_transactions_to_book (fresh_book, num_transactions);
+    Account *fresh_root = gnc_book_get_root_account (fresh_book);
+    bench_time (run, "scrub_tree", 1, [fresh_root]()
+    {
+        xaccAccountTreeScrub (fresh_root, TRUE, NULL);
+    });
+    qof_session_end (fresh_session);
+    qof_session_destroy (fresh_session);
+}
+
+/* Print the posted date of every split, as a register does, through
+ * qof_print_date_buff and through the stream formatting it used to
+ * do itself, then scan the printed dates back. */
+static void
+bench_dates (BenchRun& run, const std::vector<Account*>& accounts)
+{
+    std::vector<time64> dates;
+    for (auto acc : accounts)
+        for (auto node = xaccAccountGetSplitList (acc); node; node = node->next)
+            dates.push_back (xaccTransGetDate (xaccSplitGetParent (GNC_SPLIT (node->data))));
+
+    std::vector<std::string> printed;
+    printed.reserve (dates.size ());
+    bench_time (run, "print_date", dates.size (), [&]()
+    {
+        char buff[MAX_DATE_LENGTH + 1];
+        for (auto date : dates)
+        {
+            qof_print_date_buff (buff, sizeof (buff), date);
+            printed.emplace_back (buff);
+        }
+    });
+    bench_time (run, "print_date_stream", dates.size (), [&dates]()
+    {
+        auto format = qof_date_format_get_string (qof_date_format_get ());
+        for (auto date : dates)
+            GncDateTime (date).format (format);
+    });
+    bench_time (run, "scan_date", printed.size (), [&printed]()
+    {
+        int day, month, year;
+        for (const auto& str : printed)
+            qof_scan_date (str.c_str (), &day, &month, &year);
+    });
+    /* What bucketing the dates by day or month costs. */
+    bench_time (run, "localtime", dates.size (), [&dates]()
+    {
+        struct tm tm;
+        for (auto date : dates)
+            gnc_localtime_r (&date, &tm);
+    });
+    bench_time (run, "day_start", dates.size (), [&dates]()
+    {
+        for (auto date : dates)
+            gnc_time64_get_day_start (date);
+    });
+}
+
+/* Log every transaction as committed, as an import would, then wait
+ * for the log to reach the disk. */
+static void
+bench_translog (BenchRun& run, QofBook *book, const char *tmpdir)
+{
+    std::vector<Transaction*> transactions;
+    auto coll = qof_book_get_collection (book, GNC_ID_TRANS);
+    qof_collection_foreach (coll, [](QofInstance *inst, gpointer data)
+    {
+        static_cast<std::vector<Transaction*>*>(data)->push_back (GNC_TRANSACTION (inst));
+    }, &transactions);
+
+    gchar *base = g_build_filename (tmpdir, "bench", NULL);
+    xaccLogEnable ();
+    xaccLogSetBaseName (base);
+    xaccOpenLog ();
+    bench_time (run, "translog_write", transactions.size (), [&transactions]()
+    {
+        for (auto trans : transactions)
+            xaccTransWriteLog (trans, 'C');
+        xaccLogSync ();
+    });
+    xaccCloseLog ();
+    xaccLogDisable ();
+    g_free (base);
+}
+
+/********************************************************************\
+ * Backend benchmarks
+\********************************************************************/
+
+static gboolean
+bench_save (BenchRun& run, const char *name, QofSession *session,
+            const std::string& uri)
+{
+    QofSession *save_session = qof_session_new ();
+    qof_session_begin (save_session, uri.c_str (), FALSE, TRUE, TRUE);
+    if (qof_session_get_error (save_session) != ERR_BACKEND_NO_ERR)
+    {
+        g_printerr ("Unable to create %s: %s\n", uri.c_str (),
+                    qof_session_get_error_message (save_session));
+        qof_session_destroy (save_session);
+        return FALSE;
+    }
+    qof_session_swap_data (session, save_session);
+    qof_book_mark_session_dirty (qof_session_get_book (save_session));
+    bench_time (run, name, 1, [save_session]()
+    {
+        qof_session_save (save_session, NULL);
+    });
+    gboolean ok = qof_session_get_error (save_session) == ERR_BACKEND_NO_ERR;
+    if (!ok)
+        g_printerr ("Saving %s failed: %s\n", uri.c_str (),
+                    qof_session_get_error_message (save_session));
+    qof_session_swap_data (save_session, session);
+    qof_session_end (save_session);
+    qof_session_destroy (save_session);
+    return ok;
+}
+
+static void
+bench_load (BenchRun& run, const char *name, const std::string& uri)
+{
+    QofSession *load_session = qof_session_new ();
+    qof_session_begin (load_session, uri.c_str (), TRUE, FALSE, FALSE);
+    bench_time (run, name, 1, [load_session]()
+    {
+        qof_session_load (load_session, NULL);
+    });
+    if (qof_session_get_error (load_session) != ERR_BACKEND_NO_ERR)
+        g_printerr ("Loading %s failed: %s\n", uri.c_str (),
+                    qof_session_get_error_message (load_session));
+    bench_memory (run, name);
+    qof_session_end (load_session);
+    qof_session_destroy (load_session);
+}
+
+static void
+remove_directory (const gchar *dirname)
+{
+    GDir *dir = g_dir_open (dirname, 0, NULL);
+    if (!dir)
+        return;
+    const gchar *entry;
+    while ((entry = g_dir_read_name (dir)) != NULL)
+    {
+        gchar *path = g_build_filename (dirname, entry, NULL);
+        g_unlink (path);
+        g_free (path);
+    }
+    g_dir_close (dir);
+    g_rmdir (dirname);
+}
+
+/********************************************************************\
+ * Output
+\********************************************************************/
+
+static void
+write_json (FILE *out, const BenchRun& run)
+{
+    fprintf (out, "{\n  \"gnucash_version\": \"%s\",\n", PROJECT_VERSION);
+    fprintf (out, "  \"parameters\": {\"accounts\": %d, \"transactions\": %d, "
+             "\"prices\": %d, \"lookups\": %d, \"seed\": %d},\n",
+             num_accounts, num_transactions, num_prices, num_lookups, seed);
+    fprintf (out, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < run.results.size (); ++i)
+    {
+        auto& r = run.results[i];
+        fprintf (out, "    {\"name\": \"%s\", \"ms\": %.3f, \"ops\": %lu, "
+                 "\"ops_per_sec\": %.1f}%s\n", r.name.c_str (), r.msecs, r.ops,
+                 r.msecs > 0 ? r.ops * 1000.0 / r.msecs : 0.0,
+                 i + 1 < run.results.size () ? "," : "");
+    }
+    fprintf (out, "  ],\n  \"memory\": [\n");
+    for (size_t i = 0; i < run.memory.size (); ++i)
+    {
+        auto& m = run.memory[i];
+        fprintf (out, "    {\"after\": \"%s\", \"rss_kb\": %ld}%s\n",
+                 m.name.c_str (), m.rss_kb,
+                 i + 1 < run.memory.size () ? "," : "");
+    }
+    fprintf (out, "  ],\n  \"peak_rss_kb\": %ld\n}\n", peak_rss_kb ());
+}
+
+int
+main (int argc, char **argv)
+{
+    GError *error = NULL;
+    GOptionContext *context = g_option_context_new ("- time the GnuCash engine");
+    g_option_context_add_main_entries (context, bench_options, NULL);
+    if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+        g_printerr ("%s\n", error->message);
+        g_error_free (error);
+        return 1;
+    }
+    g_option_context_free (context);
+    if (num_accounts < 2 || num_transactions < 0 || num_prices < 0 ||
+        num_lookups < 1)
+    {
+        g_printerr ("Need at least two accounts and one lookup.\n");
+        return 1;
+    }
+
+    g_setenv ("GNC_UNINSTALLED", "1", FALSE);
+#ifdef BENCH_BUILDDIR
+    g_setenv ("GNC_BUILDDIR", BENCH_BUILDDIR, FALSE);
+#endif
+    qof_init ();
+    cashobjects_register ();
+    xaccLogDisable ();
+    gboolean have_xml = qof_load_backend_library ("", "gncmod-backend-xml");
+    gboolean have_sql = !skip_sql &&
+        qof_load_backend_library ("", "gncmod-backend-dbi");
+
+    srand (seed);
+    /* Keep the random slots small so that the book's size is governed
+     * by the counts above rather than by the kvp generator. */
+    set_max_kvp_depth (1);
+    set_max_kvp_frame_elements (3);
+
+    BenchRun run;
+    bench_memory (run, "startup");
+
+    QofSession *session = qof_session_new ();
+    QofBook *book = qof_session_get_book (session);
+    std::vector<Account*> accounts;
+    bench_time (run, "generate_accounts", num_accounts, [&]()
+    {
+        accounts = generate_accounts (book, num_accounts);
+    });
+    bench_time (run, "generate_transactions", num_transactions, [book]()
+    {
+        add_random_transactions_to_book (book, num_transactions);
+    });
+    bench_time (run, "generate_prices", num_prices, [book]()
+    {
+        generate_prices (book, num_prices);
+    });
+    bench_memory (run, "generate");
+
+    bench_recompute_balances (run, accounts);
+    bench_numeric (run, accounts);
+    bench_split_queries (run, book, accounts);
+    bench_price_lookups (run, book);
+    bench_import_matching (run, accounts);
+    bench_scrub (run, book);
+    bench_dates (run, accounts);
+
+    gchar *tmpdir = g_dir_make_tmp ("gnucash-bench-XXXXXX", &error);
+    if (!tmpdir)
+    {
+        g_printerr ("%s\n", error->message);
+        g_error_free (error);
+    }
+    else
+    {
+        if (have_xml)
+        {
+            gchar *path = g_build_filename (tmpdir, "bench.gnucash", NULL);
+            std::string uri = std::string ("xml://") + path;
+            if (bench_save (run, "xml_save", session, uri))
+                bench_load (run, "xml_load", uri);
+            g_free (path);
+        }
+        else
+            g_printerr ("XML backend not found, skipping.\n");
+
+        if (have_sql)
+        {
+            gchar *path = g_build_filename (tmpdir, "bench.sqlite", NULL);
+            std::string uri = std::string ("sqlite3://") + path;
+            if (bench_save (run, "sqlite_save", session, uri))
+                bench_load (run, "sqlite_load", uri);
+            g_free (path);
+        }
+        else if (!skip_sql)
+            g_printerr ("DBI backend not found, skipping.\n");
+
+        bench_translog (run, book, tmpdir);
+
+        remove_directory (tmpdir);
+        g_free (tmpdir);
+    }
+
+    qof_session_end (session);
+    qof_session_destroy (session);
+
+    FILE *out = output_file ? g_fopen (output_file, "w") : stdout;
+    if (!out)
+    {
+        g_printerr ("Unable to write %s\n", output_file);
+        return 1;
+    }
+    write_json (out, run);
+    if (out != stdout)
+        fclose (out);
+
+    qof_close ();
+    return 0;
+}
@@ -456,6 +456,128 @@ TEST(gnc_datetime_functions, test_format_zulu)
     EXPECT_EQ(atime.format_zulu("%d-%m-%Y %H:%M:%S"), "13-11-2045 12:00:00");
 }
 
+/* GncDateFormatter must print exactly what GncDateTime::format does,
+ * including on the days the clocks change.
+ */
+TEST(gnc_date_formatter, test_write_time64)
+{
+#ifdef __MINGW32__
+    TimeZoneProvider tzp{"GMT Standard Time"};
+#else
+    TimeZoneProvider tzp("Europe/London");
+#endif
+    _set_tzp(tzp);
+    const char* formats[] = {"%m/%d/%Y", "%d.%m.%Y", "%Y-%m-%dT%H:%M:%SZ",
+                             "%y %H%M%S", "%d %b %Y"};
+    for (auto format : formats)
+    {
+        GncDateFormatter formatter(format);
+        char buf[64];
+        // 2018-03-24 to 2018-03-27, across the start of BST, then 2018
+        // in uneven steps.
+        for (time64 time = 1521849600; time < 1522108800; time += 1799)
+        {
+            EXPECT_EQ(GncDateTime(time).format(format).length(),
+                      formatter.write(buf, sizeof(buf), time));
+            EXPECT_EQ(GncDateTime(time).format(format), buf);
+        }
+        for (time64 time = 1514764800; time < 1546300800; time += 86399 * 3)
+        {
+            formatter.write(buf, sizeof(buf), time);
+            EXPECT_EQ(GncDateTime(time).format(format), buf);
+        }
+    }
+    _reset_tzp();
+}
+
+TEST(gnc_date_formatter, test_write_ymd)
+{
+    GncDateFormatter formatter("%d.%m.%Y");
+    char buf[64];
+    EXPECT_EQ(10u, formatter.write(buf, sizeof(buf), 2045, 11, 3));
+    EXPECT_STREQ("03.11.2045", buf);
+    EXPECT_EQ(10u, formatter.write(buf, sizeof(buf), 1400, 2, 28));
+    EXPECT_STREQ("28.02.1400", buf);
+    EXPECT_THROW(formatter.write(buf, sizeof(buf), 2019, 2, 29),
+                 std::out_of_range);
+    EXPECT_THROW(formatter.write(buf, sizeof(buf), 2019, 13, 1),
+                 std::out_of_range);
+    GncDateFormatter text_formatter("%d %b %Y");
+    text_formatter.write(buf, sizeof(buf), 2045, 11, 3);
+    EXPECT_EQ(GncDate(2045, 11, 3).format("%d %b %Y"), buf);
+}
+
+TEST(gnc_date_formatter, test_write_truncates)
+{
+    GncDateFormatter formatter("%Y-%m-%d");
+    char buf[8];
+    EXPECT_EQ(7u, formatter.write(buf, sizeof(buf), 2045, 11, 13));
+    EXPECT_STREQ("2045-11", buf);
+    EXPECT_EQ(7u, formatter.write(buf, sizeof(buf), 2394187200));
+    EXPECT_EQ(0u, formatter.write(buf, 0, 2394187200));
+}
+
+/* The offset table shortcuts have to give what going through a
+ * GncDateTime and a struct tm does, and keep out of the days the clocks
+ * change.
+ */
+TEST(gnc_datetime_functions, test_local_tm)
+{
+#ifdef __MINGW32__
+    TimeZoneProvider tzp{"GMT Standard Time"};
+#else
+    TimeZoneProvider tzp("Europe/London");
+#endif
+    _set_tzp(tzp);
+    // 2018 in uneven steps.
+    for (time64 time = 1514764800; time < 1546300800; time += 3599 * 7)
+    {
+        struct tm tm, expected = static_cast<struct tm>(GncDateTime(time));
+        ASSERT_TRUE(GncDateTime::local_tm(time, tm));
+        EXPECT_EQ(expected.tm_year, tm.tm_year);
+        EXPECT_EQ(expected.tm_yday, tm.tm_yday);
+        EXPECT_EQ(expected.tm_mon, tm.tm_mon);
+        EXPECT_EQ(expected.tm_mday, tm.tm_mday);
+        EXPECT_EQ(expected.tm_wday, tm.tm_wday);
+        EXPECT_EQ(expected.tm_hour, tm.tm_hour);
+        EXPECT_EQ(expected.tm_min, tm.tm_min);
+        EXPECT_EQ(expected.tm_sec, tm.tm_sec);
+        EXPECT_EQ(expected.tm_isdst, tm.tm_isdst);
+    }
+    struct tm tm;
+    EXPECT_FALSE(GncDateTime::local_tm(INT64_C(-5000000000), tm)); // 1811
+    _reset_tzp();
+}
+
+TEST(gnc_datetime_functions, test_local_day_time)
+{
+#ifdef __MINGW32__
+    TimeZoneProvider tzp{"GMT Standard Time"};
+#else
+    TimeZoneProvider tzp("Europe/London");
+#endif
+    _set_tzp(tzp);
+    const int times_of_day[] = {0, 10 * 3600 + 59 * 60, 12 * 3600, 86399};
+    for (time64 time = 1514764800; time < 1546300800; time += 3599 * 7)
+        for (auto secs : times_of_day)
+        {
+            time64 result;
+            if (!GncDateTime::local_day_time(time, secs, result))
+                continue;
+            auto tm = static_cast<struct tm>(GncDateTime(time));
+            tm.tm_hour = secs / 3600;
+            tm.tm_min = secs / 60 % 60;
+            tm.tm_sec = secs % 60;
+            EXPECT_EQ(static_cast<time64>(GncDateTime(tm)), result);
+        }
+    time64 result;
+    EXPECT_TRUE(GncDateTime::local_day_time(1529323200, 0, result)); // 2018-06-18
+    EXPECT_EQ(1529276400, result);
+    EXPECT_FALSE(GncDateTime::local_day_time(1521979200, 0, result)); // 2018-03-25
+    EXPECT_FALSE(GncDateTime::local_day_time(1546257600, 0, result)); // 2018-12-31
+    _reset_tzp();
+}
+
 //This is a bit convoluted because it uses GncDate's GncDateImpl constructor and year_month_day() function. There's no good way to test the former without violating the privacy of the implementation.
 TEST(gnc_datetime_functions, test_date)
 {
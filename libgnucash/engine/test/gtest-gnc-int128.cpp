@@ -558,6 +558,43 @@ TEST(GncInt128_functions, divide)
       });
 }
 
+TEST(GncInt128_functions, divide_multi_leg)
+{
+    GncInt128 q, r;
+    EXPECT_NO_THROW({
+            GncInt128 a (INT64_C(3261945064460410), UINT64_C(974930645877800280));
+            GncInt128 b (INT64_C(62520653286), UINT64_C(8673833304637980263));
+            a.div (b, q, r);
+            EXPECT_EQ (52173, q);
+            EXPECT_EQ (a - b * GncInt128(52173), r);
+            (-a).div (-b, q, r);
+            EXPECT_EQ (52173, q);
+            EXPECT_EQ (b * GncInt128(52173) - a, r);
+            /* A normalized divisor leg of all ones. */
+            GncInt128 two64 (INT64_C(1), UINT64_C(0));
+            GncInt128 max64 (UINT64_MAX);
+            two64.div (max64, q, r);
+            EXPECT_EQ (1, q);
+            EXPECT_EQ (1, r);
+        });
+}
+
+TEST(GncInt128_functions, multiply_carries)
+{
+    GncInt128 a (UINT64_C(18392353440314758058));
+    GncInt128 b (INT64_C(732085610861506427));
+    EXPECT_EQ (GncInt128(INT64_C(729927040226229848),
+                         UINT64_C(2695761051681204398)), a * b);
+    EXPECT_EQ (GncInt128(INT64_C(-729927040226229848),
+                         UINT64_C(2695761051681204398)), a * -b);
+    GncInt128 c (INT64_C(1), UINT64_C(18191880963390814932));
+    GncInt128 d (INT64_C(895829860285122312));
+    auto p = c * d;
+    EXPECT_FALSE (p.isOverflow());
+    EXPECT_EQ (c, p / d);
+    EXPECT_EQ (0, p % d);
+}
+
 TEST(GncInt128_functions, GCD)
 {
     int64_t barg {INT64_C(4878849681579065407)};
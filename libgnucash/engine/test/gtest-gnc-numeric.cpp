@@ -21,6 +21,7 @@
 \********************************************************************/
 
 #include <gtest/gtest.h>
+#include <vector>
 #include "../gnc-numeric.hpp"
 #include "../gnc-rational.hpp"
 
@@ -549,3 +550,97 @@ TEST(gnc_numeric_functions, test_conversion_to_decimal)
     EXPECT_EQ(27434842, r.num());
     EXPECT_EQ(100, r.denom());
 }
+
+TEST(gnc_numeric_functions, test_same_denom_add_sub)
+{
+    auto how = GNC_HOW_DENOM_FIXED | GNC_HOW_RND_NEVER;
+    gnc_numeric a = gnc_numeric_create(12345, 100);
+    gnc_numeric b = gnc_numeric_create(-2345, 100);
+    gnc_numeric r = gnc_numeric_add_fixed(a, b);
+    EXPECT_EQ(10000, r.num);
+    EXPECT_EQ(100, r.denom);
+    r = gnc_numeric_sub_fixed(a, b);
+    EXPECT_EQ(14690, r.num);
+    EXPECT_EQ(100, r.denom);
+    /* Not reduced, same as the general path. */
+    EXPECT_TRUE(gnc_numeric_eq(gnc_numeric_add_fixed(a, b),
+                               gnc_numeric_add(a, b, GNC_DENOM_AUTO, how)));
+    EXPECT_TRUE(gnc_numeric_eq(gnc_numeric_create(10000, 100),
+                               gnc_numeric_add(a, b, GNC_DENOM_AUTO,
+                                               GNC_HOW_DENOM_LCD)));
+    EXPECT_TRUE(gnc_numeric_eq(gnc_numeric_create(100, 1),
+                               gnc_numeric_add(a, b, GNC_DENOM_AUTO,
+                                               GNC_HOW_DENOM_REDUCE)));
+
+    /* Sums that don't fit are left to the general path, which rounds
+     * them, rather than wrapping around. */
+    gnc_numeric big = gnc_numeric_create(INT64_MAX - 5, 100);
+    r = gnc_numeric_add_fixed(big, gnc_numeric_create(10, 100));
+    EXPECT_TRUE(gnc_numeric_positive_p(r));
+    EXPECT_LT(r.denom, 100);
+    r = gnc_numeric_sub_fixed(gnc_numeric_neg(big), gnc_numeric_create(10, 100));
+    EXPECT_TRUE(gnc_numeric_negative_p(r));
+    EXPECT_LT(r.denom, 100);
+
+    gnc_numeric err = gnc_numeric_error(GNC_ERROR_ARG);
+    EXPECT_EQ(GNC_ERROR_ARG, gnc_numeric_check(gnc_numeric_add_fixed(err, err)));
+    EXPECT_EQ(GNC_ERROR_OVERFLOW,
+              gnc_numeric_check(gnc_numeric_neg(gnc_numeric_create(INT64_MIN, 1))));
+
+    /* Mixed denominators still take the general path. */
+    r = gnc_numeric_add_fixed(gnc_numeric_create(1, 2), gnc_numeric_create(1, 4));
+    EXPECT_EQ(3, r.num);
+    EXPECT_EQ(4, r.denom);
+}
+
+TEST(gnc_numeric_functions, test_compare)
+{
+    EXPECT_EQ(0, gnc_numeric_compare(gnc_numeric_create(5, 100),
+                                     gnc_numeric_create(5, 100)));
+    EXPECT_EQ(1, gnc_numeric_compare(gnc_numeric_create(6, 100),
+                                     gnc_numeric_create(5, 100)));
+    EXPECT_EQ(-1, gnc_numeric_compare(gnc_numeric_create(-6, 100),
+                                      gnc_numeric_create(5, 100)));
+    EXPECT_EQ(0, gnc_numeric_compare(gnc_numeric_create(1, 2),
+                                     gnc_numeric_create(50, 100)));
+    EXPECT_EQ(0, gnc_numeric_compare(gnc_numeric_error(GNC_ERROR_ARG),
+                                     gnc_numeric_error(GNC_ERROR_OVERFLOW)));
+}
+
+TEST(gnc_numeric_functions, test_sum)
+{
+    std::vector<gnc_numeric> values;
+    EXPECT_TRUE(gnc_numeric_zero_p(gnc_numeric_sum(nullptr, 0)));
+    for (int64_t i = -1000; i < 5000; ++i)
+        values.push_back(gnc_numeric_create(i * 7919, 100));
+    auto one_by_one = gnc_numeric_zero();
+    for (auto v : values)
+        one_by_one = gnc_numeric_add_fixed(one_by_one, v);
+    auto sum = gnc_numeric_sum(values.data(), values.size());
+    EXPECT_TRUE(gnc_numeric_eq(one_by_one, sum));
+
+    /* Mixed denominators give the same value as adding one at a time. */
+    values.push_back(gnc_numeric_create(1, 3));
+    values.push_back(gnc_numeric_create(-5, 100));
+    values.push_back(gnc_numeric_create(2, 3));
+    one_by_one = gnc_numeric_zero();
+    for (auto v : values)
+        one_by_one = gnc_numeric_add_fixed(one_by_one, v);
+    sum = gnc_numeric_sum(values.data(), values.size());
+    EXPECT_TRUE(gnc_numeric_equal(one_by_one, sum));
+    EXPECT_EQ(300, sum.denom);
+
+    /* Running totals that don't fit in 64 bits still sum exactly. */
+    gnc_numeric big[] = {gnc_numeric_create(INT64_MAX, 100),
+                         gnc_numeric_create(INT64_MAX, 100),
+                         gnc_numeric_create(INT64_MIN, 100),
+                         gnc_numeric_create(INT64_MIN, 100),
+                         gnc_numeric_create(5, 100)};
+    sum = gnc_numeric_sum(big, 5);
+    EXPECT_EQ(3, sum.num);
+    EXPECT_EQ(100, sum.denom);
+
+    gnc_numeric bad[] = {gnc_numeric_create(5, 100),
+                         gnc_numeric_error(GNC_ERROR_OVERFLOW)};
+    EXPECT_NE(GNC_ERROR_OK, gnc_numeric_check(gnc_numeric_sum(bad, 2)));
+}
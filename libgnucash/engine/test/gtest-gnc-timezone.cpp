@@ -298,3 +298,62 @@ TEST(gnc_timezone_constructors, test_bogus_time_constructor)
 	      tzp.get(2006)->std_zone_abbrev());
 #endif
 }
+
+/* The offset table has to agree with what GncDateTime gets from the
+ * zone rules, at the transitions and everywhere else. */
+static long
+offset_from_rules(const TimeZoneProvider& tzp, int64_t time)
+{
+    using boost::posix_time::ptime;
+    using boost::posix_time::hours;
+    using boost::posix_time::seconds;
+    ptime utc(boost::gregorian::date(1970, 1, 1),
+              hours(time / 3600) + seconds(time % 3600));
+    boost::local_time::local_date_time ldt(utc, tzp.get(utc.date().year()));
+    return (ldt.local_time() - utc).total_seconds();
+}
+
+TEST(gnc_timezone_offsets, test_offset_table)
+{
+#if PLATFORM(WINDOWS)
+    const char* zones[] = {"Pacific Standard Time", "AUS Eastern Standard Time",
+                           "GMT Standard Time"};
+#else
+    const char* zones[] = {"America/Los_Angeles", "Australia/Sydney",
+                           "Europe/Minsk", "Europe/London",
+                           "EST5EDT,M3.2.0,M11.1.0"};
+#endif
+    for (auto name : zones)
+    {
+        TimeZoneProvider tzp(name);
+        TZ_Span span;
+        // 1900-01-01 to 2199-12-31 in steps of a bit over 13 hours.
+        for (int64_t time = -2208988800; time < 7258032000; time += 47513)
+        {
+            ASSERT_TRUE(tzp.get_span(time, span));
+            EXPECT_LE(span.start, time);
+            EXPECT_GT(span.end, time);
+            EXPECT_EQ(offset_from_rules(tzp, time), span.offset) << name << " " << time;
+            EXPECT_EQ(offset_from_rules(tzp, span.start), span.offset) << name;
+            EXPECT_EQ(offset_from_rules(tzp, span.end - 1), span.offset) << name;
+            time = std::max(time, span.end - 47513 / 2);
+        }
+    }
+}
+
+TEST(gnc_timezone_offsets, test_outside_table)
+{
+#if PLATFORM(WINDOWS)
+    TimeZoneProvider tzp("Pacific Standard Time");
+#else
+    TimeZoneProvider tzp("America/Los_Angeles");
+#endif
+    TZ_Span span;
+    EXPECT_FALSE(tzp.get_span(-2208988801, span)); // 1899-12-31 23:59:59
+    EXPECT_FALSE(tzp.get_span(7258118400, span));  // 2200-01-01
+    EXPECT_EQ(offset_from_rules(tzp, -2208988801), tzp.get_utc_offset(-2208988801));
+    EXPECT_EQ(offset_from_rules(tzp, 7258118400 + 180 * 86400),
+              tzp.get_utc_offset(7258118400 + 180 * 86400));
+    EXPECT_THROW(tzp.get_utc_offset(INT64_C(253402300800) + 86400),
+                 std::invalid_argument);
+}
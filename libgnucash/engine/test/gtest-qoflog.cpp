@@ -0,0 +1,148 @@
+/********************************************************************\
+ * gtest-qoflog.cpp -- Unit tests for the qoflog tracing spans      *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+ \ *********************************************************************/
+
+#include <config.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include "../qoflog.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+static QofLogModule log_module = "qof.test";
+
+class QofTraceTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        qof_trace_clear ();
+        m_filename = g_build_filename (g_get_tmp_dir (),
+                                       "gtest-qoflog-trace.json", nullptr);
+    }
+    void TearDown() override
+    {
+        qof_trace_enable (FALSE);
+        g_unlink (m_filename);
+        g_free (m_filename);
+    }
+    std::string dump ()
+    {
+        gchar *contents = nullptr;
+        EXPECT_TRUE (qof_trace_dump (m_filename));
+        EXPECT_TRUE (g_file_get_contents (m_filename, &contents, nullptr, nullptr));
+        std::string retval{contents ? contents : ""};
+        g_free (contents);
+        return retval;
+    }
+    gchar *m_filename;
+};
+
+static size_t
+count_of (const std::string& haystack, const std::string& needle)
+{
+    size_t count = 0;
+    for (auto pos = haystack.find (needle); pos != std::string::npos;
+         pos = haystack.find (needle, pos + needle.size ()))
+        ++count;
+    return count;
+}
+
+static unsigned long
+tid_of (const std::string& trace, const std::string& span)
+{
+    static const std::string tid_key{"\"tid\":"};
+    auto pos = trace.find (tid_key, trace.find (span));
+    return std::stoul (trace.substr (pos + tid_key.size ()));
+}
+
+TEST_F(QofTraceTest, disabled_records_nothing)
+{
+    qof_trace_enable (FALSE);
+    EXPECT_EQ (0, qof_trace_begin ());
+    {
+        QOF_TRACE_SPAN ("disabled-span");
+    }
+    EXPECT_EQ (std::string::npos, dump ().find ("disabled-span"));
+}
+
+TEST_F(QofTraceTest, spans_from_threads)
+{
+    qof_trace_enable (TRUE);
+    EXPECT_TRUE (qof_trace_is_enabled ());
+    {
+        QOF_TRACE_SPAN ("main-span");
+        std::thread worker ([]() { QOF_TRACE_SPAN ("worker-span"); });
+        worker.join ();
+    }
+    auto trace = dump ();
+    EXPECT_EQ (0u, trace.find ("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    EXPECT_EQ (1u, count_of (trace, "\"name\":\"main-span\",\"cat\":\"qof.test\""));
+    EXPECT_EQ (1u, count_of (trace, "\"name\":\"worker-span\",\"cat\":\"qof.test\""));
+    EXPECT_NE (tid_of (trace, "main-span"), tid_of (trace, "worker-span"));
+}
+
+TEST_F(QofTraceTest, nested_spans)
+{
+    qof_trace_enable (TRUE);
+    auto outer = qof_trace_begin ();
+    auto inner = qof_trace_begin ();
+    EXPECT_LE (outer, inner);
+    qof_trace_end (log_module, "inner", inner);
+    qof_trace_end (log_module, "outer", outer);
+    auto trace = dump ();
+    /* Spans are written in the order they finish. */
+    EXPECT_LT (trace.find ("\"inner\""), trace.find ("\"outer\""));
+}
+
+TEST_F(QofTraceTest, ring_buffer_keeps_latest)
+{
+    qof_trace_enable (TRUE);
+    const int total = 70000;
+    for (int i = 0; i < total; ++i)
+        qof_trace_end (log_module, i < 10 ? "early" : "late",
+                       qof_trace_begin ());
+    auto trace = dump ();
+    EXPECT_EQ (0u, count_of (trace, "\"early\""));
+    EXPECT_EQ (65536u, count_of (trace, "\"late\""));
+}
+
+TEST_F(QofTraceTest, disabling_discards_spans)
+{
+    qof_trace_enable (TRUE);
+    std::thread worker ([]() { QOF_TRACE_SPAN ("worker-span"); });
+    worker.join ();
+    {
+        QOF_TRACE_SPAN ("main-span");
+    }
+    qof_trace_enable (FALSE);
+    qof_trace_enable (TRUE);
+    {
+        QOF_TRACE_SPAN ("later-span");
+    }
+    auto trace = dump ();
+    EXPECT_EQ (std::string::npos, trace.find ("worker-span"));
+    EXPECT_EQ (std::string::npos, trace.find ("main-span"));
+    EXPECT_EQ (1u, count_of (trace, "\"later-span\""));
+    /* The exited worker's buffer is gone altogether. */
+    EXPECT_EQ (1u, count_of (trace, "\"thread_name\""));
+}
@@ -0,0 +1,201 @@
+/********************************************************************\
+ * gtest-split-table.cpp -- Unit tests for GncSplitTable            *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ *                                                                  *
+\********************************************************************/
+
+extern "C"
+{
+#include <config.h>
+#include "../Account.h"
+#include "../Split.h"
+#include "../Transaction.h"
+#include "../gnc-commodity.h"
+#include "../gnc-date.h"
+#include "../gnc-split-table.h"
+#include <qof.h>
+}
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+class SplitTableTest : public testing::Test
+{
+protected:
+    void SetUp()
+    {
+        m_book = qof_book_new ();
+        auto root = gnc_account_create_root (m_book);
+        m_currency = gnc_commodity_new (m_book, "US Dollar", "CURRENCY",
+                                        "USD", "", 100);
+        m_bank = make_account (root, "Bank");
+        m_food = make_account (root, "Food");
+        m_rent = make_account (root, "Rent");
+
+        add_trans (15, 1, "Groceries", m_food, 3000);
+        add_trans (1, 2, "Rent Feb", m_rent, 50000);
+        add_trans (3, 1, "Rent Jan", m_rent, 50000);
+        add_trans (20, 2, "Bakery", m_food, 500);
+    }
+    void TearDown()
+    {
+        g_list_free (m_splits);
+        auto root = gnc_book_get_root_account (m_book);
+        xaccAccountBeginEdit (root);
+        xaccAccountDestroy (root);
+        qof_book_destroy (m_book);
+    }
+    Account *make_account (Account *parent, const char *name)
+    {
+        auto acc = xaccMallocAccount (m_book);
+        xaccAccountBeginEdit (acc);
+        xaccAccountSetName (acc, name);
+        xaccAccountSetCommodity (acc, m_currency);
+        xaccAccountCommitEdit (acc);
+        gnc_account_append_child (parent, acc);
+        return acc;
+    }
+    /* Pay @a cents out of the bank into @a expense. Only the expense
+     * split goes into the table. */
+    void add_trans (int day, int month, const char *desc, Account *expense,
+                    gint64 cents)
+    {
+        auto trans = xaccMallocTransaction (m_book);
+        auto value = gnc_numeric_create (cents, 100);
+        xaccTransBeginEdit (trans);
+        xaccTransSetCurrency (trans, m_currency);
+        xaccTransSetDatePostedSecsNormalized (trans, gnc_dmy2time64 (day, month, 2019));
+        xaccTransSetDescription (trans, desc);
+        auto from = xaccMallocSplit (m_book);
+        xaccSplitSetParent (from, trans);
+        xaccSplitSetAccount (from, m_bank);
+        xaccSplitSetValue (from, gnc_numeric_neg (value));
+        xaccSplitSetAmount (from, gnc_numeric_neg (value));
+        auto to = xaccMallocSplit (m_book);
+        xaccSplitSetParent (to, trans);
+        xaccSplitSetAccount (to, expense);
+        xaccSplitSetValue (to, value);
+        xaccSplitSetAmount (to, value);
+        xaccTransCommitEdit (trans);
+        m_splits = g_list_append (m_splits, to);
+    }
+    std::vector<std::string> descriptions (GncSplitTable *table)
+    {
+        std::vector<std::string> retval;
+        for (guint row = 0; row < gnc_split_table_get_num_rows (table); ++row)
+        {
+            auto split = gnc_split_table_get_split (table, row);
+            retval.emplace_back (xaccTransGetDescription (xaccSplitGetParent (split)));
+        }
+        return retval;
+    }
+    QofBook *m_book;
+    gnc_commodity *m_currency;
+    Account *m_bank, *m_food, *m_rent;
+    GList *m_splits = nullptr;
+};
+
+TEST_F(SplitTableTest, unsorted_keeps_list_order)
+{
+    auto table = gnc_split_table_new (m_splits);
+    EXPECT_EQ (4u, gnc_split_table_get_num_rows (table));
+    GncSplitSortKey key{GNC_SPLIT_COLUMN_NONE, GNC_DATE_BUCKET_EXACT, TRUE};
+    gnc_split_table_sort (table, &key, 1);
+    auto splits = gnc_split_table_get_splits (table);
+    auto node = splits;
+    for (auto orig = m_splits; orig; orig = orig->next, node = node->next)
+        EXPECT_EQ (orig->data, node->data);
+    EXPECT_EQ (nullptr, node);
+    EXPECT_EQ (0u, gnc_split_table_get_group (table, 3, 0));
+    g_list_free (splits);
+    gnc_split_table_destroy (table);
+}
+
+TEST_F(SplitTableTest, single_key)
+{
+    auto table = gnc_split_table_new (m_splits);
+    GncSplitSortKey key{GNC_SPLIT_COLUMN_DESCRIPTION, GNC_DATE_BUCKET_EXACT, TRUE};
+    gnc_split_table_sort (table, &key, 1);
+    EXPECT_EQ ((std::vector<std::string>{"Bakery", "Groceries", "Rent Feb", "Rent Jan"}),
+               descriptions (table));
+    key.ascending = FALSE;
+    gnc_split_table_sort (table, &key, 1);
+    EXPECT_EQ ((std::vector<std::string>{"Rent Jan", "Rent Feb", "Groceries", "Bakery"}),
+               descriptions (table));
+    key = {GNC_SPLIT_COLUMN_DATE_POSTED, GNC_DATE_BUCKET_EXACT, TRUE};
+    gnc_split_table_sort (table, &key, 1);
+    EXPECT_EQ ((std::vector<std::string>{"Rent Jan", "Groceries", "Rent Feb", "Bakery"}),
+               descriptions (table));
+    gnc_split_table_destroy (table);
+}
+
+TEST_F(SplitTableTest, multi_key_groups)
+{
+    auto table = gnc_split_table_new (m_splits);
+    GncSplitSortKey keys[] = {
+        {GNC_SPLIT_COLUMN_ACCOUNT_NAME, GNC_DATE_BUCKET_EXACT, TRUE},
+        {GNC_SPLIT_COLUMN_VALUE, GNC_DATE_BUCKET_EXACT, FALSE},
+    };
+    gnc_split_table_sort (table, keys, 2);
+    EXPECT_EQ ((std::vector<std::string>{"Groceries", "Bakery", "Rent Feb", "Rent Jan"}),
+               descriptions (table));
+    std::vector<guint> accounts, values;
+    for (guint row = 0; row < 4; ++row)
+    {
+        accounts.push_back (gnc_split_table_get_group (table, row, 0));
+        values.push_back (gnc_split_table_get_group (table, row, 1));
+    }
+    EXPECT_EQ ((std::vector<guint>{0, 0, 1, 1}), accounts);
+    /* The rent payments have equal values and keep their list order. */
+    EXPECT_EQ ((std::vector<guint>{0, 1, 2, 2}), values);
+    gnc_split_table_destroy (table);
+}
+
+TEST_F(SplitTableTest, date_buckets)
+{
+    auto table = gnc_split_table_new (m_splits);
+    GncSplitSortKey keys[] = {
+        {GNC_SPLIT_COLUMN_DATE_POSTED, GNC_DATE_BUCKET_MONTH, FALSE},
+        {GNC_SPLIT_COLUMN_DESCRIPTION, GNC_DATE_BUCKET_EXACT, TRUE},
+    };
+    gnc_split_table_sort (table, keys, 2);
+    EXPECT_EQ ((std::vector<std::string>{"Bakery", "Rent Feb", "Groceries", "Rent Jan"}),
+               descriptions (table));
+    EXPECT_EQ (0u, gnc_split_table_get_group (table, 1, 0));
+    EXPECT_EQ (1u, gnc_split_table_get_group (table, 2, 0));
+    EXPECT_EQ (3u, gnc_split_table_get_group (table, 3, 1));
+    keys[0].bucket = GNC_DATE_BUCKET_YEAR;
+    gnc_split_table_sort (table, keys, 2);
+    EXPECT_EQ ((std::vector<std::string>{"Bakery", "Groceries", "Rent Feb", "Rent Jan"}),
+               descriptions (table));
+    EXPECT_EQ (0u, gnc_split_table_get_group (table, 3, 0));
+    gnc_split_table_destroy (table);
+}
+
+TEST_F(SplitTableTest, totals)
+{
+    auto table = gnc_split_table_new (m_splits);
+    auto total = gnc_split_table_get_total (table, GNC_SPLIT_COLUMN_VALUE);
+    EXPECT_EQ (103500, total.num);
+    EXPECT_EQ (100, total.denom);
+    total = gnc_split_table_get_total (table, GNC_SPLIT_COLUMN_AMOUNT);
+    EXPECT_EQ (103500, total.num);
+    gnc_split_table_destroy (table);
+}
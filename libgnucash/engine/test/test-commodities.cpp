@@ -126,7 +126,46 @@ test_commodity(void)
                                  cusip, fraction);
         do_test(
             gnc_commodity_equiv(com, com2), "commodity equiv");
+        do_test(
+            gnc_commodity_get_key(com) == gnc_commodity_get_key(com2),
+            "equivalent commodities have equal keys");
+
+        {
+            QofBook *book2 = qof_book_new ();
+            gnc_commodity *com3 = gnc_commodity_new(book2, fullname, name_space,
+                                                    mnemonic, cusip, fraction);
+            do_test(
+                gnc_commodity_get_key(com) == gnc_commodity_get_key(com3),
+                "keys are the same in another book");
+            do_test(
+                gnc_commodity_equal(com2, com3), "commodity equal across books");
+            gnc_commodity_set_mnemonic(com3, "XXX-not-random");
+            do_test(
+                gnc_commodity_get_key(com) != gnc_commodity_get_key(com3),
+                "key follows the mnemonic");
+            do_test(
+                !gnc_commodity_equal(com2, com3), "changed commodity not equal");
+            qof_book_destroy (book2);
+        }
+
+        qof_book_destroy (book);
+    }
 
+    {
+        QofBook *book = qof_book_new ();
+        gnc_commodity_table *tbl = gnc_commodity_table_get_table (book);
+        gnc_commodity *rub = gnc_commodity_new(book, "Russian Ruble",
+                                               GNC_COMMODITY_NS_CURRENCY,
+                                               "RUB", "643", 100);
+        gnc_commodity_table_insert (tbl, rub);
+        do_test(
+            gnc_commodity_table_lookup (tbl, GNC_COMMODITY_NS_CURRENCY,
+                                        "RUR") == rub,
+            "retired ISO code finds the new currency");
+        do_test(
+            gnc_commodity_table_lookup (tbl, GNC_COMMODITY_NS_CURRENCY,
+                                        "RUB") == rub,
+            "current ISO code finds the currency");
         qof_book_destroy (book);
     }
 
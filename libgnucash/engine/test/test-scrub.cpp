@@ -0,0 +1,208 @@
+/***************************************************************************
+ *            test-scrub.cpp
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301, USA.
+ */
+/**
+ * @file test-scrub.cpp
+ * @brief Check that xaccAccountTreeScrub repairs what the separate
+ * orphan and imbalance scrubs repair.
+ */
+
+extern "C"
+{
+#include <config.h>
+#include <glib.h>
+#include "qof.h"
+#include "Account.h"
+#include "Scrub.h"
+#include "cashobjects.h"
+#include "test-stuff.h"
+#include "Transaction.h"
+#include "TransactionP.h"
+}
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+struct TestSplit
+{
+    int account;            /* Index into the accounts, -1 for none. */
+    gint64 value;
+    gint64 amount;
+};
+
+struct TestTrans
+{
+    const char *desc;
+    std::vector<TestSplit> splits;
+};
+
+static const char *account_names[] = { "Bank", "Groceries", "Rent" };
+
+static const std::vector<TestTrans> test_transactions =
+{
+    { "Balanced", { {0, -1000, -1000}, {1, 1000, 1000} } },
+    { "Orphan", { {0, -2000, -2000}, {-1, 2000, 2000} } },
+    { "Imbalance", { {0, -3000, -3000}, {2, 2500, 2500} } },
+    { "Orphan and imbalance", { {0, -4000, -4000}, {-1, 3500, 3500} } },
+    { "Amount isn't value", { {0, -5000, -4500}, {1, 5000, 5000} } },
+    { "One split", { {2, 6000, 6000} } },
+};
+
+static Account *
+build_book (QofBook *book)
+{
+    auto table = gnc_commodity_table_get_table (book);
+    auto usd = gnc_commodity_table_lookup (table, GNC_COMMODITY_NS_CURRENCY,
+                                           "USD");
+    auto root = gnc_book_get_root_account (book);
+    std::vector<Account*> accounts;
+
+    for (auto name : account_names)
+    {
+        auto acc = xaccMallocAccount (book);
+        xaccAccountBeginEdit (acc);
+        xaccAccountSetName (acc, name);
+        xaccAccountSetType (acc, ACCT_TYPE_BANK);
+        xaccAccountSetCommodity (acc, usd);
+        xaccAccountCommitEdit (acc);
+        gnc_account_append_child (root, acc);
+        accounts.push_back (acc);
+    }
+
+    /* Keep the commits from repairing the transactions right away. */
+    xaccDisableDataScrubbing ();
+    for (auto& tt : test_transactions)
+    {
+        auto trans = xaccMallocTransaction (book);
+        xaccTransBeginEdit (trans);
+        xaccTransSetCurrency (trans, usd);
+        xaccTransSetDescription (trans, tt.desc);
+        xaccTransSetDatePostedSecsNormalized (trans,
+                                              gnc_dmy2time64 (1, 3, 2019));
+        for (auto& ts : tt.splits)
+        {
+            auto split = xaccMallocSplit (book);
+            xaccSplitSetParent (split, trans);
+            if (ts.account >= 0)
+                xaccSplitSetAccount (split, accounts[ts.account]);
+            xaccSplitSetValue (split, gnc_numeric_create (ts.value, 100));
+            xaccSplitSetAmount (split, gnc_numeric_create (ts.amount, 100));
+        }
+        xaccTransCommitEdit (trans);
+    }
+    xaccEnableDataScrubbing ();
+    return root;
+}
+
+/* Every account with its balance and split count, and every transaction
+ * with its splits, by name so that two books can be compared. */
+static std::vector<std::string>
+describe_book (Account *root)
+{
+    std::vector<std::string> lines;
+    auto accounts = gnc_account_get_descendants (root);
+
+    for (auto node = accounts; node; node = node->next)
+    {
+        auto acc = static_cast<Account*>(node->data);
+        auto name = gnc_account_get_full_name (acc);
+        auto balance = gnc_numeric_to_string (xaccAccountGetBalance (acc));
+        lines.push_back (std::string ("account ") + name + " " + balance +
+                         " " + std::to_string (g_list_length (xaccAccountGetSplitList (acc))));
+        g_free (balance);
+        g_free (name);
+
+        for (auto snode = xaccAccountGetSplitList (acc); snode;
+             snode = snode->next)
+        {
+            auto split = static_cast<Split*>(snode->data);
+            auto value = gnc_numeric_to_string (xaccSplitGetValue (split));
+            auto amount = gnc_numeric_to_string (xaccSplitGetAmount (split));
+            lines.push_back (std::string ("split ") +
+                             xaccTransGetDescription (xaccSplitGetParent (split)) +
+                             " " + xaccAccountGetName (acc) + " " + value +
+                             " " + amount);
+            g_free (value);
+            g_free (amount);
+        }
+    }
+    g_list_free (accounts);
+    std::sort (lines.begin (), lines.end ());
+    return lines;
+}
+
+static bool
+all_splits_have_accounts (QofBook *book)
+{
+    auto result = true;
+    auto col = qof_book_get_collection (book, GNC_ID_SPLIT);
+    qof_collection_foreach (col, [](QofInstance *inst, gpointer data)
+                            {
+                                if (!xaccSplitGetAccount (GNC_SPLIT (inst)))
+                                    *static_cast<bool*>(data) = false;
+                            }, &result);
+    return result;
+}
+
+static void
+test_tree_scrub_matches (void)
+{
+    auto old_session = qof_session_new ();
+    auto old_book = qof_session_get_book (old_session);
+    auto old_root = build_book (old_book);
+    auto new_session = qof_session_new ();
+    auto new_book = qof_session_get_book (new_session);
+    auto new_root = build_book (new_book);
+
+    do_test (describe_book (old_root) == describe_book (new_root),
+             "books start out the same");
+    do_test (!all_splits_have_accounts (new_book), "book has orphans");
+
+    xaccAccountTreeScrubOrphans (old_root, NULL);
+    xaccAccountTreeScrubImbalance (old_root, NULL);
+    xaccAccountTreeScrub (new_root, FALSE, NULL);
+
+    do_test (all_splits_have_accounts (new_book), "orphans repaired");
+    do_test (gnc_account_lookup_by_full_name (new_root, "Orphan-USD") != NULL,
+             "orphan account made");
+    do_test (gnc_account_lookup_by_full_name (new_root, "Imbalance-USD") != NULL,
+             "imbalance account made");
+    do_test (describe_book (old_root) == describe_book (new_root),
+             "tree scrub matches orphan and imbalance scrubs");
+
+    qof_session_end (old_session);
+    qof_session_destroy (old_session);
+    qof_session_end (new_session);
+    qof_session_destroy (new_session);
+}
+
+int
+main (int argc, char **argv)
+{
+    qof_init ();
+    if (!cashobjects_register ())
+        exit (1);
+
+    test_tree_scrub_matches ();
+    print_test_results ();
+
+    qof_close ();
+    return get_rv ();
+}
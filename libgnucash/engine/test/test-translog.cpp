@@ -0,0 +1,185 @@
+/***************************************************************************
+ *            test-translog.cpp
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301, USA.
+ */
+/**
+ * @file test-translog.cpp
+ * @brief Check that xaccLogSync leaves every logged transaction in the
+ * log file, in the order they were committed.
+ */
+
+extern "C"
+{
+#include <config.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include "qof.h"
+#include "Account.h"
+#include "TransLog.h"
+#include "cashobjects.h"
+#include "test-stuff.h"
+#include "Transaction.h"
+}
+
+#include <string>
+#include <vector>
+
+static const int num_transactions = 20;
+
+static std::string
+current_log_path (const char *dir)
+{
+    std::string path;
+    auto gdir = g_dir_open (dir, 0, NULL);
+    const char *name;
+
+    if (!gdir)
+        return path;
+    while ((name = g_dir_read_name (gdir)))
+        if (xaccFileIsCurrentLog (name))
+            path = std::string (dir) + G_DIR_SEPARATOR_S + name;
+    g_dir_close (gdir);
+    return path;
+}
+
+/* The descriptions of the committed transactions in the log, once per
+ * transaction rather than once per split. */
+static std::vector<std::string>
+read_commits (const std::string& path)
+{
+    std::vector<std::string> descs;
+    char *contents = NULL;
+
+    if (!g_file_get_contents (path.c_str (), &contents, NULL, NULL))
+        return descs;
+
+    auto lines = g_strsplit (contents, "\n", -1);
+    std::string last_guid;
+    for (auto line = lines; *line; ++line)
+    {
+        if ((*line)[0] != 'C' || (*line)[1] != '\t')
+            continue;
+        auto fields = g_strsplit (*line, "\t", -1);
+        if (g_strv_length (fields) > 9 && last_guid != fields[1])
+        {
+            last_guid = fields[1];
+            descs.push_back (fields[9]);
+        }
+        g_strfreev (fields);
+    }
+    g_strfreev (lines);
+    g_free (contents);
+    return descs;
+}
+
+static void
+test_log_sync (const char *dir)
+{
+    auto session = qof_session_new ();
+    auto book = qof_session_get_book (session);
+    auto table = gnc_commodity_table_get_table (book);
+    auto usd = gnc_commodity_table_lookup (table, GNC_COMMODITY_NS_CURRENCY,
+                                           "USD");
+    auto root = gnc_book_get_root_account (book);
+    Account *accounts[2];
+    std::vector<std::string> expected;
+
+    for (auto i = 0; i < 2; ++i)
+    {
+        accounts[i] = xaccMallocAccount (book);
+        xaccAccountBeginEdit (accounts[i]);
+        xaccAccountSetName (accounts[i], i ? "Expense" : "Bank");
+        xaccAccountSetType (accounts[i], i ? ACCT_TYPE_EXPENSE : ACCT_TYPE_BANK);
+        xaccAccountSetCommodity (accounts[i], usd);
+        xaccAccountCommitEdit (accounts[i]);
+        gnc_account_append_child (root, accounts[i]);
+    }
+
+    /* Don't let the writer flush on its own, so that only xaccLogSync
+     * can have put the records on the disk. */
+    xaccLogSetFlushPolicy (G_MAXINT, G_MAXINT);
+    for (auto i = 0; i < num_transactions; ++i)
+    {
+        auto desc = std::string ("Transaction ") + std::to_string (i);
+        auto trans = xaccMallocTransaction (book);
+        auto value = gnc_numeric_create (100 * (i + 1), 100);
+        xaccTransBeginEdit (trans);
+        xaccTransSetCurrency (trans, usd);
+        xaccTransSetDescription (trans, desc.c_str ());
+        xaccTransSetDatePostedSecsNormalized (trans,
+                                              gnc_dmy2time64 (1, 3, 2019));
+        for (auto acc : accounts)
+        {
+            auto split = xaccMallocSplit (book);
+            xaccSplitSetParent (split, trans);
+            xaccSplitSetAccount (split, acc);
+            xaccSplitSetValue (split, value);
+            xaccSplitSetAmount (split, value);
+            value = gnc_numeric_neg (value);
+        }
+        xaccTransCommitEdit (trans);
+        expected.push_back (desc);
+    }
+
+    xaccLogSync ();
+    auto path = current_log_path (dir);
+    do_test (!path.empty (), "log file created");
+    do_test (read_commits (path) == expected,
+             "synced log has every commit in order");
+
+    xaccCloseLog ();
+    do_test (read_commits (path) == expected, "closing the log keeps it");
+    xaccLogSetFlushPolicy (500, 100);
+
+    qof_session_end (session);
+    qof_session_destroy (session);
+}
+
+int
+main (int argc, char **argv)
+{
+    qof_init ();
+    if (!cashobjects_register ())
+        exit (1);
+
+    auto dir = g_dir_make_tmp ("test-translog-XXXXXX", NULL);
+    if (!dir)
+        exit (1);
+    auto base = g_build_filename (dir, "translog", NULL);
+    xaccLogSetBaseName (base);
+
+    test_log_sync (dir);
+    print_test_results ();
+
+    auto gdir = g_dir_open (dir, 0, NULL);
+    const char *name;
+    while (gdir && (name = g_dir_read_name (gdir)))
+    {
+        auto path = g_build_filename (dir, name, NULL);
+        g_remove (path);
+        g_free (path);
+    }
+    if (gdir)
+        g_dir_close (gdir);
+    g_rmdir (dir);
+    g_free (base);
+    g_free (dir);
+
+    qof_close ();
+    return get_rv ();
+}
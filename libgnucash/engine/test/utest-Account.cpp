@@ -1869,6 +1869,90 @@ test_gnc_account_get_full_name (Fixture *fixture, gconstpointer pData)
     g_free (result);
 
 }
+/* gnc_account_peek_full_name
+const gchar *
+gnc_account_peek_full_name (const Account *account)*/
+static void
+test_gnc_account_peek_full_name (Fixture *fixture, gconstpointer pData)
+{
+    auto root = gnc_account_get_root (fixture->acct);
+    auto parent = gnc_account_get_parent (fixture->acct);
+
+    g_assert_cmpstr (gnc_account_peek_full_name (NULL), == , "");
+    g_assert_cmpstr (gnc_account_peek_full_name (root), == , "");
+    g_assert_cmpstr (gnc_account_peek_full_name (fixture->acct), == ,
+                     "foo:baz:waldo");
+    g_assert (gnc_account_lookup_by_full_name (root, "foo:baz:waldo") ==
+              fixture->acct);
+
+    /* Renaming an ancestor changes the full name and the index. */
+    xaccAccountSetName (parent, "qux");
+    g_assert_cmpstr (gnc_account_peek_full_name (fixture->acct), == ,
+                     "foo:qux:waldo");
+    g_assert (gnc_account_lookup_by_full_name (root, "foo:baz:waldo") == NULL);
+    g_assert (gnc_account_lookup_by_full_name (root, "foo:qux:waldo") ==
+              fixture->acct);
+
+    /* So does moving the account. */
+    gnc_account_append_child (root, fixture->acct);
+    g_assert_cmpstr (gnc_account_peek_full_name (fixture->acct), == , "waldo");
+    g_assert (gnc_account_lookup_by_full_name (root, "waldo") ==
+              fixture->acct);
+    g_assert (gnc_account_lookup_by_name (parent, "waldo") == NULL);
+
+    /* And changing the separator. */
+    gnc_set_account_separator ("-");
+    g_assert_cmpstr (gnc_account_peek_full_name (parent), == , "foo-qux");
+    g_assert (gnc_account_lookup_by_full_name (root, "foo-qux") == parent);
+    gnc_set_account_separator (":");
+    g_assert_cmpstr (gnc_account_peek_full_name (parent), == , "foo:qux");
+}
+/* The lookup index is updated in place as accounts come and go.
+static const AccountTreeIndex*
+account_tree_index (const Account *acc)*/
+static void
+test_gnc_account_lookup_index (Fixture *fixture, gconstpointer pData)
+{
+    auto root = gnc_account_get_root (fixture->acct);
+    auto book = gnc_account_get_book (root);
+
+    /* Build the index first, then add to it, as the importers do. */
+    g_assert (gnc_account_lookup_by_full_name (root, "new") == NULL);
+    auto acc = xaccMallocAccount (book);
+    xaccAccountSetName (acc, "new");
+    gnc_account_append_child (root, acc);
+    g_assert (gnc_account_lookup_by_full_name (root, "new") == acc);
+    auto child = xaccMallocAccount (book);
+    xaccAccountSetName (child, "kid");
+    xaccAccountSetCode (child, "K1");
+    gnc_account_append_child (acc, child);
+    g_assert (gnc_account_lookup_by_full_name (root, "new:kid") == child);
+    g_assert (gnc_account_lookup_by_code (root, "K1") == child);
+    xaccAccountSetCode (child, "K2");
+    g_assert (gnc_account_lookup_by_code (root, "K1") == NULL);
+    g_assert (gnc_account_lookup_by_code (root, "K2") == child);
+
+    /* Of two accounts with the same full name the first one wins. */
+    auto twin = xaccMallocAccount (book);
+    xaccAccountSetName (twin, "new");
+    gnc_account_append_child (root, twin);
+    g_assert (gnc_account_lookup_by_full_name (root, "new") == acc);
+    gnc_account_remove_child (root, twin);
+    g_assert (gnc_account_lookup_by_full_name (root, "new") == acc);
+    g_assert (gnc_account_lookup_by_name (root, "new") == acc);
+
+    /* A childless first sibling doesn't hide the second one's children,
+     * which the tree walk used to do. */
+    gnc_account_append_child (root, twin);
+    gnc_account_append_child (twin, child);
+    g_assert (gnc_account_lookup_by_full_name (root, "new:kid") == child);
+
+    gnc_account_remove_child (twin, child);
+    g_assert (gnc_account_lookup_by_full_name (root, "new:kid") == NULL);
+    g_assert (gnc_account_lookup_by_code (root, "K2") == NULL);
+    xaccAccountBeginEdit (child);
+    xaccAccountDestroy (child);
+}
 
 /* DxaccAccountGetCurrency
 gnc_commodity *
@@ -2062,6 +2146,164 @@ test_xaccAccountForEachLot (Fixture *fixture, gconstpointer pData)
     xaccAccountForEachLot (acct, bogus_for_each_lot_func, &count_calls);
     g_assert_cmpint (count_calls, == , 5);
 }
+
+/* xaccAccountForEachOpenLot
+gpointer
+xaccAccountForEachOpenLot (const Account *acc,// C: 1 in 1 */
+static void
+test_xaccAccountForEachOpenLot (Fixture *fixture, gconstpointer pData)
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *acct = gnc_account_lookup_by_name (root, "baz");
+    LotList *lots, *open_lots;
+    GNCLot *lot;
+    guint count_calls = 0;
+
+    g_assert (acct);
+    lots = xaccAccountGetLotList (acct);
+    g_assert_cmpint (g_list_length (lots), == , 2);
+    lot = GNC_LOT (lots->data);
+    xaccAccountForEachOpenLot (acct, bogus_for_each_lot_func, &count_calls);
+    g_assert_cmpint (count_calls, == , 2);
+    /* A closed lot is skipped... */
+    gnc_lot_begin_edit (lot);
+    g_object_set (lot, "is-closed", TRUE, NULL);
+    gnc_lot_commit_edit (lot);
+    count_calls = 0;
+    xaccAccountForEachOpenLot (acct, bogus_for_each_lot_func, &count_calls);
+    g_assert_cmpint (count_calls, == , 1);
+    open_lots = xaccAccountFindOpenLots (acct, NULL, NULL, NULL);
+    g_assert_cmpint (g_list_length (open_lots), == , 1);
+    g_assert (open_lots->data != lot);
+    g_list_free (open_lots);
+    /* ...until it may have reopened. */
+    gnc_lot_set_closed_unknown (lot);
+    count_calls = 0;
+    xaccAccountForEachOpenLot (acct, bogus_for_each_lot_func, &count_calls);
+    g_assert_cmpint (count_calls, == , 2);
+    g_list_free (lots);
+}
+
+static gpointer
+collect_lot_func (GNCLot *lot, gpointer data)
+{
+    auto lots = static_cast<LotList**>(data);
+    *lots = g_list_append (*lots, lot);
+    return NULL;
+}
+
+static gint
+equal_lots_func (gconstpointer a, gconstpointer b)
+{
+    return 0;
+}
+
+/* The open lots are visited in the order of the account's lot list, and
+ * xaccAccountFindOpenLots returns lots that sort equal in the reverse of
+ * that order, as inserting them one by one with g_list_insert_sorted did;
+ * a lot that closes and reopens must not change either. */
+static void
+test_xaccAccountOpenLotsOrder (Fixture *fixture, gconstpointer pData)
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *acct = gnc_account_lookup_by_name (root, "baz");
+    LotList *lots, *visited = NULL, *found;
+    GNCLot *lot;
+
+    g_assert (acct);
+    lots = xaccAccountGetLotList (acct);
+    g_assert_cmpint (g_list_length (lots), == , 2);
+    lot = GNC_LOT (g_list_last (lots)->data);
+    gnc_lot_begin_edit (lot);
+    g_object_set (lot, "is-closed", TRUE, NULL);
+    gnc_lot_commit_edit (lot);
+    gnc_lot_set_closed_unknown (lot);
+
+    xaccAccountForEachOpenLot (acct, collect_lot_func, &visited);
+    g_assert_cmpint (g_list_length (visited), == , 2);
+    g_assert (visited->data == lots->data);
+    g_assert (visited->next->data == lots->next->data);
+    found = xaccAccountFindOpenLots (acct, NULL, NULL, equal_lots_func);
+    g_assert_cmpint (g_list_length (found), == , 2);
+    g_assert (found->data == lots->next->data);
+    g_assert (found->next->data == lots->data);
+    g_list_free (found);
+    g_list_free (visited);
+    g_list_free (lots);
+}
+
+static Split*
+lot_balance_split (Transaction *txn, Account *acct, gint64 amount)
+{
+    auto split = xaccMallocSplit (gnc_account_get_book (acct));
+    auto amt = gnc_numeric_create (amount, 1);
+    xaccSplitSetParent (split, txn);
+    xaccSplitSetAccount (split, acct);
+    xaccSplitSetAmount (split, amt);
+    xaccSplitSetValue (split, amt);
+    return split;
+}
+
+/* gnc_lot_get_balance keeps the sum of the lot's splits; check that the
+ * cached sum follows every way a split can change under it. */
+static void
+test_gnc_lot_balance_cache (Fixture *fixture, gconstpointer pData)
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *acct = gnc_account_lookup_by_name (root, "baz");
+    Account *money = gnc_account_lookup_by_name (root, "money");
+    QofBook *book = gnc_account_get_book (acct);
+    GNCLot *lot = gnc_lot_new (book);
+    Transaction *txn = xaccMallocTransaction (book);
+    Split *split1, *split2;
+
+    xaccTransBeginEdit (txn);
+    split1 = lot_balance_split (txn, acct, 100);
+    lot_balance_split (txn, money, -100);
+    split2 = lot_balance_split (txn, acct, -40);
+    lot_balance_split (txn, money, 40);
+    /* xaccTransCommitEdit () does a bunch of scrubbing that we don't need */
+    qof_commit_edit (QOF_INSTANCE (txn));
+
+    gnc_lot_add_split (lot, split1);
+    g_assert (gnc_numeric_equal (gnc_lot_get_balance (lot),
+                                 gnc_numeric_create (100, 1)));
+    g_assert (!gnc_lot_is_closed (lot));
+    /* Adding and removing a split. */
+    gnc_lot_add_split (lot, split2);
+    g_assert (gnc_numeric_equal (gnc_lot_get_balance (lot),
+                                 gnc_numeric_create (60, 1)));
+    gnc_lot_remove_split (lot, split2);
+    g_assert (gnc_numeric_equal (gnc_lot_get_balance (lot),
+                                 gnc_numeric_create (100, 1)));
+    /* Changing the amount of a split in the lot. */
+    xaccTransBeginEdit (txn);
+    xaccSplitSetAmount (split1, gnc_numeric_create (70, 1));
+    qof_commit_edit (QOF_INSTANCE (txn));
+    g_assert (gnc_numeric_equal (gnc_lot_get_balance (lot),
+                                 gnc_numeric_create (70, 1)));
+    /* Setting the amount through the QOF parameter, as the SQL backend
+     * does. */
+    auto set_amount = reinterpret_cast<void(*)(Split*, gnc_numeric)>
+        (qof_class_get_parameter_setter (GNC_ID_SPLIT, SPLIT_AMOUNT));
+    g_assert (set_amount != NULL);
+    set_amount (split1, gnc_numeric_create (40, 1));
+    g_assert (gnc_numeric_equal (gnc_lot_get_balance (lot),
+                                 gnc_numeric_create (40, 1)));
+    /* Bringing the balance to zero closes the lot. */
+    gnc_lot_add_split (lot, split2);
+    g_assert (gnc_numeric_zero_p (gnc_lot_get_balance (lot)));
+    g_assert (gnc_lot_is_closed (lot));
+    /* Rolling back an edit restores the old balance. */
+    xaccTransBeginEdit (txn);
+    xaccSplitSetAmount (split2, gnc_numeric_create (-10, 1));
+    g_assert (gnc_numeric_equal (gnc_lot_get_balance (lot),
+                                 gnc_numeric_create (30, 1)));
+    g_assert (!gnc_lot_is_closed (lot));
+    xaccTransRollbackEdit (txn);
+    g_assert (gnc_numeric_zero_p (gnc_lot_get_balance (lot)));
+    g_assert (gnc_lot_is_closed (lot));
+}
 /* These getters and setters look in KVP, so I guess their delegators instead:
  * xaccAccountGetTaxRelated
  * xaccAccountSetTaxRelated
@@ -2576,11 +2818,16 @@ test_suite_account (void)
     GNC_TEST_ADD (suitename, "gnc account foreach descendant", Fixture, &complex, setup, test_gnc_account_foreach_descendant,  teardown );
     GNC_TEST_ADD (suitename, "gnc account foreach descendant until", Fixture, &complex, setup, test_gnc_account_foreach_descendant_until,  teardown );
     GNC_TEST_ADD (suitename, "gnc account get full name", Fixture, &good_data, setup, test_gnc_account_get_full_name,  teardown );
+    GNC_TEST_ADD (suitename, "gnc account peek full name", Fixture, &good_data, setup, test_gnc_account_peek_full_name,  teardown );
+    GNC_TEST_ADD (suitename, "gnc account lookup index", Fixture, &good_data, setup, test_gnc_account_lookup_index,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetProjectedMinimumBalance", Fixture, &some_data, setup, test_xaccAccountGetProjectedMinimumBalance,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetBalanceAsOfDate", Fixture, &some_data, setup, test_xaccAccountGetBalanceAsOfDate,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetPresentBalance", Fixture, &some_data, setup, test_xaccAccountGetPresentBalance,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountFindOpenLots", Fixture, &complex_data, setup, test_xaccAccountFindOpenLots,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountForEachLot", Fixture, &complex_data, setup, test_xaccAccountForEachLot,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountForEachOpenLot", Fixture, &complex_data, setup, test_xaccAccountForEachOpenLot,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccount open lots order", Fixture, &complex_data, setup, test_xaccAccountOpenLotsOrder,  teardown );
+    GNC_TEST_ADD (suitename, "gnc lot balance cache", Fixture, &complex_data, setup, test_gnc_lot_balance_cache,  teardown );
 
     GNC_TEST_ADD (suitename, "xaccAccountHasAncestor", Fixture, &complex, setup, test_xaccAccountHasAncestor,  teardown );
     GNC_TEST_ADD_FUNC (suitename, "AccountType Stuff", test_xaccAccountType_Stuff );
@@ -25,6 +25,9 @@
 #include <qof.h>
 #include <unittest-support.h>
 #include "../gncInvoice.h"
+#include "../gncIDSearch.h"
+#include "../Split.h"
+#include "../Transaction.h"
 
 static const gchar *suitename = "/engine/gncInvoice";
 void test_suite_gncInvoice ( void );
@@ -202,6 +205,151 @@ test_invoice_posted_trans ( Fixture *fixture, gconstpointer pData )
     }
 }
 
+static void
+test_owner_open_lots ( Fixture *fixture, gconstpointer pData )
+{
+    const InvoiceData *data = (InvoiceData*) pData;
+    time64 ts = gnc_time(NULL);
+    GncEntry *entry = NULL;
+    GNCLot *lot;
+    GList *lots;
+
+    xaccAccountSetType(fixture->account2, data->is_cust_doc ?
+                       ACCT_TYPE_RECEIVABLE : ACCT_TYPE_PAYABLE);
+    if (data->is_cust_doc)
+        gncCustomerSetCurrency(fixture->customer, fixture->commodity);
+    else
+        gncVendorSetCurrency(fixture->vendor, fixture->commodity);
+    gncInvoiceSetCurrency(fixture->invoice, fixture->commodity);
+    gncInvoiceSetOwner(fixture->invoice, &fixture->owner);
+
+    entry = gncEntryCreate(fixture->book);
+    gncEntrySetDate (entry, ts);
+    gncEntrySetDateEntered (entry, ts);
+    gncEntrySetDocQuantity (entry, data->quantity, data->is_cn);
+    if (data->is_cust_doc)
+    {
+        gncEntrySetInvAccount(entry, fixture->account);
+        gncEntrySetInvPrice(entry, data->price);
+        gncInvoiceAddEntry (fixture->invoice, entry);
+    }
+    else
+    {
+        gncEntrySetBillAccount(entry, fixture->account);
+        gncEntrySetBillPrice(entry, data->price);
+        gncBillAddEntry(fixture->invoice, entry);
+    }
+
+    /* This builds the owner's open lot index while nothing is posted,
+     * so the lot created by posting must reach it through events. */
+    g_assert (gnc_numeric_zero_p (gncOwnerGetBalanceInCurrency (&fixture->owner, NULL)));
+    g_assert (gncOwnerGetOpenLots (&fixture->owner, NULL) == NULL);
+
+    gncInvoicePostToAccount(fixture->invoice, fixture->account2, ts, ts, "memo", TRUE, FALSE);
+    lot = gncInvoiceGetPostedLot(fixture->invoice);
+    lots = gncOwnerGetOpenLots (&fixture->owner, fixture->account2);
+    g_assert_cmpint (g_list_length (lots), ==, 1);
+    g_assert (lots->data == lot);
+    g_list_free (lots);
+    g_assert (gncOwnerGetOpenLots (&fixture->owner, fixture->account) == NULL);
+    g_assert (!gnc_numeric_zero_p (gnc_lot_get_balance (lot)));
+    g_assert (gnc_numeric_equal (gncOwnerGetBalanceInCurrency (&fixture->owner, NULL),
+                                 gnc_lot_get_balance (lot)));
+
+    gncInvoiceUnpost(fixture->invoice, TRUE);
+    g_assert (gncOwnerGetOpenLots (&fixture->owner, NULL) == NULL);
+    g_assert (gnc_numeric_zero_p (gncOwnerGetBalanceInCurrency (&fixture->owner, NULL)));
+    gncInvoiceRemoveEntries (fixture->invoice);
+}
+
+static void
+test_owner_open_lots_relinked ( Fixture *fixture, gconstpointer pData )
+{
+    GncCustomer *other = gncCustomerCreate(fixture->book);
+    GncJob *job = gncJobCreate(fixture->book);
+    GncOwner job_owner, other_owner;
+    Transaction *trans = xaccMallocTransaction(fixture->book);
+    Split *split = xaccMallocSplit(fixture->book);
+    Split *other_split = xaccMallocSplit(fixture->book);
+    GNCLot *lot = gnc_lot_new(fixture->book);
+    gnc_numeric amount = gnc_numeric_create (1000, 100);
+    GList *lots;
+
+    gncOwnerInitJob(&job_owner, job);
+    gncOwnerInitCustomer(&other_owner, other);
+    gncJobSetOwner(job, &fixture->owner);
+    xaccAccountSetType(fixture->account2, ACCT_TYPE_RECEIVABLE);
+
+    xaccTransBeginEdit(trans);
+    xaccTransSetCurrency(trans, fixture->commodity);
+    xaccSplitSetParent(split, trans);
+    xaccSplitSetAccount(split, fixture->account2);
+    xaccSplitSetAmount(split, amount);
+    xaccSplitSetValue(split, amount);
+    xaccSplitSetParent(other_split, trans);
+    xaccSplitSetAccount(other_split, fixture->account);
+    xaccSplitSetAmount(other_split, gnc_numeric_neg (amount));
+    xaccSplitSetValue(other_split, gnc_numeric_neg (amount));
+    xaccTransCommitEdit(trans);
+    xaccAccountInsertLot(fixture->account2, lot);
+    gnc_lot_add_split(lot, split);
+
+    /* Build the index before the lot has an owner. Attaching it, as the
+     * business scrub does, has to reach the index. */
+    g_assert (gncOwnerGetOpenLots (&fixture->owner, NULL) == NULL);
+    gncOwnerAttachToLot(&job_owner, lot);
+    lots = gncOwnerGetOpenLots (&fixture->owner, NULL);
+    g_assert_cmpint (g_list_length (lots), ==, 1);
+    g_assert (lots->data == lot);
+    g_list_free (lots);
+
+    /* The job's lots go with the job to its new owner. */
+    gncJobSetOwner(job, &other_owner);
+    g_assert (gncOwnerGetOpenLots (&fixture->owner, NULL) == NULL);
+    lots = gncOwnerGetOpenLots (&other_owner, NULL);
+    g_assert_cmpint (g_list_length (lots), ==, 1);
+    g_assert (lots->data == lot);
+    g_list_free (lots);
+
+    xaccTransBeginEdit(trans);
+    xaccTransDestroy(trans);
+    xaccTransCommitEdit(trans);
+    gncJobBeginEdit(job);
+    gncJobDestroy(job);
+    gncCustomerBeginEdit(other);
+    gncCustomerDestroy(other);
+}
+
+static void
+test_search_on_id ( Fixture *fixture, gconstpointer pData )
+{
+    QofBook *book = fixture->book;
+    GncCustomer *other = gncCustomerCreate(book);
+
+    gncInvoiceSetOwner(fixture->invoice, &fixture->owner);
+    gncInvoiceSetID(fixture->invoice, "0001");
+    g_assert (gnc_search_invoice_on_id (book, "0001") == fixture->invoice);
+    g_assert (gnc_search_bill_on_id (book, "0001") == NULL);
+    g_assert (gnc_search_customer_on_id (book, "0001") == NULL);
+
+    /* The index follows ID changes and is kept per type */
+    gncInvoiceSetID(fixture->invoice, "0002");
+    g_assert (gnc_search_invoice_on_id (book, "0001") == NULL);
+    g_assert (gnc_search_invoice_on_id (book, "0002") == fixture->invoice);
+    gncCustomerSetID(fixture->customer, "0002");
+    g_assert (gnc_search_customer_on_id (book, "0002") == fixture->customer);
+    g_assert (gnc_search_invoice_on_id (book, "0002") == fixture->invoice);
+
+    /* Duplicate IDs find the oldest object, destroyed ones are gone */
+    gncCustomerSetID(other, "0002");
+    g_assert (gnc_search_customer_on_id (book, "0002") == fixture->customer);
+    gncCustomerSetID(fixture->customer, "0003");
+    g_assert (gnc_search_customer_on_id (book, "0002") == other);
+    gncCustomerBeginEdit(other);
+    gncCustomerDestroy(other);
+    g_assert (gnc_search_customer_on_id (book, "0002") == NULL);
+}
+
 void
 test_suite_gncInvoice ( void )
 {
@@ -215,4 +363,7 @@ test_suite_gncInvoice ( void )
     GNC_TEST_ADD( suitename, "post trans - customer creditnote", Fixture, &pData, setup_with_invoice, test_invoice_posted_trans, teardown_with_invoice );
     pData.is_cn = FALSE;   // Customer invoice
     GNC_TEST_ADD( suitename, "post trans - customer invoice", Fixture, &pData, setup_with_invoice, test_invoice_posted_trans, teardown_with_invoice );
+    GNC_TEST_ADD( suitename, "owner open lots - customer invoice", Fixture, &pData, setup, test_owner_open_lots, teardown );
+    GNC_TEST_ADD( suitename, "owner open lots - relinked", Fixture, &pData, setup, test_owner_open_lots_relinked, teardown );
+    GNC_TEST_ADD( suitename, "search on id", Fixture, &pData, setup, test_search_on_id, teardown );
 }